@@ -37,6 +37,8 @@ class EngineCommand extends Command<dynamic> {
     addSubcommand(_BuildEngineCommand());
     addSubcommand(_CleanEngineCommand());
     addSubcommand(_EngineUnitTestCommand());
+    addSubcommand(_EngineBenchmarkCommand());
+    addSubcommand(_EngineRenderRegressionCommand());
   }
 }
 
@@ -276,6 +278,128 @@ class _EngineUnitTestCommand extends Command<dynamic> {
   }
 }
 
+class _EngineBenchmarkCommand extends Command<dynamic> {
+  @override
+  String get name => 'benchmark';
+
+  @override
+  String get description =>
+      'Runs performance benchmarks for the Anthem engine in a release build.';
+
+  _EngineBenchmarkCommand() {
+    argParser.addOption(
+      'filter',
+      help: 'Only runs the benchmark suite with this name.',
+    );
+    argParser.addOption(
+      'output',
+      help: 'Writes the JSON report to this file instead of stdout.',
+    );
+  }
+
+  @override
+  Future<void> run() async {
+    print(Colorize('Running benchmarks for the Anthem engine...')
+      ..lightGreen());
+
+    // Benchmarks are only meaningful with optimizations enabled.
+    await _buildCmakeTarget('AnthemBenchmark', debug: false);
+
+    final packageRootPath = getPackageRootPath();
+    final benchmarkExecutableLocation = packageRootPath.resolve(
+        'engine/build${Platform.isWindows ? '/Release' : ''}/AnthemBenchmark${Platform.isWindows ? '.exe' : ''}');
+
+    final filter = argResults!['filter'] as String?;
+    final output = argResults!['output'] as String?;
+
+    final benchmarkProcess = await Process.start(
+      benchmarkExecutableLocation.toFilePath(windows: Platform.isWindows),
+      [
+        if (filter != null) '--filter=$filter',
+        if (output != null) '--output=$output',
+      ],
+      mode: ProcessStartMode.normal,
+    );
+
+    benchmarkProcess.stdout.listen(stdout.add);
+    benchmarkProcess.stderr.listen(stderr.add);
+
+    final benchmarkExitCode = await benchmarkProcess.exitCode;
+
+    if (benchmarkExitCode != 0) {
+      print(Colorize('\n\nError: Benchmarks exited with code $benchmarkExitCode.')
+          .red());
+      exit(benchmarkExitCode);
+    }
+
+    print(Colorize('Benchmarks complete.').lightGreen());
+  }
+}
+
+class _EngineRenderRegressionCommand extends Command<dynamic> {
+  @override
+  String get name => 'render-regression';
+
+  @override
+  String get description =>
+      'Renders the engine regression fixtures and compares them against golden output.';
+
+  _EngineRenderRegressionCommand() {
+    argParser.addOption(
+      'fixture',
+      help: 'Only renders the fixture with this name.',
+    );
+    argParser.addOption(
+      'tolerance',
+      help:
+          'Allows each sample to differ from the golden audio by this much. By default, output must be bit-exact.',
+    );
+    argParser.addFlag(
+      'update-golden',
+      help: 'Replaces the golden output with the output of this build.',
+      negatable: false,
+    );
+  }
+
+  @override
+  Future<void> run() async {
+    print(Colorize('Running render regression tests for the Anthem engine...')
+      ..lightGreen());
+
+    await _buildCmakeTarget('AnthemRenderRegression', debug: false);
+
+    final packageRootPath = getPackageRootPath();
+    final executableLocation = packageRootPath.resolve(
+        'engine/build${Platform.isWindows ? '/Release' : ''}/AnthemRenderRegression${Platform.isWindows ? '.exe' : ''}');
+
+    final fixture = argResults!['fixture'] as String?;
+    final tolerance = argResults!['tolerance'] as String?;
+    final updateGolden = argResults!['update-golden'] as bool;
+
+    final regressionProcess = await Process.start(
+      executableLocation.toFilePath(windows: Platform.isWindows),
+      [
+        if (fixture != null) '--fixture=$fixture',
+        if (tolerance != null) '--tolerance=$tolerance',
+        if (updateGolden) '--update-golden',
+      ],
+      mode: ProcessStartMode.normal,
+    );
+
+    regressionProcess.stdout.listen(stdout.add);
+    regressionProcess.stderr.listen(stderr.add);
+
+    final regressionExitCode = await regressionProcess.exitCode;
+
+    if (regressionExitCode != 0) {
+      print(Colorize('\n\nError: Render regression tests failed.').red());
+      exit(regressionExitCode);
+    }
+
+    print(Colorize('Render regression tests complete.').lightGreen());
+  }
+}
+
 Future<void> _buildCmakeTarget(String target,
     {bool addressSanitizer = false, bool debug = false}) async {
   final packageRootPath = getPackageRootPath();
@@ -0,0 +1,221 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+// The size of the workload for a measurement, e.g. {"nodes": 500}.
+using BenchmarkParameters = std::map<std::string, int64_t>;
+
+// The result of a single measurement. All times are per iteration.
+struct BenchmarkMeasurement {
+  std::string suite;
+  std::string name;
+  BenchmarkParameters parameters;
+
+  int64_t iterations;
+
+  double meanNanoseconds;
+  double medianNanoseconds;
+  double minNanoseconds;
+  double maxNanoseconds;
+  double p99Nanoseconds;
+
+  // If the measurement processes a known number of items per iteration (e.g.
+  // notes, or samples), this is how many of those items were processed per
+  // second.
+  std::optional<double> itemsPerSecond;
+};
+
+// This is what gets written out as JSON, so results can be tracked over time.
+struct BenchmarkReport {
+  std::string timestamp;
+  std::string buildType;
+  std::vector<BenchmarkMeasurement> measurements;
+};
+
+// Base class for engine benchmarks.
+//
+// This works like juce::UnitTest: each benchmark is a subclass with a static
+// instance, and the instance registers itself on construction. The runner in
+// benchmark.cpp then runs everything that's registered.
+class AnthemBenchmark {
+private:
+  std::string suiteName;
+  std::vector<BenchmarkMeasurement>* measurements = nullptr;
+
+  static std::vector<AnthemBenchmark*>& getAllBenchmarksMutable() {
+    static std::vector<AnthemBenchmark*> benchmarks;
+    return benchmarks;
+  }
+
+  // Swallows everything written to it. The engine logs a lot, which would
+  // both bury the results and skew the timings.
+  class NullStreamBuffer : public std::streambuf {
+  protected:
+    int overflow(int c) override {
+      return c;
+    }
+  };
+
+  class NullLogger : public juce::Logger {
+  protected:
+    void logMessage(const juce::String&) override {}
+  };
+
+  // Silences std::cout and juce::Logger while it's in scope.
+  class ScopedSilence {
+  private:
+    NullStreamBuffer nullBuffer;
+    NullLogger nullLogger;
+    std::streambuf* oldBuffer;
+    juce::Logger* oldLogger;
+  public:
+    ScopedSilence() {
+      oldBuffer = std::cout.rdbuf(&nullBuffer);
+      oldLogger = juce::Logger::getCurrentLogger();
+      juce::Logger::setCurrentLogger(&nullLogger);
+    }
+
+    ~ScopedSilence() {
+      std::cout.rdbuf(oldBuffer);
+      juce::Logger::setCurrentLogger(oldLogger);
+    }
+  };
+
+public:
+  AnthemBenchmark(std::string suiteName) : suiteName(std::move(suiteName)) {
+    getAllBenchmarksMutable().push_back(this);
+  }
+
+  virtual ~AnthemBenchmark() {
+    auto& benchmarks = getAllBenchmarksMutable();
+    benchmarks.erase(std::remove(benchmarks.begin(), benchmarks.end(), this), benchmarks.end());
+  }
+
+  static const std::vector<AnthemBenchmark*>& getAllBenchmarks() {
+    return getAllBenchmarksMutable();
+  }
+
+  const std::string& getSuiteName() {
+    return suiteName;
+  }
+
+  // Runs this benchmark, adding the results to the given list.
+  void runBenchmark(std::vector<BenchmarkMeasurement>& results) {
+    measurements = &results;
+    run();
+    measurements = nullptr;
+  }
+
+protected:
+  virtual void run() = 0;
+
+  // Times body() over the given number of iterations, after a few warm-up
+  // iterations that aren't recorded.
+  //
+  // If setup is given, it's called before each iteration, outside of the
+  // timed region.
+  void measure(
+    const std::string& name,
+    const BenchmarkParameters& parameters,
+    int iterations,
+    std::optional<int64_t> itemsPerIteration,
+    const std::function<void()>& body,
+    const std::function<void()>& setup = {}
+  ) {
+    jassert(measurements != nullptr);
+    jassert(iterations > 0);
+
+    std::vector<double> samples;
+    samples.reserve(static_cast<size_t>(iterations));
+
+    {
+      ScopedSilence silence;
+
+      auto warmupIterations = std::max(1, iterations / 10);
+
+      for (int i = 0; i < warmupIterations; i++) {
+        if (setup) setup();
+        body();
+      }
+
+      for (int i = 0; i < iterations; i++) {
+        if (setup) setup();
+
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+
+        samples.push_back(static_cast<double>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+        ));
+      }
+    }
+
+    std::sort(samples.begin(), samples.end());
+
+    double total = 0.0;
+    for (auto sample : samples) {
+      total += sample;
+    }
+
+    auto mean = total / static_cast<double>(samples.size());
+
+    BenchmarkMeasurement measurement {
+      .suite = suiteName,
+      .name = name,
+      .parameters = parameters,
+      .iterations = iterations,
+      .meanNanoseconds = mean,
+      .medianNanoseconds = samples[samples.size() / 2],
+      .minNanoseconds = samples.front(),
+      .maxNanoseconds = samples.back(),
+      .p99Nanoseconds = samples[std::min(samples.size() - 1, (samples.size() * 99) / 100)],
+      .itemsPerSecond = itemsPerIteration.has_value() && mean > 0.0
+        ? std::optional(static_cast<double>(itemsPerIteration.value()) * 1e9 / mean)
+        : std::nullopt,
+    };
+
+    std::string parametersStr;
+    for (auto& [key, value] : parameters) {
+      parametersStr += " " + key + "=" + std::to_string(value);
+    }
+
+    juce::Logger::writeToLog(
+      suiteName + " / " + name + parametersStr + ": " +
+      juce::String(mean / 1000.0, 2) + " us mean, " +
+      juce::String(measurement.p99Nanoseconds / 1000.0, 2) + " us p99"
+    );
+
+    measurements->push_back(std::move(measurement));
+  }
+};
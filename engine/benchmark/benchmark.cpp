@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Runs performance benchmarks for the engine's hot paths, and writes the
+// results as JSON so they can be compared between builds.
+//
+// Usage: AnthemBenchmark [--filter=<suite>] [--output=<file>]
+//
+// If --output is not given, the JSON report is the only thing written to
+// stdout, so it can be piped straight into another program. Everything else,
+// including the human-readable summary, goes to stderr.
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include <iostream>
+
+#include <rfl.hpp>
+#include <rfl/json.hpp>
+
+#include "console_logger.h"
+
+#include "modules/core/anthem.h"
+
+#include "benchmark/anthem_benchmark.h"
+#include "benchmark/modules/processing_graph/graph_compiler_benchmark.h"
+#include "benchmark/modules/processing_graph/graph_processor_benchmark.h"
+#include "benchmark/modules/processors/oscillator_benchmark.h"
+#include "benchmark/modules/sequencer/sequencer_benchmark.h"
+#include "benchmark/modules/util/arena_allocator_benchmark.h"
+#include "benchmark/modules/util/denormal_benchmark.h"
+#include "benchmark/modules/util/ring_buffer_benchmark.h"
+
+int main(int argc, char** argv) {
+  juce::Logger::setCurrentLogger(new ConsoleLogger());
+
+  juce::ArgumentList arguments(argc, argv);
+
+  auto filter = arguments.getValueForOption("--filter");
+  auto outputPath = arguments.getValueForOption("--output");
+
+  // The engine writes to std::cout directly in places, as well as through
+  // the logger, so we point std::cout itself at stderr until the report is
+  // written.
+  std::streambuf* stdoutBuffer = nullptr;
+
+  if (outputPath.isEmpty()) {
+    stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+  }
+
+  // Some of the code under test checks that it's being called from the
+  // message thread, so we make this thread the message thread. We don't run
+  // the message loop, so timers never fire; benchmarks that rely on them
+  // clean up manually instead.
+  juce::MessageManager::getInstance();
+
+  Anthem::getInstance().initialize();
+
+  BenchmarkReport report {
+    .timestamp = juce::Time::getCurrentTime().toISO8601(true).toStdString(),
+    #ifdef NDEBUG
+    .buildType = "release",
+    #else
+    .buildType = "debug",
+    #endif
+    .measurements = {},
+  };
+
+  #ifndef NDEBUG
+  juce::Logger::writeToLog("Warning: this is a debug build. Timings will not be representative.");
+  #endif
+
+  for (auto* benchmark : AnthemBenchmark::getAllBenchmarks()) {
+    if (filter.isNotEmpty() && benchmark->getSuiteName() != filter.toStdString()) {
+      continue;
+    }
+
+    juce::Logger::writeToLog("\nRunning " + benchmark->getSuiteName() + "...");
+
+    try {
+      benchmark->runBenchmark(report.measurements);
+    } catch (std::exception& e) {
+      std::cerr << benchmark->getSuiteName() << " failed: " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  auto json = rfl::json::write(report, rfl::json::pretty);
+
+  if (outputPath.isNotEmpty()) {
+    juce::File outputFile(juce::File::getCurrentWorkingDirectory().getChildFile(outputPath));
+
+    if (!outputFile.replaceWithText(json)) {
+      std::cerr << "Could not write results to " << outputFile.getFullPathName() << std::endl;
+      return 1;
+    }
+
+    juce::Logger::writeToLog("\nWrote results to " + outputFile.getFullPathName());
+  }
+
+  Anthem::getInstance().shutdown();
+  Anthem::cleanup();
+
+  if (stdoutBuffer != nullptr) {
+    std::cout.rdbuf(stdoutBuffer);
+    std::cout << json << std::endl;
+  }
+
+  return 0;
+}
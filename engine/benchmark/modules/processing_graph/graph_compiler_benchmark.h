@@ -0,0 +1,59 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "benchmark/anthem_benchmark.h"
+#include "benchmark/synthetic_project.h"
+
+#include "modules/core/anthem.h"
+#include "modules/processing_graph/compiler/anthem_graph_compiler.h"
+#include "modules/processing_graph/compiler/anthem_graph_topology_snapshot.h"
+
+class GraphCompilerBenchmark : public AnthemBenchmark {
+public:
+  GraphCompilerBenchmark() : AnthemBenchmark("GraphCompiler") {}
+
+  void run() override {
+    for (int nodeCount : { 10, 100, 500 }) {
+      SyntheticProject::load(nodeCount, 3, 0);
+
+      auto& anthem = Anthem::getInstance();
+
+      std::shared_ptr<const AnthemGraphTopologySnapshot> topology;
+
+      BenchmarkParameters parameters {
+        { "nodes", nodeCount },
+        { "connections", static_cast<int64_t>(anthem.project->processingGraph()->connections()->size()) },
+      };
+
+      measure("snapshot", parameters, 50, std::nullopt, [&]() {
+        topology = AnthemGraphTopologySnapshot::create(*anthem.project, anthem.getProcessingConfig());
+      });
+
+      measure("compile", parameters, nodeCount >= 500 ? 10 : 50, std::nullopt, [&]() {
+        auto result = AnthemGraphCompiler::compile(*topology);
+        result->cleanup();
+        delete result;
+      });
+    }
+  }
+};
+
+static GraphCompilerBenchmark graphCompilerBenchmark;
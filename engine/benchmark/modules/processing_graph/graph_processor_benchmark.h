@@ -0,0 +1,69 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "benchmark/anthem_benchmark.h"
+#include "benchmark/synthetic_project.h"
+
+#include "modules/core/anthem.h"
+#include "modules/processing_graph/compiler/anthem_graph_compiler.h"
+#include "modules/processing_graph/compiler/anthem_graph_topology_snapshot.h"
+
+class GraphProcessorBenchmark : public AnthemBenchmark {
+public:
+  GraphProcessorBenchmark() : AnthemBenchmark("GraphProcessor") {}
+
+  void run() override {
+    auto& anthem = Anthem::getInstance();
+
+    for (int nodeCount : { 10, 100, 500 }) {
+      SyntheticProject::load(nodeCount, 3, 0);
+
+      // Buffers are sized for the largest block size we measure below.
+      auto topology = AnthemGraphTopologySnapshot::create(
+        *anthem.project,
+        AnthemProcessingConfig {
+          .sampleRate = DEFAULT_SAMPLE_RATE,
+          .maxBlockSize = 512,
+        }
+      );
+      anthem.graphProcessor->setProcessingStepsFromMainThread(AnthemGraphCompiler::compile(*topology));
+
+      for (int blockSize : { 64, 512 }) {
+        BenchmarkParameters parameters {
+          { "nodes", nodeCount },
+          { "connections", static_cast<int64_t>(topology->connections.size()) },
+          { "blockSize", blockSize },
+        };
+
+        // This reports samples per second, which can be compared against the
+        // sample rate to see how much headroom there is.
+        measure("process", parameters, 1000, blockSize, [&]() {
+          anthem.graphProcessor->process(blockSize);
+        });
+      }
+
+      // The previous result was handed back when the new one was picked up.
+      anthem.graphProcessor->clearDeletionQueueFromMainThread();
+    }
+  }
+};
+
+static GraphProcessorBenchmark graphProcessorBenchmark;
@@ -0,0 +1,84 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "benchmark/anthem_benchmark.h"
+
+#include "modules/processors/oscillator.h"
+
+// Compares the wavetable oscillator against computing each sample with
+// std::sin and std::fmod, which is what the tone generator used to do.
+class OscillatorBenchmark : public AnthemBenchmark {
+private:
+  static constexpr int blockSize = 512;
+  static constexpr double sampleRate = 48000.0;
+
+public:
+  OscillatorBenchmark() : AnthemBenchmark("Oscillator") {}
+
+  void run() override {
+    BenchmarkParameters parameters {
+      { "blockSize", blockSize },
+    };
+
+    std::vector<float> output(blockSize);
+
+    double sinePhase = 0.0;
+
+    measure("stdSin", parameters, 2000, blockSize, [&]() {
+      for (int i = 0; i < blockSize; i++) {
+        output[static_cast<size_t>(i)] = static_cast<float>(std::sin(2.0 * juce::MathConstants<double>::pi * sinePhase));
+        sinePhase = std::fmod(sinePhase + 440.0 / sampleRate, 1.0);
+      }
+    });
+
+    auto sine = AnthemWavetable::createSine();
+    auto saw = AnthemWavetable::createSaw();
+    auto increment = AnthemOscillator::getPhaseIncrement(440.0, sampleRate);
+    uint32_t phase = 0;
+
+    measure("wavetableSine", parameters, 2000, blockSize, [&]() {
+      sine.render(phase, increment, output.data(), blockSize);
+    });
+
+    measure("wavetableSaw", parameters, 2000, blockSize, [&]() {
+      saw.render(phase, increment, output.data(), blockSize);
+    });
+
+    // A frequency that changes every sample, e.g. from an LFO, so each
+    // sample needs its own increment.
+    std::vector<float> frequencies(blockSize);
+    std::vector<uint32_t> increments(blockSize);
+
+    for (int i = 0; i < blockSize; i++) {
+      frequencies[static_cast<size_t>(i)] = 440.0f + 10.0f * static_cast<float>(i) / blockSize;
+    }
+
+    measure("wavetableSawModulated", parameters, 2000, blockSize, [&]() {
+      AnthemOscillator::getPhaseIncrements(frequencies.data(), sampleRate, increments.data(), blockSize);
+      saw.render(phase, increments.data(), output.data(), blockSize);
+    });
+  }
+};
+
+static OscillatorBenchmark oscillatorBenchmark;
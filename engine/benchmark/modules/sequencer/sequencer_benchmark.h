@@ -0,0 +1,150 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "benchmark/anthem_benchmark.h"
+#include "benchmark/synthetic_project.h"
+
+#include "modules/sequencer/compiler/sequence_compiler.h"
+#include "modules/sequencer/runtime/automation_evaluator.h"
+#include "modules/sequencer/runtime/runtime_sequence_store.h"
+
+class SequenceCompilerBenchmark : public AnthemBenchmark {
+public:
+  SequenceCompilerBenchmark() : AnthemBenchmark("SequenceCompiler") {}
+
+  void run() override {
+    for (int noteCount : { 100, 1000, 10000 }) {
+      auto projectJson = SyntheticProject::createProjectJson(0, 0, noteCount);
+
+      BenchmarkParameters parameters {
+        { "notes", noteCount },
+      };
+
+      measure("compilePatternsFromJson", parameters, noteCount >= 10000 ? 20 : 100, noteCount, [&]() {
+        auto compiled = AnthemSequenceCompiler::compilePatternsFromJson(projectJson);
+
+        for (auto& [id, collection] : compiled) {
+          SequenceEventListCollection::cleanUpInstance(collection);
+        }
+      });
+    }
+  }
+};
+
+static SequenceCompilerBenchmark sequenceCompilerBenchmark;
+
+class RuntimeSequenceStoreBenchmark : public AnthemBenchmark {
+public:
+  RuntimeSequenceStoreBenchmark() : AnthemBenchmark("RuntimeSequenceStore") {}
+
+  void run() override {
+    for (int noteCount : { 100, 1000, 10000 }) {
+      auto projectJson = SyntheticProject::createProjectJson(0, 0, noteCount);
+
+      // The store's queues hold 1024 entries, and we have no message loop to
+      // drain them, so we stay well under that.
+      const int iterations = 200;
+
+      auto store = std::make_unique<AnthemRuntimeSequenceStore>();
+
+      std::unordered_map<std::string, SequenceEventListCollection> compiled;
+
+      BenchmarkParameters parameters {
+        { "notes", noteCount },
+      };
+
+      // Measures the time from the main thread publishing a sequence to the
+      // audio thread picking it up.
+      measure(
+        "addOrUpdateSequences",
+        parameters,
+        iterations,
+        std::nullopt,
+        [&]() {
+          store->addOrUpdateSequences(std::move(compiled));
+          store->rt_getEventLists();
+        },
+        [&]() {
+          compiled = AnthemSequenceCompiler::compilePatternsFromJson(projectJson);
+        }
+      );
+
+      // The destructor cleans up everything that was replaced.
+      store.reset();
+    }
+  }
+};
+
+static RuntimeSequenceStoreBenchmark runtimeSequenceStoreBenchmark;
+
+class AutomationEvaluatorBenchmark : public AnthemBenchmark {
+public:
+  AutomationEvaluatorBenchmark() : AnthemBenchmark("AutomationEvaluator") {}
+
+  void run() override {
+    constexpr int blockSize = 256;
+    constexpr int blocks = 1024;
+
+    // 96 ticks per quarter at 120 BPM and 48 kHz
+    constexpr double ticksPerSample = 96.0 * 2.0 / 48000.0;
+
+    std::pair<const char*, AnthemAutomationCurve> curves[] = {
+      { "linear", AnthemAutomationCurve::Smooth },
+      { "smooth", AnthemAutomationCurve::Smooth },
+      { "stairs", AnthemAutomationCurve::Stairs },
+      { "wave", AnthemAutomationCurve::Wave },
+    };
+
+    // Dense automation has a point every few ticks, so most blocks cross a
+    // few segments.
+    for (int ticksBetweenPoints : { 4, 96 }) {
+      for (auto& [name, curve] : curves) {
+        float tension = std::string(name) == "linear" ? 0.0f : 0.5f;
+
+        AnthemAutomationSegmentList lane;
+        double time = 0.0;
+        float value = 0.0f;
+
+        while (time < blocks * blockSize * ticksPerSample) {
+          float nextValue = 1.0f - value;
+          lane.push_back(AnthemAutomationSegment::create(time, time + ticksBetweenPoints, value, nextValue, tension, curve));
+          time += ticksBetweenPoints;
+          value = nextValue;
+        }
+
+        AnthemControlBuffer buffer(blockSize);
+
+        BenchmarkParameters parameters {
+          { "ticksBetweenPoints", ticksBetweenPoints },
+          { "blockSize", blockSize },
+        };
+
+        measure(std::string("evaluate.") + name, parameters, 20, blocks * blockSize, [&]() {
+          for (int block = 0; block < blocks; block++) {
+            AnthemAutomationEvaluator::evaluate(lane, block * blockSize * ticksPerSample, ticksPerSample, blockSize, buffer);
+          }
+        });
+      }
+    }
+  }
+};
+
+static AutomationEvaluatorBenchmark automationEvaluatorBenchmark;
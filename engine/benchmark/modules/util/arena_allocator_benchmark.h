@@ -0,0 +1,69 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "benchmark/anthem_benchmark.h"
+
+#include "modules/sequencer/events/event.h"
+#include "modules/util/arena_allocator.h"
+
+class ArenaAllocatorBenchmark : public AnthemBenchmark {
+public:
+  ArenaAllocatorBenchmark() : AnthemBenchmark("ArenaAllocator") {}
+
+  void run() override {
+    for (int allocationCount : { 16, 256, 1024 }) {
+      // Sized the same way the graph compiler sizes the event allocator.
+      ArenaBufferAllocator<AnthemLiveEvent> allocator(
+        static_cast<size_t>(allocationCount) * 64 * sizeof(AnthemLiveEvent) * 2
+      );
+
+      std::vector<void*> allocations;
+      allocations.reserve(static_cast<size_t>(allocationCount));
+
+      BenchmarkParameters parameters {
+        { "allocations", allocationCount },
+        { "eventsPerAllocation", 64 },
+      };
+
+      measure("allocateAndFree", parameters, 200, allocationCount, [&]() {
+        for (int i = 0; i < allocationCount; i++) {
+          allocations.push_back(allocator.allocate(64).deallocatePtr);
+        }
+
+        // Free every other allocation first to fragment the arena, which is
+        // closer to what happens when event buffers grow at different rates.
+        for (size_t i = 0; i < allocations.size(); i += 2) {
+          allocator.deallocate(allocations[i]);
+        }
+
+        for (size_t i = 1; i < allocations.size(); i += 2) {
+          allocator.deallocate(allocations[i]);
+        }
+
+        allocations.clear();
+      });
+    }
+  }
+};
+
+static ArenaAllocatorBenchmark arenaAllocatorBenchmark;
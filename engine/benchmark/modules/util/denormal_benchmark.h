@@ -0,0 +1,85 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include "benchmark/anthem_benchmark.h"
+
+// Shows what the denormal policy in modules/util/denormals.h buys us.
+//
+// This runs a bank of one-pole decays, like the tails of envelopes or
+// filters, that have already decayed into the denormal range. Without
+// protection, every multiply hits the slow path. With it, the state is
+// flushed to zero and the work runs at full speed.
+class DenormalBenchmark : public AnthemBenchmark {
+private:
+  static constexpr int numVoices = 64;
+  static constexpr int blockSize = 512;
+
+  std::vector<float> state = std::vector<float>(numVoices);
+
+  void resetState() {
+    for (auto& value : state) {
+      value = 1.0e-39f;
+    }
+  }
+
+  void processBlock() {
+    for (int sample = 0; sample < blockSize; sample++) {
+      for (auto& value : state) {
+        value *= 0.999f;
+      }
+    }
+  }
+
+public:
+  DenormalBenchmark() : AnthemBenchmark("Denormals") {}
+
+  void run() override {
+    BenchmarkParameters unprotected {
+      { "voices", numVoices },
+      { "blockSize", blockSize },
+      { "noDenormals", 0 },
+    };
+
+    measure("decay", unprotected, 200, numVoices * blockSize, [&]() {
+      processBlock();
+    }, [&]() {
+      resetState();
+    });
+
+    BenchmarkParameters protectedParameters = unprotected;
+    protectedParameters["noDenormals"] = 1;
+
+    // The same thing the audio callback and render threads do.
+    juce::ScopedNoDenormals noDenormals;
+
+    measure("decay", protectedParameters, 200, numVoices * blockSize, [&]() {
+      processBlock();
+    }, [&]() {
+      resetState();
+    });
+  }
+};
+
+static DenormalBenchmark denormalBenchmark;
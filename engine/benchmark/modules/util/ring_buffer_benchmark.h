@@ -0,0 +1,123 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "benchmark/anthem_benchmark.h"
+
+#include "modules/util/ring_buffer.h"
+
+class RingBufferBenchmark : public AnthemBenchmark {
+private:
+  static constexpr int itemsPerIteration = 65536;
+  static constexpr size_t capacity = 1024;
+  static constexpr size_t batchSize = 64;
+
+  // Pushes and pops on one thread, a batch at a time. This measures the cost
+  // of the operations themselves, without any contention.
+  void measureSingleThread(const std::string& name) {
+    SpscRingBuffer<uint64_t> buffer(capacity);
+
+    BenchmarkParameters parameters {
+      { "capacity", static_cast<int64_t>(capacity) },
+      { "batchSize", static_cast<int64_t>(batchSize) },
+    };
+
+    measure(name + "SingleThread", parameters, 100, itemsPerIteration, [&]() {
+      for (int i = 0; i < itemsPerIteration; i += static_cast<int>(batchSize)) {
+        for (size_t j = 0; j < batchSize; j++) {
+          [[maybe_unused]] auto added = buffer.tryPush(static_cast<uint64_t>(i) + j);
+        }
+
+        for (size_t j = 0; j < batchSize; j++) {
+          [[maybe_unused]] auto item = buffer.tryPop();
+        }
+      }
+    });
+  }
+
+  // Sends items from a producer thread to this thread as fast as possible.
+  template <typename PushFunction>
+  void measureAcrossThreads(const std::string& name, PushFunction push) {
+    SpscRingBuffer<uint64_t> buffer(capacity);
+
+    BenchmarkParameters parameters {
+      { "capacity", static_cast<int64_t>(capacity) },
+    };
+
+    measure(name, parameters, 20, itemsPerIteration, [&]() {
+      std::thread producer([&]() {
+        push(buffer, itemsPerIteration);
+      });
+
+      std::vector<uint64_t> items(batchSize);
+      int received = 0;
+
+      while (received < itemsPerIteration) {
+        auto count = buffer.popBulk(items.data(), batchSize);
+
+        if (count == 0) {
+          std::this_thread::yield();
+        }
+
+        received += static_cast<int>(count);
+      }
+
+      producer.join();
+    });
+  }
+
+public:
+  RingBufferBenchmark() : AnthemBenchmark("RingBuffer") {}
+
+  void run() override {
+    measureSingleThread("spsc");
+
+    measureAcrossThreads("spscAcrossThreads", [](auto& buffer, int count) {
+      for (int i = 0; i < count;) {
+        if (buffer.tryPush(static_cast<uint64_t>(i))) {
+          i++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+
+    measureAcrossThreads("spscBulkAcrossThreads", [](auto& buffer, int count) {
+      std::vector<uint64_t> items(batchSize);
+
+      for (int i = 0; i < count;) {
+        auto toPush = std::min(batchSize, static_cast<size_t>(count - i));
+        auto pushed = buffer.pushBulk(items.data(), toPush);
+
+        if (pushed == 0) {
+          std::this_thread::yield();
+        }
+
+        i += static_cast<int>(pushed);
+      }
+    });
+  }
+};
+
+static RingBufferBenchmark ringBufferBenchmark;
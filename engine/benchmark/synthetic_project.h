@@ -0,0 +1,226 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <rfl.hpp>
+#include <rfl/json.hpp>
+
+#include "modules/core/anthem.h"
+#include "modules/core/project.h"
+
+// Builds synthetic projects for benchmarking.
+//
+// The processing graph is a chain of gain nodes feeding into the master
+// output. Each gain node is connected to the next connectionsPerNode nodes
+// after it (or to the master output, past the end of the chain), so the graph
+// has roughly nodeCount * connectionsPerNode connections and a realistic
+// amount of fan-in.
+//
+// The sequence has a single pattern with noteCount notes on one channel.
+class SyntheticProject {
+private:
+  struct Connection {
+    std::string id;
+    std::string sourceNodeId;
+    int sourcePortId;
+    std::string destinationNodeId;
+    int destinationPortId;
+  };
+
+  static std::string getGainNodeId(int index) {
+    return "gain-" + std::to_string(index);
+  }
+
+  static void writeConnectionIds(std::ostringstream& json, const std::vector<std::string>& ids) {
+    json << "[";
+    for (size_t i = 0; i < ids.size(); i++) {
+      json << (i > 0 ? ", " : "") << "\"" << ids[i] << "\"";
+    }
+    json << "]";
+  }
+
+  static std::vector<std::string> getConnectionIds(
+    const std::vector<Connection>& connections,
+    const std::string& nodeId,
+    int portId,
+    bool isInput
+  ) {
+    std::vector<std::string> ids;
+
+    for (auto& connection : connections) {
+      auto& connectionNodeId = isInput ? connection.destinationNodeId : connection.sourceNodeId;
+      auto connectionPortId = isInput ? connection.destinationPortId : connection.sourcePortId;
+
+      if (connectionNodeId == nodeId && connectionPortId == portId) {
+        ids.push_back(connection.id);
+      }
+    }
+
+    return ids;
+  }
+
+  static void writeAudioPort(
+    std::ostringstream& json,
+    const std::vector<Connection>& connections,
+    const std::string& nodeId,
+    int portId,
+    bool isInput
+  ) {
+    json << R"({"id": )" << portId << R"(, "nodeId": ")" << nodeId
+         << R"(", "config": {"dataType": "audio"}, "connections": )";
+    writeConnectionIds(json, getConnectionIds(connections, nodeId, portId, isInput));
+    json << "}";
+  }
+
+public:
+  // Port IDs, matching the Dart processor models.
+  static const int gainAudioInputPortId = 0;
+  static const int gainAudioOutputPortId = 1;
+  static const int gainPortId = 2;
+  static const int masterOutputInputPortId = 0;
+
+  static std::string createProjectJson(int nodeCount, int connectionsPerNode, int noteCount) {
+    std::vector<Connection> connections;
+
+    for (int i = 0; i < nodeCount; i++) {
+      std::set<std::string> destinations;
+
+      for (int k = 1; k <= connectionsPerNode; k++) {
+        auto destination = i + k < nodeCount ? getGainNodeId(i + k) : "master";
+
+        if (!destinations.insert(destination).second) {
+          continue;
+        }
+
+        connections.push_back(Connection {
+          .id = "connection-" + std::to_string(connections.size()),
+          .sourceNodeId = getGainNodeId(i),
+          .sourcePortId = gainAudioOutputPortId,
+          .destinationNodeId = destination,
+          .destinationPortId = destination == "master" ? masterOutputInputPortId : gainAudioInputPortId,
+        });
+      }
+    }
+
+    std::ostringstream json;
+
+    json << R"({
+  "sequence": {
+    "ticksPerQuarter": 96,
+    "beatsPerMinuteRaw": 12800,
+    "arrangements": {},
+    "arrangementOrder": [],
+    "tracks": {},
+    "trackOrder": [],
+    "defaultTimeSignature": { "numerator": 4, "denominator": 4 },
+    "patterns": {
+      "pattern": {
+        "id": "pattern",
+        "name": "Pattern",
+        "color": { "hue": 0, "lightnessMultiplier": 0.5, "saturationMultiplier": 0.5 },
+        "notes": { "channel": [)";
+
+    for (int i = 0; i < noteCount; i++) {
+      json << (i > 0 ? ", " : "")
+           << R"({"id": "note-)" << i
+           << R"(", "key": )" << (36 + i % 48)
+           << R"(, "velocity": 0.75, "length": 24, "offset": )" << (i * 7) % (noteCount * 4 + 1)
+           << R"(, "pan": 0.0})";
+    }
+
+    json << R"(] },
+        "automationLanes": {},
+        "timeSignatureChanges": []
+      }
+    },
+    "patternOrder": ["pattern"]
+  },
+  "processingGraph": {
+    "nodes": {)";
+
+    json << R"("master": {"id": "master", "audioInputPorts": [)";
+    writeAudioPort(json, connections, "master", masterOutputInputPortId, true);
+    json << R"(], "midiInputPorts": [], "controlInputPorts": [], "audioOutputPorts": [], "midiOutputPorts": [], "controlOutputPorts": [], )"
+         << R"("processor": {"MasterOutputProcessorModel": {"nodeId": "master"}}})";
+
+    for (int i = 0; i < nodeCount; i++) {
+      auto nodeId = getGainNodeId(i);
+
+      json << R"(, ")" << nodeId << R"(": {"id": ")" << nodeId << R"(", "audioInputPorts": [)";
+      writeAudioPort(json, connections, nodeId, gainAudioInputPortId, true);
+      json << R"(], "audioOutputPorts": [)";
+      writeAudioPort(json, connections, nodeId, gainAudioOutputPortId, false);
+      json << R"(], "controlInputPorts": [{"id": )" << gainPortId << R"(, "nodeId": ")" << nodeId
+           << R"(", "config": {"dataType": "control", "parameterConfig": {"id": )" << gainPortId
+           << R"(, "defaultValue": 0.125, "minimumValue": 0.0, "maximumValue": 1.0, "smoothingDurationSeconds": 0.01}}, )"
+           << R"("connections": [], "parameterValue": 0.5}], )"
+           << R"("midiInputPorts": [], "midiOutputPorts": [], "controlOutputPorts": [], )"
+           << R"("processor": {"GainProcessorModel": {"nodeId": ")" << nodeId << R"("}}})";
+    }
+
+    json << R"(},
+    "connections": {)";
+
+    for (size_t i = 0; i < connections.size(); i++) {
+      auto& connection = connections[i];
+
+      json << (i > 0 ? ", " : "")
+           << "\"" << connection.id << R"(": {"id": ")" << connection.id
+           << R"(", "sourceNodeId": ")" << connection.sourceNodeId
+           << R"(", "sourcePortId": )" << connection.sourcePortId
+           << R"(, "destinationNodeId": ")" << connection.destinationNodeId
+           << R"(", "destinationPortId": )" << connection.destinationPortId << "}";
+    }
+
+    json << R"(},
+    "masterOutputNodeId": "master"
+  },
+  "generators": {},
+  "generatorOrder": [],
+  "id": "projectId",
+  "isSaved": false
+})";
+
+    return json.str();
+  }
+
+  // Replaces the project in the Anthem instance with a synthetic one.
+  static void load(int nodeCount, int connectionsPerNode, int noteCount) {
+    auto projectResult = rfl::json::read<std::shared_ptr<Project>>(
+      createProjectJson(nodeCount, connectionsPerNode, noteCount)
+    );
+
+    if (projectResult.error().has_value()) {
+      throw std::runtime_error("Synthetic project is invalid: " + projectResult.error().value().what());
+    }
+
+    auto& anthem = Anthem::getInstance();
+
+    anthem.project = std::move(projectResult.value());
+    anthem.project->initialize(anthem.project, nullptr);
+  }
+};
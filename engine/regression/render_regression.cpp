@@ -0,0 +1,261 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Renders each project fixture in regression/fixtures through the real graph
+// compiler and graph processor, and checks the output against golden output.
+//
+// Usage: AnthemRenderRegression [--fixture=<name>] [--tolerance=<amount>]
+//                               [--update-golden [--seconds=<n>] [--block-size=<n>]]
+//                               [--output=<file>]
+//
+// By default, a fixture passes only if its output is bit-identical to the
+// golden output, which is checked by comparing hashes. If --tolerance is
+// given, a fixture whose hash doesn't match still passes if every sample is
+// within that distance of the golden audio. This is useful for changes that
+// are expected to alter rounding, such as vectorizing a processor.
+//
+// The golden hashes live in regression/golden/golden.json and are checked in.
+// The golden audio is too big to check in, so it's written next to them in
+// regression/golden/audio, which is ignored by git. To compare with a
+// tolerance, run with --update-golden on a known-good build first, then run
+// again on the build under test.
+//
+// --update-golden re-renders every selected fixture and replaces its golden
+// hash and audio. --seconds and --block-size only apply when updating; normal
+// runs use the length and block size recorded with the golden output, so
+// they always compare like with like.
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include <iostream>
+
+#include <rfl.hpp>
+#include <rfl/json.hpp>
+
+#include "console_logger.h"
+
+#include "modules/core/anthem.h"
+
+#include "regression/render_regression.h"
+
+int main(int argc, char** argv) {
+  juce::Logger::setCurrentLogger(new ConsoleLogger());
+
+  juce::ArgumentList arguments(argc, argv);
+
+  auto fixtureFilter = arguments.getValueForOption("--fixture");
+  auto outputPath = arguments.getValueForOption("--output");
+  auto updateGolden = arguments.containsOption("--update-golden");
+
+  auto tolerance = arguments.containsOption("--tolerance")
+    ? arguments.getValueForOption("--tolerance").getDoubleValue()
+    : 0.0;
+
+  auto seconds = arguments.containsOption("--seconds")
+    ? arguments.getValueForOption("--seconds").getDoubleValue()
+    : 2.0;
+
+  auto blockSize = arguments.containsOption("--block-size")
+    ? arguments.getValueForOption("--block-size").getIntValue()
+    : 512;
+
+  if (blockSize <= 0 || blockSize > MAX_AUDIO_BUFFER_SIZE) {
+    std::cerr << "Block size must be between 1 and " << MAX_AUDIO_BUFFER_SIZE << "." << std::endl;
+    return 1;
+  }
+
+  if (seconds <= 0.0 || tolerance < 0.0) {
+    std::cerr << "Seconds must be positive, and tolerance can't be negative." << std::endl;
+    return 1;
+  }
+
+  juce::File regressionDirectory(ANTHEM_REGRESSION_DIR);
+  auto fixturesDirectory = regressionDirectory.getChildFile("fixtures");
+  auto goldenDirectory = regressionDirectory.getChildFile("golden");
+  auto manifestFile = goldenDirectory.getChildFile("golden.json");
+  auto audioDirectory = goldenDirectory.getChildFile("audio");
+
+  RenderGoldenManifest manifest;
+
+  if (manifestFile.existsAsFile()) {
+    auto manifestResult = rfl::json::read<RenderGoldenManifest>(manifestFile.loadFileAsString().toStdString());
+
+    if (manifestResult.error().has_value()) {
+      std::cerr << "Could not read " << manifestFile.getFullPathName() << ": " << manifestResult.error().value().what() << std::endl;
+      return 1;
+    }
+
+    manifest = std::move(manifestResult.value());
+  }
+
+  // Some of the code under test checks that it's being called from the
+  // message thread, so we make this thread the message thread.
+  juce::MessageManager::getInstance();
+
+  Anthem::getInstance().initialize();
+
+  RenderRegressionReport report {
+    .timestamp = juce::Time::getCurrentTime().toISO8601(true).toStdString(),
+    #ifdef NDEBUG
+    .buildType = "release",
+    #else
+    .buildType = "debug",
+    #endif
+    .tolerance = tolerance,
+    .results = {},
+  };
+
+  auto fixtureFiles = fixturesDirectory.findChildFiles(juce::File::findFiles, false, "*.json");
+  fixtureFiles.sort();
+
+  bool hasFailure = false;
+
+  for (auto& fixtureFile : fixtureFiles) {
+    auto fixtureName = fixtureFile.getFileNameWithoutExtension().toStdString();
+
+    if (fixtureFilter.isNotEmpty() && fixtureName != fixtureFilter.toStdString()) {
+      continue;
+    }
+
+    auto goldenIter = manifest.find(fixtureName);
+    std::optional<RenderGolden> golden = goldenIter != manifest.end()
+      ? std::optional(goldenIter->second)
+      : std::nullopt;
+
+    RenderFixtureResult result {
+      .fixture = fixtureName,
+      .status = "fail",
+      .error = std::nullopt,
+      .hash = "",
+      .goldenHash = golden.has_value() ? std::optional(golden->hash) : std::nullopt,
+      .maxAbsoluteDifference = std::nullopt,
+      .firstDifferentSample = std::nullopt,
+      .lengthInSamples = updateGolden || !golden.has_value()
+        ? static_cast<int64_t>(seconds * DEFAULT_SAMPLE_RATE)
+        : golden->lengthInSamples,
+      .blockSize = updateGolden || !golden.has_value() ? blockSize : golden->blockSize,
+      .renderSeconds = 0.0,
+      .realTimeFactor = 0.0,
+    };
+
+    if (!updateGolden && !golden.has_value()) {
+      result.error = "There is no golden output for this fixture. Run with --update-golden to create it.";
+    } else {
+      try {
+        auto audio = RenderRegression::render(fixtureFile, result.lengthInSamples, result.blockSize, result.renderSeconds);
+
+        result.hash = RenderRegression::hash(audio);
+
+        auto renderedSeconds = static_cast<double>(result.lengthInSamples) / DEFAULT_SAMPLE_RATE;
+        result.realTimeFactor = result.renderSeconds > 0.0 ? renderedSeconds / result.renderSeconds : 0.0;
+
+        auto audioFile = audioDirectory.getChildFile(juce::String(fixtureName) + ".wav");
+
+        if (updateGolden) {
+          std::string error;
+
+          if (RenderRegression::writeAudio(audioFile, audio, error)) {
+            manifest[fixtureName] = RenderGolden {
+              .hash = result.hash,
+              .lengthInSamples = result.lengthInSamples,
+              .blockSize = result.blockSize,
+              .numChannels = audio.getNumChannels(),
+            };
+
+            result.status = "updated";
+          } else {
+            result.error = error;
+          }
+        } else if (result.hash == golden->hash) {
+          result.status = "pass";
+        } else {
+          auto goldenAudio = RenderRegression::readAudio(audioFile);
+
+          if (!goldenAudio.has_value()) {
+            result.error = "The output doesn't match the golden hash, and there is no golden audio to compare against. Run with --update-golden on a known-good build to create it.";
+          } else if (RenderRegression::hash(goldenAudio.value()) != golden->hash) {
+            result.error = "The golden audio on disk doesn't match the golden hash, so it was made from a different build. Run with --update-golden on a known-good build to replace it.";
+          } else if (RenderRegression::compare(audio, goldenAudio.value(), tolerance, result)) {
+            result.status = "pass";
+          }
+        }
+      } catch (std::exception& e) {
+        result.error = e.what();
+      }
+    }
+
+    juce::String summary;
+
+    if (result.status == "pass") {
+      summary << "PASS   " << fixtureName
+              << (result.hash == golden->hash
+                    ? juce::String(" (bit-exact")
+                    : " (within tolerance, max difference " + juce::String(result.maxAbsoluteDifference.value()))
+              << ", " << juce::String(result.realTimeFactor, 1) << "x real-time)";
+    } else if (result.status == "updated") {
+      summary << "UPDATE " << fixtureName << " (" << juce::String(result.realTimeFactor, 1) << "x real-time)";
+    } else {
+      hasFailure = true;
+
+      summary << "FAIL   " << fixtureName;
+
+      if (result.firstDifferentSample.has_value()) {
+        summary << " (first difference at sample " << juce::String(result.firstDifferentSample.value())
+                << ", max difference " << juce::String(result.maxAbsoluteDifference.value()) << ")";
+      }
+
+      if (result.error.has_value()) {
+        summary << ": " << result.error.value();
+      }
+    }
+
+    juce::Logger::writeToLog(summary);
+
+    report.results.push_back(std::move(result));
+  }
+
+  if (report.results.empty()) {
+    std::cerr << "No fixtures were run." << std::endl;
+    hasFailure = true;
+  }
+
+  if (updateGolden) {
+    goldenDirectory.createDirectory();
+
+    if (!manifestFile.replaceWithText(rfl::json::write(manifest, rfl::json::pretty) + "\n")) {
+      std::cerr << "Could not write " << manifestFile.getFullPathName() << std::endl;
+      hasFailure = true;
+    }
+  }
+
+  if (outputPath.isNotEmpty()) {
+    juce::File outputFile(juce::File::getCurrentWorkingDirectory().getChildFile(outputPath));
+
+    if (!outputFile.replaceWithText(rfl::json::write(report, rfl::json::pretty))) {
+      std::cerr << "Could not write results to " << outputFile.getFullPathName() << std::endl;
+      hasFailure = true;
+    }
+  }
+
+  Anthem::getInstance().shutdown();
+  Anthem::cleanup();
+
+  return hasFailure ? 1 : 0;
+}
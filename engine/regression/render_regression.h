@@ -0,0 +1,285 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+
+#include <rfl.hpp>
+#include <rfl/json.hpp>
+
+#include "modules/core/anthem.h"
+#include "modules/core/project.h"
+#include "modules/processing_graph/compiler/anthem_graph_compiler.h"
+#include "modules/processing_graph/compiler/anthem_graph_topology_snapshot.h"
+
+// What a fixture is expected to render.
+//
+// These are checked in, so any change to the output of a fixture shows up in
+// review as a changed hash.
+struct RenderGolden {
+  std::string hash;
+  int64_t lengthInSamples;
+  int blockSize;
+  int numChannels;
+};
+
+// Golden entries, keyed by fixture name.
+using RenderGoldenManifest = std::map<std::string, RenderGolden>;
+
+struct RenderFixtureResult {
+  std::string fixture;
+
+  // "pass", "fail" or "updated".
+  std::string status;
+  std::optional<std::string> error;
+
+  std::string hash;
+  std::optional<std::string> goldenHash;
+
+  // If the hash didn't match and we had golden audio to compare against,
+  // these describe how far off the render was.
+  std::optional<double> maxAbsoluteDifference;
+  std::optional<int64_t> firstDifferentSample;
+
+  int64_t lengthInSamples;
+  int blockSize;
+
+  // Wall-clock time spent in AnthemGraphProcessor::process().
+  double renderSeconds;
+  double realTimeFactor;
+};
+
+struct RenderRegressionReport {
+  std::string timestamp;
+  std::string buildType;
+  double tolerance;
+  std::vector<RenderFixtureResult> results;
+};
+
+// Helpers for rendering project fixtures and comparing them against golden
+// output. See render_regression.cpp for how these fit together.
+class RenderRegression {
+public:
+  // Loads a project fixture into the Anthem instance, compiles its processing
+  // graph, and renders lengthInSamples of the master output.
+  //
+  // This drives the graph processor directly from the calling thread, in
+  // blocks of blockSize, the same way AnthemOfflineRenderer does. The audio
+  // device must not be running.
+  static juce::AudioBuffer<float> render(
+    const juce::File& fixtureFile,
+    int64_t lengthInSamples,
+    int blockSize,
+    double& renderSeconds
+  ) {
+    auto projectResult = rfl::json::read<std::shared_ptr<Project>>(
+      fixtureFile.loadFileAsString().toStdString()
+    );
+
+    if (projectResult.error().has_value()) {
+      throw std::runtime_error(
+        "Fixture " + fixtureFile.getFileName().toStdString() + " is invalid: " + projectResult.error().value().what()
+      );
+    }
+
+    auto& anthem = Anthem::getInstance();
+
+    anthem.project = std::move(projectResult.value());
+    anthem.project->initialize(anthem.project, nullptr);
+
+    // We compile synchronously here rather than going through the compile
+    // worker, so the first block we process is guaranteed to use this graph.
+    // Fixtures always render at the default sample rate, so the golden hashes
+    // don't depend on the machine.
+    auto topology = AnthemGraphTopologySnapshot::create(
+      *anthem.project,
+      AnthemProcessingConfig {
+        .sampleRate = DEFAULT_SAMPLE_RATE,
+        .maxBlockSize = blockSize,
+      }
+    );
+    anthem.graphProcessor->setProcessingStepsFromMainThread(AnthemGraphCompiler::compile(*topology));
+
+    auto masterOutputProcessor = anthem.getMasterOutputProcessor();
+
+    if (masterOutputProcessor == nullptr) {
+      throw std::runtime_error("The fixture has no master output node.");
+    }
+
+    auto& masterBuffer = masterOutputProcessor->buffer;
+
+    juce::AudioBuffer<float> output(masterBuffer.getNumChannels(), static_cast<int>(lengthInSamples));
+    output.clear();
+
+    // See modules/util/denormals.h.
+    juce::ScopedNoDenormals noDenormals;
+
+    auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    for (int64_t position = 0; position < lengthInSamples; position += blockSize) {
+      auto numSamples = static_cast<int>(std::min<int64_t>(blockSize, lengthInSamples - position));
+
+      anthem.graphProcessor->process(numSamples);
+
+      for (int channel = 0; channel < output.getNumChannels(); channel++) {
+        output.copyFrom(channel, static_cast<int>(position), masterBuffer, channel, 0, numSamples);
+      }
+    }
+
+    renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    // The previous fixture's graph was handed back when this one was picked
+    // up. We don't run the message loop, so the graph processor's timer
+    // won't clean it up for us.
+    anthem.graphProcessor->clearDeletionQueueFromMainThread();
+
+    return output;
+  }
+
+  // Hashes the exact bit patterns of the samples, channel by channel.
+  static std::string hash(const juce::AudioBuffer<float>& buffer) {
+    juce::MemoryBlock data;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+      data.append(buffer.getReadPointer(channel), sizeof(float) * static_cast<size_t>(buffer.getNumSamples()));
+    }
+
+    return juce::SHA256(data).toHexString().toStdString();
+  }
+
+  // Golden audio is stored as 32-bit float WAV, so it round-trips exactly.
+  static bool writeAudio(const juce::File& file, const juce::AudioBuffer<float>& buffer, std::string& error) {
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    auto stream = file.createOutputStream();
+
+    if (stream == nullptr) {
+      error = "Could not open " + file.getFullPathName().toStdString() + " for writing.";
+      return false;
+    }
+
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(
+      stream.get(),
+      DEFAULT_SAMPLE_RATE,
+      static_cast<unsigned int>(buffer.getNumChannels()),
+      32,
+      {},
+      0
+    ));
+
+    if (writer == nullptr) {
+      error = "Could not create a WAV writer for " + file.getFullPathName().toStdString() + ".";
+      return false;
+    }
+
+    // The writer owns the stream now.
+    stream.release();
+
+    if (!writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples())) {
+      error = "Could not write to " + file.getFullPathName().toStdString() + ".";
+      return false;
+    }
+
+    return true;
+  }
+
+  static std::optional<juce::AudioBuffer<float>> readAudio(const juce::File& file) {
+    if (!file.existsAsFile()) {
+      return std::nullopt;
+    }
+
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatReader> reader(format.createReaderFor(file.createInputStream().release(), true));
+
+    if (reader == nullptr) {
+      return std::nullopt;
+    }
+
+    juce::AudioBuffer<float> buffer(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+    reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+    return buffer;
+  }
+
+  // Compares a render against golden audio, filling in the difference fields
+  // on the result. Returns true if every sample is within tolerance.
+  static bool compare(
+    const juce::AudioBuffer<float>& actual,
+    const juce::AudioBuffer<float>& expected,
+    double tolerance,
+    RenderFixtureResult& result
+  ) {
+    if (actual.getNumChannels() != expected.getNumChannels() || actual.getNumSamples() != expected.getNumSamples()) {
+      result.error = "Golden audio has a different length or channel count than the render.";
+      return false;
+    }
+
+    double maxDifference = 0.0;
+    std::optional<int64_t> firstDifferentSample;
+
+    for (int channel = 0; channel < actual.getNumChannels(); channel++) {
+      auto* actualSamples = actual.getReadPointer(channel);
+      auto* expectedSamples = expected.getReadPointer(channel);
+
+      for (int sample = 0; sample < actual.getNumSamples(); sample++) {
+        auto actualValue = static_cast<double>(actualSamples[sample]);
+        auto expectedValue = static_cast<double>(expectedSamples[sample]);
+
+        bool isDifferent;
+
+        // NaN never compares greater than anything, so it's checked for
+        // separately.
+        if (std::isnan(actualValue) || std::isnan(expectedValue)) {
+          isDifferent = std::isnan(actualValue) != std::isnan(expectedValue);
+
+          if (isDifferent) {
+            result.error = "Render and golden audio disagree on NaN samples.";
+          }
+        } else {
+          auto difference = std::abs(actualValue - expectedValue);
+          maxDifference = std::max(maxDifference, difference);
+          isDifferent = difference > tolerance;
+        }
+
+        if (isDifferent && (!firstDifferentSample.has_value() || sample < firstDifferentSample.value())) {
+          firstDifferentSample = sample;
+        }
+      }
+    }
+
+    result.maxAbsoluteDifference = maxDifference;
+    result.firstDifferentSample = firstDifferentSample;
+
+    return !firstDifferentSample.has_value();
+  }
+};
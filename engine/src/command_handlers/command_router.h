@@ -0,0 +1,131 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <rfl.hpp>
+
+#include "messages/messages.h"
+
+// Routes requests from the UI to the handler for that request type.
+//
+// Each request type can have at most one handler. Handlers are stored in a
+// table indexed by the position of the request type in the Request variant, so
+// routing a request is a single lookup instead of asking every command handler
+// module in turn whether it recognizes the request.
+//
+// Command handler modules expose a registerXCommandHandlers(CommandRouter&)
+// function that registers a handler for each request type they know about.
+class CommandRouter {
+public:
+  using Handler = std::function<std::optional<Response>(Request& request)>;
+  using ResponseSender = std::function<void(Response& response)>;
+
+private:
+  using RequestVariant = std::remove_cvref_t<decltype(std::declval<Request&>().variant())>;
+
+  // Gets the number of alternatives in the request variant, and the index of a
+  // given type in it. This works for both std::variant and rfl::Variant.
+  template <typename Variant>
+  struct VariantInfo;
+
+  template <template <typename...> typename Variant, typename... Ts>
+  struct VariantInfo<Variant<Ts...>> {
+    static constexpr size_t size = sizeof...(Ts);
+
+    template <typename T>
+    static constexpr size_t indexOf() {
+      constexpr bool matches[] = { std::is_same_v<T, Ts>... };
+
+      for (size_t i = 0; i < sizeof...(Ts); i++) {
+        if (matches[i]) {
+          return i;
+        }
+      }
+
+      return sizeof...(Ts);
+    }
+  };
+
+  std::vector<Handler> handlers;
+
+  ResponseSender responseSender;
+
+public:
+  CommandRouter() : handlers(VariantInfo<RequestVariant>::size) {}
+
+  // Registers a handler for requests of type T.
+  //
+  // The handler receives the request that was moved into route(), so it is
+  // free to move data out of it.
+  template <typename T>
+  void registerHandler(std::function<std::optional<Response>(T& request)> handler) {
+    constexpr size_t index = VariantInfo<RequestVariant>::template indexOf<T>();
+
+    static_assert(
+      index < VariantInfo<RequestVariant>::size,
+      "Tried to register a handler for a type that is not a request."
+    );
+
+    // Each request type should only be handled in one place.
+    jassert(!handlers[index]);
+
+    handlers[index] = [handler = std::move(handler)](Request& request) {
+      return handler(rfl::get<T>(request.variant()));
+    };
+  }
+
+  // Sends the request to its handler, and returns the handler's response.
+  //
+  // Requests with no registered handler are ignored.
+  std::optional<Response> route(Request& request) {
+    auto index = static_cast<size_t>(request.variant().index());
+
+    if (index >= handlers.size() || !handlers[index]) {
+      return std::nullopt;
+    }
+
+    return handlers[index](request);
+  }
+
+  // Sets the function that is used to send responses outside of route().
+  void setResponseSender(ResponseSender sender) {
+    responseSender = std::move(sender);
+  }
+
+  // Sends a response to the UI.
+  //
+  // Handlers that finish their work asynchronously can return std::nullopt
+  // from route(), hold on to the router, and reply with this once they're
+  // done. This must be called on the message thread.
+  void sendResponse(Response& response) {
+    jassert(responseSender);
+    jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+    responseSender(response);
+  }
+};
@@ -23,72 +23,285 @@
 // compile the deserialization call without it.
 #include "modules/processors/tone_generator.h"
 
+#include "modules/sequencer/compiler/sequence_compiler.h"
+
+#include <rfl/json.hpp>
+
 #include <string>
 
-std::optional<Response> handleModelSyncCommand(Request& request) {
-  auto& anthem = Anthem::getInstance();
+// Set while a project is being deserialized on the loader thread. This is only
+// read and written from the main thread.
+static bool projectLoadInProgress = false;
 
-  if (rfl::holds_alternative<ModelInitRequest>(request.variant())) {
-    juce::Logger::writeToLog("Loading project model...");
+static std::function<void()> projectLoadedCallback;
 
-    auto& modelInitRequest = rfl::get<ModelInitRequest>(request.variant());
+bool isProjectLoadInProgress() {
+  return projectLoadInProgress;
+}
 
-    // std::cout << modelInitRequest.serializedModel << std::endl;
+void setProjectLoadedCallback(std::function<void()> callback) {
+  projectLoadedCallback = std::move(callback);
+}
 
-    auto result = rfl::json::read<std::shared_ptr<Project>>(
-      modelInitRequest.serializedModel
-    );
+// The result of serializing part of the project model. See
+// serializeProjectSubtree().
+struct SerializedSubtree {
+  // False if we don't know how to serialize the given path on its own.
+  bool isKnownPath;
 
-    // auto result = Project::fromJson(modelInitRequest.serializedModel);
+  // False if the path pointed to a map entry that no longer exists.
+  bool exists;
 
-    auto err = result.error();
+  std::string serializedValue;
+};
 
-    if (err.has_value()) {
-      juce::Logger::writeToLog("Error during deserialize:");
-      std::cout << err.value().what() << std::endl;
-      jassertfalse;
-      // This shouldn't be possible if the UI loaded the project successfully,
-      // but if it does happen, we should probably handle it better.
-    }
-    else {
-      anthem.project = std::move(
-        result.value()
-      );
+template <typename MapPtr>
+static SerializedSubtree serializeMapEntry(MapPtr& map, const std::string& key) {
+  auto it = map->find(key);
 
-      anthem.project->initialize(
-        anthem.project,
-        nullptr
-      );
+  if (it == map->end()) {
+    return SerializedSubtree { .isKnownPath = true, .exists = false, .serializedValue = "" };
+  }
 
-      juce::Logger::writeToLog("Loaded project model");
-      std::cout << "id: " << anthem.project->id() << std::endl;
+  return SerializedSubtree {
+    .isKnownPath = true,
+    .exists = true,
+    .serializedValue = rfl::json::write(it->second)
+  };
+}
 
-      // We could probably move this action to a command, but for now we always
-      // want to start as soon as we have a valid project anyway, so this is
-      // probably fine.
-      anthem.startAudioCallback();
+template <typename T>
+static SerializedSubtree serializeField(T& field) {
+  return SerializedSubtree {
+    .isKnownPath = true,
+    .exists = true,
+    .serializedValue = rfl::json::write(field)
+  };
+}
+
+// Serializes a subtree of the project, as described by a path from
+// ModelChangeTracker.
+static SerializedSubtree serializeProjectSubtree(Project& project, const std::vector<std::string>& path) {
+  auto& field = path[0];
+
+  if (path.size() == 1) {
+    if (field == "sequence") return serializeField(project.sequence());
+    if (field == "processingGraph") return serializeField(project.processingGraph());
+    if (field == "generators") return serializeField(project.generators());
+    if (field == "generatorOrder") return serializeField(project.generatorOrder());
+  }
+  else {
+    auto& key = path.back();
+
+    if (field == "generators") {
+      return serializeMapEntry(project.generators(), key);
+    }
+    else if (field == "sequence" && path[1] == "patterns") {
+      return serializeMapEntry(project.sequence()->patterns(), key);
+    }
+    else if (field == "sequence" && path[1] == "arrangements") {
+      return serializeMapEntry(project.sequence()->arrangements(), key);
+    }
+    else if (field == "processingGraph" && path[1] == "nodes") {
+      return serializeMapEntry(project.processingGraph()->nodes(), key);
+    }
+    else if (field == "processingGraph" && path[1] == "connections") {
+      return serializeMapEntry(project.processingGraph()->connections(), key);
     }
   }
-  else if (rfl::holds_alternative<ModelUpdateRequest>(request.variant())) {
-    auto& modelUpdateRequest = rfl::get<ModelUpdateRequest>(request.variant());
 
-    anthem.project->handleModelUpdate(
-      modelUpdateRequest,
-      0
+  return SerializedSubtree { .isKnownPath = false, .exists = false, .serializedValue = "" };
+}
+
+// Called on the main thread once the loader thread has finished deserializing
+// the project and compiling its patterns.
+static void finishProjectLoad(
+  std::shared_ptr<Project> project,
+  std::unordered_map<std::string, SequenceEventListCollection> compiledPatterns
+) {
+  auto& anthem = Anthem::getInstance();
+
+  if (project != nullptr) {
+    anthem.project = std::move(project);
+
+    anthem.project->initialize(
+      anthem.project,
+      nullptr
     );
+
+    // The patterns were compiled from the same JSON as the project, so they
+    // must be published before the deferred requests below are replayed.
+    // Otherwise, they would overwrite any pattern edits in those requests.
+    anthem.sequenceStore->addOrUpdateSequences(std::move(compiledPatterns));
+
+    anthem.modelChangeTracker.recordModelReplaced();
+
+    juce::Logger::writeToLog("Loaded project model");
+    std::cout << "id: " << anthem.project->id() << std::endl;
+
+    // We could probably move this action to a command, but for now we always
+    // want to start as soon as we have a valid project anyway, so this is
+    // probably fine.
+    anthem.startAudioCallback();
   }
-  else if (rfl::holds_alternative<GetSerializedModelFromEngineRequest>(request.variant())) {
-    auto& getSerializedModelFromEngineRequest = rfl::get<GetSerializedModelFromEngineRequest>(request.variant());
-
-    return std::optional(GetSerializedModelFromEngineResponse {
-      .serializedModel = rfl::json::write(
-        anthem.project.get()
-      ),
-      .responseBase = ResponseBase {
-        .id = getSerializedModelFromEngineRequest.requestBase.get().id
-      }
-    });
+
+  projectLoadInProgress = false;
+
+  if (projectLoadedCallback) {
+    projectLoadedCallback();
   }
+}
+
+static std::optional<Response> handleModelInitRequest(ModelInitRequest& modelInitRequest) {
+  auto& anthem = Anthem::getInstance();
+
+  juce::Logger::writeToLog("Loading project model...");
+
+  // Deserializing a large project can take a while, and if we do it here then
+  // the main thread can't do anything else - including replying to
+  // heartbeats - until it's done. Instead, we parse the project on a loader
+  // thread and pick it back up on the main thread once it's ready.
+  //
+  // Opening the audio device is also slow on some platforms, so we do that
+  // now, while the project is being parsed, rather than after. The audio
+  // callback itself can't be attached until we have a project, since it
+  // needs the master output node.
+  //
+  // Any requests that arrive in the meantime are deferred by the caller (see
+  // isProjectLoadInProgress()), and are replayed in order once the project
+  // is loaded.
+  projectLoadInProgress = true;
+
+  anthem.openAudioDevice();
+
+  juce::Thread::launch(
+    [serializedModel = std::move(modelInitRequest.serializedModel)]() {
+      // We parse the JSON once, and read both the project model and the
+      // compiled patterns out of the same document.
+      auto* document = yyjson_read(serializedModel.data(), serializedModel.size(), 0);
+
+      if (document == nullptr) {
+        juce::Logger::writeToLog("Error during deserialize: the project JSON could not be parsed");
+        jassertfalse;
+
+        juce::MessageManager::callAsync([]() {
+          finishProjectLoad(nullptr, {});
+        });
+        return;
+      }
+
+      auto* root = yyjson_doc_get_root(document);
+
+      auto result = rfl::json::read<std::shared_ptr<Project>>(
+        rfl::json::Reader::InputVarType(root)
+      );
+
+      auto err = result.error();
+
+      if (err.has_value()) {
+        yyjson_doc_free(document);
+
+        juce::Logger::writeToLog("Error during deserialize:");
+        std::cout << err.value().what() << std::endl;
+        jassertfalse;
+        // This shouldn't be possible if the UI loaded the project
+        // successfully, but if it does happen, we should probably handle it
+        // better.
+
+        juce::MessageManager::callAsync([]() {
+          finishProjectLoad(nullptr, {});
+        });
+        return;
+      }
+
+      std::shared_ptr<Project> project = std::move(result.value());
+
+      // We also compile the pattern notes into event lists for the sequencer
+      // here. This reads the parsed JSON directly instead of going through the
+      // model, so it doesn't need the main thread.
+      auto compiledPatterns = AnthemSequenceCompiler::compilePatternsFromJson(root);
+
+      yyjson_doc_free(document);
+
+      juce::MessageManager::callAsync([project, compiledPatterns = std::move(compiledPatterns)]() mutable {
+        finishProjectLoad(project, std::move(compiledPatterns));
+      });
+    }
+  );
+
+  return std::nullopt;
+}
+
+static std::optional<Response> handleModelUpdateRequest(ModelUpdateRequest& modelUpdateRequest) {
+  auto& anthem = Anthem::getInstance();
+
+  anthem.modelChangeTracker.recordUpdate(modelUpdateRequest);
+
+  anthem.project->handleModelUpdate(
+    modelUpdateRequest,
+    0
+  );
 
   return std::nullopt;
 }
+
+static std::optional<Response> handleGetSerializedModelFromEngineRequest(
+  GetSerializedModelFromEngineRequest& getSerializedModelFromEngineRequest
+) {
+  auto& anthem = Anthem::getInstance();
+
+  auto& tracker = anthem.modelChangeTracker;
+  auto& sinceVersion = getSerializedModelFromEngineRequest.sinceVersion;
+
+  auto changedSubtrees = std::make_shared<std::unordered_map<std::string, std::string>>();
+  auto removedSubtrees = std::make_shared<std::vector<std::string>>();
+
+  bool isIncremental =
+    sinceVersion.has_value() &&
+    sinceVersion.value() >= 0 &&
+    tracker.canDiffFrom(static_cast<uint64_t>(sinceVersion.value()));
+
+  if (isIncremental) {
+    for (auto& path : tracker.getChangedSubtrees(static_cast<uint64_t>(sinceVersion.value()))) {
+      auto subtree = serializeProjectSubtree(*anthem.project, path);
+
+      // If any of the changes can't be sent on their own, we fall back to
+      // sending the whole model.
+      if (!subtree.isKnownPath) {
+        isIncremental = false;
+        break;
+      }
+
+      if (subtree.exists) {
+        changedSubtrees->insert_or_assign(ModelChangeTracker::joinPath(path), std::move(subtree.serializedValue));
+      }
+      else {
+        removedSubtrees->push_back(ModelChangeTracker::joinPath(path));
+      }
+    }
+  }
+
+  if (!isIncremental) {
+    changedSubtrees->clear();
+    removedSubtrees->clear();
+  }
+
+  return std::optional(GetSerializedModelFromEngineResponse {
+    .version = static_cast<int64_t>(tracker.getVersion()),
+    .isIncremental = isIncremental,
+    .serializedModel = isIncremental ? "" : rfl::json::write(
+      anthem.project.get()
+    ),
+    .changedSubtrees = changedSubtrees,
+    .removedSubtrees = removedSubtrees,
+    .responseBase = ResponseBase {
+      .id = getSerializedModelFromEngineRequest.requestBase.get().id
+    }
+  });
+}
+
+void registerModelSyncCommandHandlers(CommandRouter& router) {
+  router.registerHandler<ModelInitRequest>(handleModelInitRequest);
+  router.registerHandler<ModelUpdateRequest>(handleModelUpdateRequest);
+  router.registerHandler<GetSerializedModelFromEngineRequest>(handleGetSerializedModelFromEngineRequest);
+}
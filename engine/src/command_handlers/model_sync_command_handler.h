@@ -24,5 +24,17 @@
 #include <rfl.hpp>
 
 #include "messages/messages.h"
+#include "command_router.h"
 
-std::optional<Response> handleModelSyncCommand(Request& request);
+#include <functional>
+
+void registerModelSyncCommandHandlers(CommandRouter& router);
+
+// Returns true while a project sent with ModelInitRequest is still being
+// deserialized. Most requests need the project model, so requests that arrive
+// during this time should be held back until the load is finished.
+bool isProjectLoadInProgress();
+
+// Sets a callback that is called on the main thread after a project load
+// finishes, whether or not it succeeded.
+void setProjectLoadedCallback(std::function<void()> callback);
@@ -19,39 +19,68 @@
 
 #include "processing_graph_command_handler.h"
 
-std::optional<Response>
-handleProcessingGraphCommand(Request& request) {
+// Compilation happens on a background thread, so this returns nothing right
+// away and replies through the router once the compile is finished.
+static std::optional<Response> handleCompileProcessingGraphRequest(
+  CommandRouter& router,
+  CompileProcessingGraphRequest& compileProcessingGraphRequest
+) {
   auto& anthem = Anthem::getInstance();
 
-  if (rfl::holds_alternative<CompileProcessingGraphRequest>(request.variant())) {
-    auto& compileProcessingGraphRequest = rfl::get<CompileProcessingGraphRequest>(request.variant());
+  juce::Logger::writeToLog("Compiling from UI request...");
 
-    juce::Logger::writeToLog("Compiling from UI request...");
+  auto requestId = compileProcessingGraphRequest.requestBase.get().id;
 
-    try {
-      anthem.compileProcessingGraph();
-    } catch (std::runtime_error& e) {
-      juce::Logger::writeToLog("Error compiling: " + std::string(e.what()));
-
-      return std::optional(CompileProcessingGraphResponse {
-        .success = false,
-        .error = std::string(e.what()),
-        .responseBase = ResponseBase {
-          .id = compileProcessingGraphRequest.requestBase.get().id
-        }
-      });
+  anthem.compileProcessingGraph([&router, requestId](std::optional<std::string> error) {
+    if (error.has_value()) {
+      juce::Logger::writeToLog("Error compiling: " + error.value());
+    } else {
+      juce::Logger::writeToLog("Finished compiling.");
     }
 
-    juce::Logger::writeToLog("Finished compiling.");
-
-    return std::optional(CompileProcessingGraphResponse {
-      .success = true,
-      .error = std::nullopt,
+    Response response = CompileProcessingGraphResponse {
+      .success = !error.has_value(),
+      .error = error,
       .responseBase = ResponseBase {
-        .id = compileProcessingGraphRequest.requestBase.get().id
+        .id = requestId
       }
-    });
-  }
+    };
+
+    router.sendResponse(response);
+  });
 
   return std::nullopt;
 }
+
+static std::optional<Response> handleGetProcessingGraphStatsRequest(
+  GetProcessingGraphStatsRequest& getProcessingGraphStatsRequest
+) {
+  auto& anthem = Anthem::getInstance();
+
+  auto telemetry = anthem.graphProcessor->getEventAllocatorTelemetry();
+
+  return std::optional(GetProcessingGraphStatsResponse {
+    .eventAllocatorCapacity = static_cast<int64_t>(telemetry.capacity),
+    .eventAllocatorUsed = static_cast<int64_t>(telemetry.used),
+    .eventAllocatorHighWater = static_cast<int64_t>(telemetry.highWater),
+    .eventAllocatorFragmentation = telemetry.fragmentation,
+    .eventBufferReallocations = static_cast<int64_t>(telemetry.reallocations),
+    .eventBufferOverflows = static_cast<int64_t>(telemetry.overflows),
+    .totalEventBufferReallocations = static_cast<int64_t>(telemetry.totalReallocations),
+    .totalEventBufferOverflows = static_cast<int64_t>(telemetry.totalOverflows),
+    .eventAllocatorGrowthHighWater = static_cast<int64_t>(telemetry.growthHighWater),
+    .responseBase = ResponseBase {
+      .id = getProcessingGraphStatsRequest.requestBase.get().id
+    }
+  });
+}
+
+void registerProcessingGraphCommandHandlers(CommandRouter& router) {
+  router.registerHandler<CompileProcessingGraphRequest>(
+    [&router](CompileProcessingGraphRequest& request) {
+      return handleCompileProcessingGraphRequest(router, request);
+    }
+  );
+
+  router.registerHandler<GetProcessingGraphStatsRequest>(handleGetProcessingGraphStatsRequest);
+}
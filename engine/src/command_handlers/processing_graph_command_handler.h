@@ -22,5 +22,6 @@
 #include "modules/core/anthem.h"
 
 #include "messages/messages.h"
+#include "command_router.h"
 
-std::optional<Response> handleProcessingGraphCommand(Request& request);
+void registerProcessingGraphCommandHandlers(CommandRouter& router);
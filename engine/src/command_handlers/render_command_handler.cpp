@@ -0,0 +1,96 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "render_command_handler.h"
+
+#include <algorithm>
+#include <vector>
+
+// Renders happen on a background thread, so this returns nothing right away
+// and replies through the router once the render is finished.
+static std::optional<Response> handleRenderRequest(
+  CommandRouter& router,
+  RenderRequest& renderRequest
+) {
+  auto& anthem = Anthem::getInstance();
+
+  auto requestId = renderRequest.requestBase.get().id;
+
+  juce::Logger::writeToLog(
+    "Rendering " + std::to_string(renderRequest.taps->size()) + " taps" +
+    (renderRequest.outputPath.has_value() ? " and the master output to " + renderRequest.outputPath.value() : "") +
+    "..."
+  );
+
+  std::vector<AnthemOfflineRenderTap> taps;
+
+  for (auto& tap : *renderRequest.taps) {
+    taps.push_back(AnthemOfflineRenderTap {
+      .nodeId = tap->nodeId,
+      .portId = static_cast<int32_t>(tap->portId),
+      .outputFile = juce::File(tap->outputPath),
+    });
+  }
+
+  AnthemOfflineRenderOptions options {
+    .outputFile = renderRequest.outputPath.has_value() ? juce::File(renderRequest.outputPath.value()) : juce::File(),
+    .format = renderRequest.format,
+    .lengthInSamples = renderRequest.lengthInSamples,
+    .blockSize = static_cast<int>(renderRequest.blockSize),
+    .sampleRate = static_cast<double>(renderRequest.sampleRate.value_or(0)),
+    .bitDepth = static_cast<int>(renderRequest.bitDepth),
+    .taps = std::move(taps),
+    .processingThreads = std::clamp(
+      static_cast<int>(renderRequest.processingThreads), 1, juce::SystemStats::getNumCpus()
+    ),
+  };
+
+  anthem.renderOffline(std::move(options), [&router, requestId](AnthemOfflineRenderResult result) {
+    if (result.success) {
+      juce::Logger::writeToLog(
+        "Finished rendering " + std::to_string(result.samplesRendered) + " samples in " +
+        std::to_string(result.renderSeconds) + " seconds (" +
+        std::to_string(result.realTimeFactor) + "x real-time)."
+      );
+    } else {
+      juce::Logger::writeToLog("Error rendering: " + result.error.value_or("Unknown error"));
+    }
+
+    Response response = RenderResponse {
+      .success = result.success,
+      .error = result.error,
+      .realTimeFactor = result.success ? std::optional(result.realTimeFactor) : std::nullopt,
+      .responseBase = ResponseBase {
+        .id = requestId
+      }
+    };
+
+    router.sendResponse(response);
+  });
+
+  return std::nullopt;
+}
+
+void registerRenderCommandHandlers(CommandRouter& router) {
+  router.registerHandler<RenderRequest>(
+    [&router](RenderRequest& request) {
+      return handleRenderRequest(router, request);
+    }
+  );
+}
@@ -19,6 +19,6 @@
 
 #include "sequencer_command_handler.h"
 
-std::optional<Response> handleSequencerCommand(Request& request) {
-  return std::nullopt;
+void registerSequencerCommandHandlers([[maybe_unused]] CommandRouter& router) {
+  // No sequencer commands are handled yet.
 }
@@ -20,5 +20,6 @@
 #pragma once
 
 #include "messages/messages.h"
+#include "command_router.h"
 
-std::optional<Response> handleSequencerCommand(Request& request);
+void registerSequencerCommandHandlers(CommandRouter& router);
@@ -31,6 +31,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <optional>
+#include <vector>
 
 #include <rfl/json.hpp>
 #include <rfl.hpp>
@@ -38,8 +39,11 @@
 #include "console_logger.h"
 
 #include "modules/core/anthem.h"
+#include "modules/util/audio_thread_memory.h"
+#include "./command_handlers/command_router.h"
 #include "./command_handlers/model_sync_command_handler.h"
 #include "./command_handlers/processing_graph_command_handler.h"
+#include "./command_handlers/render_command_handler.h"
 #include "./command_handlers/sequencer_command_handler.h"
 
 #include "messages/messages.h"
@@ -76,114 +80,132 @@ volatile bool canWriteToBuffer = true;
 class CommandMessage : public juce::Message
 {
 public:
-  Request request;
+  // JUCE only gives us a const reference to the message when it's delivered.
+  // This is mutable so the listener can move the request out instead of
+  // copying it, since requests can carry large payloads (e.g. an entire
+  // serialized project).
+  mutable Request request;
 
-  CommandMessage(Request request) : request(request) {}
+  CommandMessage(Request request) : request(std::move(request)) {}
 };
 
 class CommandMessageListener : public juce::MessageListener
 {
-public:
-  void handleMessage(const juce::Message& message) override {
-    const CommandMessage& command = dynamic_cast<const CommandMessage&>(message);
+private:
+  // Routes each request to the handler registered for its type.
+  CommandRouter router;
 
-    auto request = command.request;
+  // Requests that arrived while a project was being loaded. These are replayed
+  // in order once the load is finished. See isProjectLoadInProgress().
+  std::vector<Request> deferredRequests;
 
-    bool isExit = false;
+  void sendResponse(Response& response) {
+    // Serialize the response to a string
+    auto responseStr = rfl::json::write(response);
 
-    std::optional<Response> response = std::nullopt;
+    auto receiveBufferPtr = responseStr.c_str();
+    auto bufferSize = responseStr.size();
 
-    if (rfl::holds_alternative<Exit>(request.variant())) {
-      auto& requestAsExit = rfl::get<Exit>(request.variant());
+    // Write the message length to the socket
+    auto bufferSize64 = static_cast<uint64_t>(bufferSize);
 
-      auto exitReply = ExitReply{
-        .responseBase = ResponseBase{
-          .id = requestAsExit.requestBase.get().id
-        }
-      };
+    // Create an array to hold the bytes of the id
+    unsigned char bufferSizeBytes[sizeof(bufferSize64)];
 
-      response = std::optional(
-        std::move(exitReply)
-      );
+    // Copy the bytes of bufferSize64 into bufferSizeBytes
+    std::memcpy(bufferSizeBytes, &bufferSize64, sizeof(bufferSize64));
 
-      isExit = true;
-    }
+    std::unique_lock<std::mutex> socketLock(socketInUseMutex);
 
-    else if (rfl::holds_alternative<Heartbeat>(request.variant())) {
-      auto& requestAsHeartbeat = rfl::get<Heartbeat>(request.variant());
+    socketToUi.write(bufferSizeBytes, sizeof(uint64_t));
 
-      auto heartbeatReply = HeartbeatReply{
-        .responseBase = ResponseBase {
-          .id = requestAsHeartbeat.requestBase.get().id
-        }
-      };
+    // Write the message to the socket
+    socketToUi.write(receiveBufferPtr, bufferSize);
 
-      response = std::optional(
-        std::move(heartbeatReply)
-      );
+    socketLock.unlock();
+  }
 
-      heartbeatOccurred = true;
-    }
+  // Handles a single request and sends the reply, if there is one. Returns
+  // true if the request was an exit request.
+  bool handleRequest(Request& request) {
+    bool isExit = rfl::holds_alternative<Exit>(request.variant());
 
-    // Forward request to handlers
+    auto response = router.route(request);
 
-    bool didOverwriteResponse = false;
-    
-    auto handleModelSyncCommandResponse = handleModelSyncCommand(request);
-    if (handleModelSyncCommandResponse.has_value()) {
-      if (response.has_value()) {
-        didOverwriteResponse = true;
-      }
-      response = std::move(handleModelSyncCommandResponse);
+    if (response.has_value()) {
+      sendResponse(response.value());
     }
 
-    auto handleProcessingGraphCommandResponse = handleProcessingGraphCommand(request);
-    if (handleProcessingGraphCommandResponse.has_value()) {
-      if (response.has_value()) {
-        didOverwriteResponse = true;
-      }
-      response = std::move(handleProcessingGraphCommandResponse);
-    }
+    return isExit;
+  }
 
-    auto handleSequencerCommandResponse = handleSequencerCommand(request);
-    if (handleSequencerCommandResponse.has_value()) {
-      if (response.has_value()) {
-        didOverwriteResponse = true;
-      }
-      response = std::move(handleSequencerCommandResponse);
-    }
+  void replayDeferredRequests() {
+    auto requests = std::move(deferredRequests);
+    deferredRequests.clear();
 
-    // Warn if multiple handlers gave back a reply. This would indicate that a
-    // command is being handled multiple times, which is probably a bug.
+    for (auto& request : requests) {
+      // If one of the deferred requests starts another project load, then
+      // everything after it needs to wait again.
+      if (isProjectLoadInProgress()) {
+        deferredRequests.push_back(std::move(request));
+        continue;
+      }
 
-    if (didOverwriteResponse) {
-      juce::Logger::writeToLog("Warning: Multiple command handlers tried to reply to a single command. Only the last reply will be sent back. This is probably a bug.");
+      handleRequest(request);
     }
+  }
+public:
+  CommandMessageListener() {
+    router.registerHandler<Exit>([](Exit& exit) -> std::optional<Response> {
+      return std::optional(ExitReply {
+        .responseBase = ResponseBase {
+          .id = exit.requestBase.get().id
+        }
+      });
+    });
 
-    if (response.has_value()) {
-      // Serialize the response to a string
-      auto responseStr = rfl::json::write(response.value());
+    router.registerHandler<Heartbeat>([](Heartbeat& heartbeat) -> std::optional<Response> {
+      heartbeatOccurred = true;
 
-      auto receiveBufferPtr = responseStr.c_str();
-      auto bufferSize = responseStr.size();
+      return std::optional(HeartbeatReply {
+        .responseBase = ResponseBase {
+          .id = heartbeat.requestBase.get().id
+        }
+      });
+    });
+
+    router.setResponseSender([this](Response& response) {
+      sendResponse(response);
+    });
 
-      // Write the message length to the socket
-      auto bufferSize64 = static_cast<uint64_t>(bufferSize);
+    registerModelSyncCommandHandlers(router);
+    registerProcessingGraphCommandHandlers(router);
+    registerRenderCommandHandlers(router);
+    registerSequencerCommandHandlers(router);
 
-      // Create an array to hold the bytes of the id
-      unsigned char bufferSizeBytes[sizeof(bufferSize64)];
+    setProjectLoadedCallback([this]() {
+      replayDeferredRequests();
+    });
+  }
 
-      // Copy the bytes of bufferSize64 into bufferSizeBytes
-      std::memcpy(bufferSizeBytes, &bufferSize64, sizeof(bufferSize64));
+  void handleMessage(const juce::Message& message) override {
+    const CommandMessage& command = dynamic_cast<const CommandMessage&>(message);
 
-      std::unique_lock<std::mutex> socketLock(socketInUseMutex);
+    auto request = std::move(command.request);
 
-      socketToUi.write(bufferSizeBytes, sizeof(uint64_t));
+    bool isExit = false;
 
-      // Write the message to the socket
-      socketToUi.write(receiveBufferPtr, bufferSize);
+    // Exit and heartbeat don't touch the project, so they are always handled
+    // right away. Everything else waits if a project is still loading.
+    bool canDefer =
+      !rfl::holds_alternative<Exit>(request.variant()) &&
+      !rfl::holds_alternative<Heartbeat>(request.variant());
 
-      socketLock.unlock();
+    if (canDefer && isProjectLoadInProgress()) {
+      deferredRequests.push_back(std::move(request));
+    }
+    else {
+      isExit = handleRequest(request);
     }
 
     if (isExit) {
@@ -202,16 +224,24 @@ std::thread messageLoopThread;
 void messageLoop(CommandMessageListener& messageListener) {
   auto parameters = juce::JUCEApplication::getCommandLineParameters();
 
-  auto spaceIndex = parameters.indexOfChar(' ');
+  // Flags like --headless can appear anywhere, and are handled when the
+  // application starts. The port and ID are the remaining arguments, in order.
+  juce::StringArray arguments;
+
+  for (auto& token : juce::StringArray::fromTokens(parameters, true)) {
+    if (!token.startsWith("--")) {
+      arguments.add(token);
+    }
+  }
 
-  if (spaceIndex == -1) {
+  if (arguments.size() != 2) {
     std::cerr << "Invalid command line args: " << parameters << " - Exiting..." << std::endl;
     juce::JUCEApplication::quit();
     return;
   }
 
-  auto portStr = parameters.substring(0, spaceIndex);
-  auto idStr = parameters.substring(spaceIndex + 1);
+  auto portStr = arguments[0];
+  auto idStr = arguments[1];
 
   if (portStr.length() == 0) {
     std::cerr << "Port was not provided. Args: " << parameters << " - Exiting..." << std::endl;
@@ -370,6 +400,30 @@ public:
     // Remove this line to disable logging
     juce::Logger::setCurrentLogger(new ConsoleLogger());
 
+    auto arguments = juce::StringArray::fromTokens(commandLineParameters, true);
+
+    // In headless mode, the engine uses a virtual audio device instead of real
+    // hardware, so it can run on machines that don't have any (e.g. CI).
+    bool headless = arguments.contains("--headless");
+
+    // --internal-block-size=<n> makes the graph process fixed-size blocks of
+    // n samples, whatever block size the audio device uses.
+    int internalBlockSize = 0;
+
+    // --lock-memory locks memory that the audio thread uses into RAM, so it
+    // can't be paged out. See AnthemAudioThreadMemory.
+    bool lockMemory = arguments.contains("--lock-memory");
+
+    // --count-page-faults logs page faults taken while processing the graph.
+    // This is for diagnosing clicks, and costs a system call per block.
+    bool countPageFaults = arguments.contains("--count-page-faults");
+
+    for (auto& argument : arguments) {
+      if (argument.startsWith("--internal-block-size=")) {
+        internalBlockSize = argument.fromFirstOccurrenceOf("=", false, false).getIntValue();
+      }
+    }
+
                                 // wow, C++ sure is weird
     const char * anthemSplash = R"V0G0N(
            ,++,
@@ -391,14 +445,39 @@ public:
 
     #ifndef NDEBUG
 
-    juce::Logger::writeToLog("If you want to attach a debugger, you can do it now. Press enter to continue.");
-    std::cin.get();
+    // Nobody is around to press enter in headless mode.
+    if (!headless) {
+      juce::Logger::writeToLog("If you want to attach a debugger, you can do it now. Press enter to continue.");
+      std::cin.get();
+    }
 
     #endif
 
     juce::Logger::writeToLog("Starting Anthem engine...");
     Anthem::getInstance().initialize();
 
+    if (headless) {
+      juce::Logger::writeToLog("Running in headless mode. Audio will not be sent to any hardware device.");
+      Anthem::getInstance().setHeadless(true);
+    }
+
+    if (internalBlockSize > MAX_AUDIO_BUFFER_SIZE) {
+      juce::Logger::writeToLog("Ignoring --internal-block-size, since it's larger than " + juce::String(MAX_AUDIO_BUFFER_SIZE) + ".");
+    } else if (internalBlockSize > 0) {
+      juce::Logger::writeToLog("Processing the graph in blocks of " + juce::String(internalBlockSize) + " samples.");
+      Anthem::getInstance().setInternalBlockSize(internalBlockSize);
+    }
+
+    if (lockMemory) {
+      juce::Logger::writeToLog("Locking audio thread memory.");
+      AnthemAudioThreadMemory::setLockingEnabled(true);
+    }
+
+    if (countPageFaults) {
+      juce::Logger::writeToLog("Counting page faults on the audio thread.");
+      Anthem::getInstance().graphProcessor->setPageFaultCountingEnabled(true);
+    }
+
     // This starts the message loop in a thread. The message loop thread
     // communicates back to the main thread every time it receives a
     // message from the UI, and the main thread takes care of processing
@@ -19,35 +19,98 @@
 
 #include "modules/core/anthem.h"
 
+#include "modules/core/anthem_headless_audio_device.h"
 #include "modules/processing_graph/compiler/anthem_graph_compiler.h"
 
 std::unique_ptr<Anthem> Anthem::instance = nullptr;
 
 Anthem::Anthem() {
   isAudioCallbackRunning = false;
+  isAudioDeviceOpen = false;
+  headless = false;
+  internalBlockSize = 0;
+  compiledProcessingConfig = std::nullopt;
 }
 
 void Anthem::initialize() {
   graphProcessor = std::make_unique<AnthemGraphProcessor>();
   sequenceStore = std::make_unique<AnthemRuntimeSequenceStore>();
+  sequenceStore->registerDeletionTimer();
+
+  graphCompileWorker = std::make_unique<AnthemGraphCompileWorker>(
+    [](AnthemGraphCompilationResult* result) {
+      // The engine may have shut down while this result was on its way here.
+      if (!Anthem::hasInstance()) {
+        result->cleanup();
+        delete result;
+        return;
+      }
+
+      Anthem::getInstance().applyCompilationResult(result);
+    }
+  );
 }
 
 void Anthem::shutdown() {
+  // Stop the compiler and render threads first, so they don't hand us
+  // anything else.
+  graphCompileWorker.reset();
+  offlineRenderer.reset();
+
   if (isAudioCallbackRunning) {
     deviceManager.removeAudioCallback(audioCallback.get());
   }
 }
 
+void Anthem::setHeadless(bool headless) {
+  jassert(!isAudioDeviceOpen);
+
+  this->headless = headless;
+}
+
+void Anthem::setInternalBlockSize(int blockSize) {
+  jassert(!isAudioCallbackRunning);
+
+  if (blockSize < 0 || blockSize > MAX_AUDIO_BUFFER_SIZE) {
+    throw std::runtime_error("Internal block size must be between 0 and " + std::to_string(MAX_AUDIO_BUFFER_SIZE) + ".");
+  }
+
+  this->internalBlockSize = blockSize;
+}
+
+void Anthem::openAudioDevice() {
+  if (isAudioDeviceOpen) {
+    return;
+  }
+
+  if (headless) {
+    // The device manager only creates the platform device types if no types
+    // have been added yet, so this means the headless device is the only one
+    // it will ever look at.
+    this->deviceManager.addAudioDeviceType(std::make_unique<AnthemHeadlessAudioIODeviceType>());
+    this->deviceManager.initialiseWithDefaultDevices(0, 2);
+  } else {
+    // Initialize the audio device manager with 2 input and 2 output channels
+    this->deviceManager.initialiseWithDefaultDevices(2, 2);
+  }
+
+  isAudioDeviceOpen = true;
+}
+
 void Anthem::startAudioCallback() {
   if (isAudioCallbackRunning) {
     std::cout << "Tried to start audio callback when it was already running. This probably doesn't break anything, but it's definitely a bug." << std::endl;
     return;
   }
 
+  if (getMasterOutputProcessor() == nullptr) {
+    std::cout << "Tried to start audio callback, but the project has no master output to play." << std::endl;
+    return;
+  }
+
   audioCallback = std::make_unique<AnthemAudioCallback>(this);
 
-  // Initialize the audio device manager with 2 input and 2 output channels
-  this->deviceManager.initialiseWithDefaultDevices(2, 2);
+  openAudioDevice();
 
   // Set up the audio callback
   this->deviceManager.addAudioCallback(this->audioCallback.get());
@@ -55,8 +118,86 @@ void Anthem::startAudioCallback() {
   isAudioCallbackRunning = true;
 }
 
-void Anthem::compileProcessingGraph() {
-  auto result = AnthemGraphCompiler::compile();
+void Anthem::restartAudioCallback() {
+  if (!isAudioCallbackRunning || offlineRenderer != nullptr) {
+    return;
+  }
+
+  deviceManager.removeAudioCallback(audioCallback.get());
+  deviceManager.addAudioCallback(audioCallback.get());
+}
+
+void Anthem::prepareToPlay(const AnthemProcessingConfig& config) {
+  jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+  if (config == processingConfig) {
+    return;
+  }
+
+  processingConfig = config;
+
+  if (project == nullptr || !compiledProcessingConfig.has_value()) {
+    // Processors are prepared when the graph is first compiled.
+    return;
+  }
+
+  // Nothing is driving the graph processor right now, so we can compile on
+  // this thread and swap the result in directly. This also means the old
+  // graph, which has buffers sized for the old config, is never processed
+  // with a block that is too large for it.
+  try {
+    auto topology = AnthemGraphTopologySnapshot::create(*project, processingConfig, graphProcessor->getEventAllocatorGrowthHighWater());
+    applyCompilationResult(AnthemGraphCompiler::compile(*topology));
+  } catch (const std::runtime_error& e) {
+    juce::Logger::writeToLog("Failed to recompile the processing graph for the new processing config: " + juce::String(e.what()));
+  }
+}
+
+void Anthem::compileProcessingGraph(std::function<void(std::optional<std::string> error)> onComplete) {
+  auto topology = AnthemGraphTopologySnapshot::create(*project, processingConfig, graphProcessor->getEventAllocatorGrowthHighWater());
+
+  graphCompileWorker->requestCompile(
+    std::move(topology),
+    [onComplete = std::move(onComplete)](std::optional<std::string> error) {
+      if (error.has_value() || !Anthem::hasInstance()) {
+        onComplete(error);
+        return;
+      }
+
+      auto& anthem = Anthem::getInstance();
+
+      // If the processing config changed while this was compiling, the result
+      // was dropped. prepareToPlay() usually swaps in a graph for the new
+      // config itself, but it can't if nothing had been compiled yet, or if
+      // its own compile failed. Then the audio thread has no graph for the
+      // current config, so we compile again and report that outcome instead.
+      if (anthem.compiledProcessingConfig != anthem.processingConfig) {
+        if (anthem.project == nullptr || anthem.graphCompileWorker == nullptr) {
+          onComplete("The processing config changed while the processing graph was compiling, and the graph could not be compiled again.");
+          return;
+        }
+
+        anthem.compileProcessingGraph(onComplete);
+        return;
+      }
+
+      onComplete(std::nullopt);
+    }
+  );
+}
+
+void Anthem::applyCompilationResult(AnthemGraphCompilationResult* result) {
+  // If the processing config changed while this was compiling in the
+  // background, then its buffers may be too small for the blocks we're about
+  // to process, so we drop it. compileProcessingGraph() makes sure there's a
+  // graph for the new config afterwards.
+  if (result->processingConfig != processingConfig) {
+    result->cleanup();
+    delete result;
+    return;
+  }
+
+  compiledProcessingConfig = result->processingConfig;
 
   std::cout << "Processing steps: " << result->processContexts.size() << std::endl;
 
@@ -67,5 +208,154 @@ void Anthem::compileProcessingGraph() {
     }
   }
 
+  for (auto& context : result->processContexts) {
+    auto node = context->getGraphNode();
+
+    if (node == nullptr) {
+      continue;
+    }
+
+    node->runtimeContext = std::make_optional(context.get());
+
+    // The contexts were created from a snapshot, and parameter values may have
+    // changed on this thread since then. Those changes went to the old
+    // contexts, so we copy the current values over.
+    for (auto& port : *node->controlInputPorts()) {
+      if (port->parameterValue().has_value()) {
+        context->setParameterValue(port->id(), port->parameterValue().value());
+      }
+    }
+  }
+
   graphProcessor->setProcessingStepsFromMainThread(result);
 }
+
+std::shared_ptr<MasterOutputProcessor> Anthem::getMasterOutputProcessor() {
+  if (project == nullptr) {
+    return nullptr;
+  }
+
+  auto& processingGraph = project->processingGraph();
+  auto& nodes = processingGraph->nodes();
+  auto masterOutputNodeIter = nodes->find(processingGraph->masterOutputNodeId());
+
+  if (masterOutputNodeIter == nodes->end()) {
+    return nullptr;
+  }
+
+  auto processor = masterOutputNodeIter->second->getProcessor();
+
+  if (!processor.has_value()) {
+    return nullptr;
+  }
+
+  return std::static_pointer_cast<MasterOutputProcessor>(processor.value());
+}
+
+void Anthem::renderOffline(AnthemOfflineRenderOptions options, AnthemOfflineRenderer::CompletionCallback onComplete) {
+  if (offlineRenderer != nullptr) {
+    onComplete(AnthemOfflineRenderResult {
+      .success = false,
+      .error = "A render is already in progress.",
+    });
+    return;
+  }
+
+  auto masterOutputProcessor = getMasterOutputProcessor();
+
+  if (masterOutputProcessor == nullptr) {
+    onComplete(AnthemOfflineRenderResult {
+      .success = false,
+      .error = "There is no master output to render from.",
+    });
+    return;
+  }
+
+  if (!compiledProcessingConfig.has_value()) {
+    onComplete(AnthemOfflineRenderResult {
+      .success = false,
+      .error = "The processing graph hasn't been compiled yet.",
+    });
+    return;
+  }
+
+  // Taps are checked here, since the render thread can't read the model. If
+  // a tapped node is removed while the render is running, the rest of its
+  // file is silent.
+  auto& nodes = project->processingGraph()->nodes();
+
+  for (auto& tap : options.taps) {
+    auto nodeIter = nodes->find(tap.nodeId);
+
+    bool hasPort = false;
+
+    if (nodeIter != nodes->end()) {
+      for (auto& port : *nodeIter->second->audioOutputPorts()) {
+        if (port->id() == tap.portId) {
+          hasPort = true;
+          break;
+        }
+      }
+    }
+
+    if (!hasPort) {
+      onComplete(AnthemOfflineRenderResult {
+        .success = false,
+        .error = "Node " + tap.nodeId + " has no audio output port with ID " + std::to_string(tap.portId) + ".",
+      });
+      return;
+    }
+  }
+
+  if (options.blockSize <= 0 || options.blockSize > MAX_AUDIO_BUFFER_SIZE) {
+    onComplete(AnthemOfflineRenderResult {
+      .success = false,
+      .error = "Block size must be between 1 and " + std::to_string(MAX_AUDIO_BUFFER_SIZE) + ".",
+    });
+    return;
+  }
+
+  if (options.sampleRate <= 0.0) {
+    options.sampleRate = processingConfig.sampleRate;
+  }
+
+  if (isAudioCallbackRunning) {
+    // This blocks until the device is done with the callback, so after this,
+    // the render thread is the only thing driving the graph processor.
+    deviceManager.removeAudioCallback(audioCallback.get());
+  }
+
+  // The render may use a different sample rate and block size than the
+  // device, so we prepare for those here, and go back to the device config
+  // when the render is done.
+  processingConfigBeforeRender = processingConfig;
+  prepareToPlay(AnthemProcessingConfig {
+    .sampleRate = options.sampleRate,
+    .maxBlockSize = options.blockSize,
+  });
+
+  offlineRenderer = std::make_unique<AnthemOfflineRenderer>(
+    graphProcessor.get(),
+    std::move(masterOutputProcessor),
+    std::move(options),
+    [onComplete = std::move(onComplete)](AnthemOfflineRenderResult result) {
+      if (Anthem::hasInstance()) {
+        Anthem::getInstance().finishOfflineRender();
+      }
+
+      onComplete(result);
+    }
+  );
+
+  offlineRenderer->start();
+}
+
+void Anthem::finishOfflineRender() {
+  offlineRenderer.reset();
+
+  prepareToPlay(processingConfigBeforeRender);
+
+  if (isAudioCallbackRunning) {
+    deviceManager.addAudioCallback(audioCallback.get());
+  }
+}
@@ -19,22 +19,42 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <iostream>
+#include <optional>
+#include <string>
 
 #include <juce_audio_devices/juce_audio_devices.h>
 
 #include "modules/core/anthem_audio_callback.h"
+#include "modules/core/anthem_processing_config.h"
+#include "modules/processing_graph/compiler/anthem_graph_compile_worker.h"
 #include "modules/processing_graph/runtime/anthem_graph_processor.h"
+#include "modules/processors/master_output.h"
+#include "modules/render/anthem_offline_renderer.h"
 #include "modules/sequencer/runtime/runtime_sequence_store.h"
 
 #include "modules/util/id_generator.h"
 
+#include "model_change_tracker.h"
 #include "project.h"
 
 class Anthem {
 private:
   bool isAudioCallbackRunning;
+  bool isAudioDeviceOpen;
+  bool headless;
+  int internalBlockSize;
+
+  // The sample rate and maximum block size that the graph is currently
+  // prepared for. See prepareToPlay().
+  AnthemProcessingConfig processingConfig;
+
+  // The processing config of the graph the audio thread has now, or nullopt
+  // if no graph has been compiled yet. Before then, there's nothing to
+  // recompile when the processing config changes.
+  std::optional<AnthemProcessingConfig> compiledProcessingConfig;
 
   // Singleton shared pointer instance
   static std::unique_ptr<Anthem> instance;
@@ -43,6 +63,21 @@ private:
 
   std::unique_ptr<AnthemAudioCallback> audioCallback;
 
+  // Hands a finished compilation result to the audio thread. Called on the
+  // message thread by the compile worker. Results for an old processing
+  // config are dropped; see compileProcessingGraph().
+  void applyCompilationResult(AnthemGraphCompilationResult* result);
+
+  // The offline render that is currently running, if any.
+  std::unique_ptr<AnthemOfflineRenderer> offlineRenderer;
+
+  // Cleans up after an offline render and reattaches the audio device.
+  void finishOfflineRender();
+
+  // The processing config from before the current offline render, which is
+  // restored once the render is finished.
+  AnthemProcessingConfig processingConfigBeforeRender;
+
 public:
   // The project model.
   //
@@ -51,6 +86,10 @@ public:
   // the state of the project.
   std::shared_ptr<Project> project;
 
+  // Tracks which parts of the project model have changed, so we can send
+  // incremental updates of the model back to the UI when asked.
+  ModelChangeTracker modelChangeTracker;
+
   // The sequence compiler turns the sequence model from the project into a set
   // of sorted event lists. The compile method on AnthemSequenceCompiler is
   // static, so we don't need an instance of AnthemSequenceCompiler.
@@ -61,7 +100,9 @@ public:
 
   // The graph compiler turns the graph topology from the model into processing
   // steps. The compile method on AnthemGraphCompiler is static, so we don't need
-  // an instance of AnthemGraphCompiler.
+  // an instance of AnthemGraphCompiler, but compilation is run on a background
+  // thread owned by this worker.
+  std::unique_ptr<AnthemGraphCompileWorker> graphCompileWorker;
 
   // The graph processor, which takes the compilation result from the compiler
   // and uses it on the audio thread to process data in the graph
@@ -89,13 +130,87 @@ public:
 
   void shutdown();
 
-  // Sets up the audio callback
+  // Makes the engine use a virtual audio device instead of real hardware. See
+  // AnthemHeadlessAudioIODevice.
+  //
+  // This must be called before the audio device is opened.
+  void setHeadless(bool headless);
+
+  bool isHeadless() {
+    return headless;
+  }
+
+  // Makes the graph always process blocks of the given size, regardless of
+  // the block size of the audio device. See AnthemFixedBlockAdapter.
+  //
+  // 0 turns this off, which is the default. This must be called before the
+  // audio callback is started.
+  void setInternalBlockSize(int blockSize);
+
+  int getInternalBlockSize() {
+    return internalBlockSize;
+  }
+
+  // Opens the default audio device, if it isn't open already.
+  //
+  // This can be called before there is a project, so that the device can be
+  // brought up while the project is still loading.
+  void openAudioDevice();
+
+  // Sets up the audio callback. This requires a loaded project, and will open
+  // the audio device if it isn't open yet.
   void startAudioCallback();
 
-  void compileProcessingGraph();
+  // Prepares the engine to process audio with the given sample rate and
+  // maximum block size.
+  //
+  // Each processor is told about the new config via prepareToPlay(), and the
+  // processing graph is recompiled right away, so that the graph buffers are
+  // sized for the new maximum block size. This does nothing if the config
+  // hasn't changed.
+  //
+  // This must be called on the message thread, and only while nothing is
+  // driving the graph processor - for example, from audioDeviceAboutToStart(),
+  // or while the audio callback is detached.
+  void prepareToPlay(const AnthemProcessingConfig& config);
+
+  const AnthemProcessingConfig& getProcessingConfig() {
+    return processingConfig;
+  }
+
+  // Detaches and reattaches the audio callback, which makes the device call
+  // audioDeviceAboutToStart() again.
+  //
+  // This must be called on the message thread.
+  void restartAudioCallback();
+
+  // Compiles the processing graph in the background and sends the result to
+  // the audio thread.
+  //
+  // This must be called on the message thread. onComplete is called on the
+  // message thread once the new graph has been handed to the audio thread, or
+  // with an error if compilation failed. If another compile is requested
+  // before this one finishes, this one is cancelled, and onComplete is called
+  // when the newer one finishes. If the processing config changes before it
+  // finishes, the graph is compiled again for the new config, and onComplete
+  // is called when that compile finishes.
+  void compileProcessingGraph(std::function<void(std::optional<std::string> error)> onComplete);
+
+  // Gets the processor for the master output node in the project, or nullptr
+  // if there is no project, or it has no master output node.
+  std::shared_ptr<MasterOutputProcessor> getMasterOutputProcessor();
+
+  // Renders the master output to a file, as fast as possible.
+  //
+  // The graph processor can only be driven from one thread at a time, so the
+  // audio device callback is detached until the render is finished. Only one
+  // render can run at a time.
+  //
+  // This must be called on the message thread, and onComplete is called on
+  // the message thread.
+  void renderOffline(AnthemOfflineRenderOptions options, AnthemOfflineRenderer::CompletionCallback onComplete);
 
-  // TODO: These generic config items should be settable, which means they
-  // should live in the actual synced model.
-  static const int SAMPLE_RATE = 44100;
+  // TODO: This should be settable, which means it should live in the actual
+  // synced model.
   static const int NUM_CHANNELS = 2;
 };
@@ -18,16 +18,25 @@
 */
 
 #include "anthem_audio_callback.h"
+
+#include <algorithm>
+
 #include "modules/core/anthem.h"
 
 AnthemAudioCallback::AnthemAudioCallback(Anthem* anthem) {
   this->anthem = anthem;
 
-  auto masterOutputNodeSharedPtr = Anthem::getInstance().project->processingGraph()->nodes()->at(
-    Anthem::getInstance().project->processingGraph()->masterOutputNodeId()
-  );
-  masterOutputProcessorSharedPtr = std::static_pointer_cast<MasterOutputProcessor>(masterOutputNodeSharedPtr->getProcessor().value());
+  masterOutputProcessorSharedPtr = anthem->getMasterOutputProcessor();
   masterOutputProcessor = masterOutputProcessorSharedPtr.get();
+
+  maxBlockSize = anthem->getProcessingConfig().maxBlockSize;
+
+  if (anthem->getInternalBlockSize() > 0) {
+    fixedBlockAdapter = std::make_unique<AnthemFixedBlockAdapter>(
+      anthem->getInternalBlockSize(),
+      masterOutputProcessor->buffer.getNumChannels()
+    );
+  }
 }
 
 void AnthemAudioCallback::audioDeviceIOCallbackWithContext(
@@ -38,27 +47,91 @@ void AnthemAudioCallback::audioDeviceIOCallbackWithContext(
   int numSamples,
   [[maybe_unused]] const juce::AudioIODeviceCallbackContext& context
 ) {
-  jassert(numSamples <= MAX_AUDIO_BUFFER_SIZE);
+  // See modules/util/denormals.h.
+  juce::ScopedNoDenormals noDenormals;
 
-  anthem->graphProcessor->process(numSamples);
+  if (fixedBlockAdapter != nullptr) {
+    fixedBlockAdapter->process(
+      outputChannelData,
+      numOutputChannels,
+      numSamples,
+      [this](int blockSize) -> const juce::AudioSampleBuffer& {
+        anthem->graphProcessor->process(blockSize);
 
-  auto& outputBuffer = masterOutputProcessor->buffer;
-  
-  for (int channel = 0; channel < numOutputChannels; ++channel) {
-    if (outputChannelData[channel] != nullptr) {
-      for (int sample = 0; sample < numSamples; ++sample) {
-        auto sampleValue = outputBuffer.getSample(channel, sample);
-        outputChannelData[channel][sample] = sampleValue;
+        // The adapter copies from the buffer, so the limiter that would
+        // normally run on the way to the device runs here instead.
+        masterOutputProcessor->limitBuffer(blockSize);
+        return masterOutputProcessor->buffer;
+      }
+    );
+
+    return;
+  }
+
+  int position = 0;
+
+  while (position < numSamples) {
+    auto blockSize = std::min(maxBlockSize, numSamples - position);
+
+    // The master output node writes straight into the device buffers.
+    masterOutputProcessor->setDeviceOutput(outputChannelData, numOutputChannels, position);
+
+    anthem->graphProcessor->process(blockSize);
+
+    // If the graph didn't run, the device buffers still hold whatever was in
+    // them before.
+    if (!masterOutputProcessor->hasWrittenDeviceOutput()) {
+      for (int channel = 0; channel < numOutputChannels; ++channel) {
+        if (outputChannelData[channel] != nullptr) {
+          juce::FloatVectorOperations::clear(outputChannelData[channel] + position, blockSize);
+        }
       }
     }
+
+    position += blockSize;
   }
+
+  masterOutputProcessor->clearDeviceOutput();
 }
 
-void AnthemAudioCallback::audioDeviceAboutToStart([[maybe_unused]] juce::AudioIODevice* device) {
-  // this->sampleRate = device->getCurrentSampleRate();
-  // TODO
+void AnthemAudioCallback::audioDeviceAboutToStart(juce::AudioIODevice* device) {
+  // If the engine has an internal block size, the graph only ever sees blocks
+  // of that size. Otherwise, it sees whatever the device gives us, which
+  // should be at most the device's buffer size.
+  auto blockSize = anthem->getInternalBlockSize() > 0
+    ? anthem->getInternalBlockSize()
+    : device->getCurrentBufferSizeSamples();
+
+  AnthemProcessingConfig config {
+    .sampleRate = device->getCurrentSampleRate(),
+    .maxBlockSize = std::clamp(blockSize, 1, MAX_AUDIO_BUFFER_SIZE),
+  };
+
+  // Preparing compiles the graph, which touches the model, so it has to
+  // happen on the message thread. This is the usual case, since we're called
+  // from addAudioCallback(). If the device restarted itself from some other
+  // thread, we keep processing with the old config, which is still valid for
+  // the old graph, and restart the callback from the message thread so that
+  // we get called again there.
+  auto* messageManager = juce::MessageManager::getInstanceWithoutCreating();
+
+  if (messageManager == nullptr || !messageManager->isThisTheMessageThread()) {
+    juce::MessageManager::callAsync([]() {
+      if (Anthem::hasInstance()) {
+        Anthem::getInstance().restartAudioCallback();
+      }
+    });
+    return;
+  }
+
+  anthem->prepareToPlay(config);
+  maxBlockSize = anthem->getProcessingConfig().maxBlockSize;
 }
 
 void AnthemAudioCallback::audioDeviceStopped() {
   // this->currentSample = 0;
+
+  if (fixedBlockAdapter != nullptr) {
+    fixedBlockAdapter->reset();
+  }
 }
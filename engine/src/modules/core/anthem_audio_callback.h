@@ -23,6 +23,7 @@
 
 #include <juce_audio_devices/juce_audio_devices.h>
 
+#include "modules/core/anthem_fixed_block_adapter.h"
 #include "modules/core/constants.h"
 #include "modules/processors/master_output.h"
 
@@ -42,6 +43,16 @@ private:
   // normally stored in a shared_ptr, which we can't use from the audio thread
   // since it's not real-time safe.
   Anthem* anthem;
+
+  // If the engine is set to process in fixed-size blocks, this sits between
+  // the device and the graph. Otherwise, this is nullptr and the graph is
+  // processed with whatever block size the device gives us.
+  std::unique_ptr<AnthemFixedBlockAdapter> fixedBlockAdapter;
+
+  // The largest block that the graph is currently prepared to process. If the
+  // device gives us more than this, we process the graph more than once per
+  // callback.
+  int maxBlockSize;
 public:
   AnthemAudioCallback(Anthem* anthem);
 
@@ -0,0 +1,150 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Lets the graph be processed in blocks of a fixed size, no matter what size
+// of block the audio device asks for.
+//
+// Devices can ask for a different number of samples on every callback, and
+// some ask for odd sizes. Processing the graph in a fixed quantum instead
+// (e.g. 64 samples) keeps the cost of each block stable, keeps buffers at a
+// size that fits in cache, and means processors only ever see one block size.
+//
+// The adapter renders whole quanta as the device asks for samples. If a
+// quantum doesn't fit in what's left of the device buffer, the rest of it is
+// kept in a FIFO and sent at the start of the next callback. Since quanta are
+// rendered on demand rather than ahead of time, this doesn't add any latency.
+//
+// This is used from the audio thread, so nothing here allocates after
+// construction.
+class AnthemFixedBlockAdapter {
+private:
+  int blockSize;
+
+  // Output from the last quantum that hasn't been sent to the device yet.
+  juce::AudioSampleBuffer fifo;
+  int fifoStart = 0;
+  int fifoCount = 0;
+
+  int64_t samplesProcessed = 0;
+
+  static void copyBlock(
+    const juce::AudioSampleBuffer& source,
+    int sourceStart,
+    float* const* destination,
+    int numDestinationChannels,
+    int destinationStart,
+    int numSamples
+  ) {
+    for (int channel = 0; channel < numDestinationChannels; channel++) {
+      if (destination[channel] == nullptr) {
+        continue;
+      }
+
+      if (channel < source.getNumChannels()) {
+        juce::FloatVectorOperations::copy(
+          destination[channel] + destinationStart, source.getReadPointer(channel, sourceStart), numSamples
+        );
+      } else {
+        juce::FloatVectorOperations::clear(destination[channel] + destinationStart, numSamples);
+      }
+    }
+  }
+public:
+  AnthemFixedBlockAdapter(int blockSize, int numChannels)
+    : blockSize(blockSize), fifo(numChannels, blockSize) {
+    jassert(blockSize > 0);
+    fifo.clear();
+  }
+
+  int getBlockSize() {
+    return blockSize;
+  }
+
+  // The number of samples the graph has processed since the adapter was
+  // created or reset. This is always a multiple of the block size.
+  int64_t getSamplesProcessed() {
+    return samplesProcessed;
+  }
+
+  // Fills numSamples of device output.
+  //
+  // processBlock is called once for each quantum that needs to be rendered.
+  // It's given the block size, and must return the buffer that holds the
+  // output for that block. This is a template rather than a std::function so
+  // the call can be inlined, and so nothing is allocated on the audio thread.
+  template<typename ProcessBlock>
+  void process(float* const* output, int numOutputChannels, int numSamples, ProcessBlock&& processBlock) {
+    int written = 0;
+
+    while (written < numSamples) {
+      auto remaining = numSamples - written;
+
+      // Send anything left over from the last quantum first.
+      if (fifoCount > 0) {
+        auto count = std::min(fifoCount, remaining);
+
+        copyBlock(fifo, fifoStart, output, numOutputChannels, written, count);
+
+        fifoStart += count;
+        fifoCount -= count;
+        written += count;
+
+        continue;
+      }
+
+      const juce::AudioSampleBuffer& block = processBlock(blockSize);
+      samplesProcessed += blockSize;
+
+      auto count = std::min(blockSize, remaining);
+
+      copyBlock(block, 0, output, numOutputChannels, written, count);
+      written += count;
+
+      // If the device didn't need the whole quantum, keep the rest for next
+      // time.
+      if (count < blockSize) {
+        for (int channel = 0; channel < fifo.getNumChannels(); channel++) {
+          if (channel < block.getNumChannels()) {
+            fifo.copyFrom(channel, 0, block, channel, count, blockSize - count);
+          } else {
+            fifo.clear(channel, 0, blockSize - count);
+          }
+        }
+
+        fifoStart = 0;
+        fifoCount = blockSize - count;
+      }
+    }
+  }
+
+  // Drops any buffered output. This should be called when the device stops,
+  // so stale audio isn't played when it starts again.
+  void reset() {
+    fifoStart = 0;
+    fifoCount = 0;
+    samplesProcessed = 0;
+  }
+};
@@ -0,0 +1,223 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "anthem_headless_audio_device.h"
+
+#include "modules/core/constants.h"
+
+AnthemHeadlessAudioIODevice::AnthemHeadlessAudioIODevice()
+  : juce::AudioIODevice(deviceName, typeName), juce::Thread("AnthemHeadlessAudio") {}
+
+AnthemHeadlessAudioIODevice::~AnthemHeadlessAudioIODevice() {
+  close();
+}
+
+juce::StringArray AnthemHeadlessAudioIODevice::getOutputChannelNames() {
+  return { "Left", "Right" };
+}
+
+juce::StringArray AnthemHeadlessAudioIODevice::getInputChannelNames() {
+  return {};
+}
+
+juce::Array<double> AnthemHeadlessAudioIODevice::getAvailableSampleRates() {
+  return { 44100.0, 48000.0, 88200.0, 96000.0 };
+}
+
+juce::Array<int> AnthemHeadlessAudioIODevice::getAvailableBufferSizes() {
+  return { 64, 128, 256, 512, 1024, 2048 };
+}
+
+int AnthemHeadlessAudioIODevice::getDefaultBufferSize() {
+  return 512;
+}
+
+juce::String AnthemHeadlessAudioIODevice::open(
+  [[maybe_unused]] const juce::BigInteger& inputChannels,
+  const juce::BigInteger& outputChannels,
+  double sampleRate,
+  int bufferSizeSamples
+) {
+  close();
+
+  this->sampleRate = sampleRate > 0.0 ? sampleRate : DEFAULT_SAMPLE_RATE;
+  this->bufferSize = juce::jlimit(1, MAX_AUDIO_BUFFER_SIZE, bufferSizeSamples > 0 ? bufferSizeSamples : getDefaultBufferSize());
+
+  activeOutputChannels = outputChannels;
+  activeOutputChannels.setRange(2, activeOutputChannels.getHighestBit() + 1, false);
+
+  outputBuffer.setSize(2, bufferSize);
+
+  deviceIsOpen = true;
+
+  return {};
+}
+
+void AnthemHeadlessAudioIODevice::close() {
+  stop();
+  deviceIsOpen = false;
+}
+
+bool AnthemHeadlessAudioIODevice::isOpen() {
+  return deviceIsOpen;
+}
+
+void AnthemHeadlessAudioIODevice::start(juce::AudioIODeviceCallback* newCallback) {
+  if (!deviceIsOpen || newCallback == nullptr) {
+    return;
+  }
+
+  stop();
+
+  newCallback->audioDeviceAboutToStart(this);
+
+  {
+    const juce::ScopedLock lock(callbackLock);
+    callback = newCallback;
+  }
+
+  startThread(juce::Thread::Priority::highest);
+}
+
+void AnthemHeadlessAudioIODevice::stop() {
+  stopThread(2000);
+
+  juce::AudioIODeviceCallback* oldCallback;
+
+  {
+    const juce::ScopedLock lock(callbackLock);
+    oldCallback = callback;
+    callback = nullptr;
+  }
+
+  if (oldCallback != nullptr) {
+    oldCallback->audioDeviceStopped();
+  }
+}
+
+bool AnthemHeadlessAudioIODevice::isPlaying() {
+  return isThreadRunning();
+}
+
+juce::String AnthemHeadlessAudioIODevice::getLastError() {
+  return {};
+}
+
+int AnthemHeadlessAudioIODevice::getCurrentBufferSizeSamples() {
+  return bufferSize;
+}
+
+double AnthemHeadlessAudioIODevice::getCurrentSampleRate() {
+  return sampleRate;
+}
+
+int AnthemHeadlessAudioIODevice::getCurrentBitDepth() {
+  return 32;
+}
+
+juce::BigInteger AnthemHeadlessAudioIODevice::getActiveOutputChannels() const {
+  return activeOutputChannels;
+}
+
+juce::BigInteger AnthemHeadlessAudioIODevice::getActiveInputChannels() const {
+  return {};
+}
+
+int AnthemHeadlessAudioIODevice::getOutputLatencyInSamples() {
+  return 0;
+}
+
+int AnthemHeadlessAudioIODevice::getInputLatencyInSamples() {
+  return 0;
+}
+
+void AnthemHeadlessAudioIODevice::run() {
+  const double blockDurationMs = 1000.0 * bufferSize / sampleRate;
+
+  // We schedule each block relative to when we started, rather than relative
+  // to the last block, so that small timing errors don't accumulate.
+  const double startTimeMs = juce::Time::getMillisecondCounterHiRes();
+  int64_t blocksProcessed = 0;
+
+  while (!threadShouldExit()) {
+    {
+      const juce::ScopedLock lock(callbackLock);
+
+      if (callback != nullptr) {
+        callback->audioDeviceIOCallbackWithContext(
+          nullptr,
+          0,
+          outputBuffer.getArrayOfWritePointers(),
+          outputBuffer.getNumChannels(),
+          bufferSize,
+          {}
+        );
+      }
+    }
+
+    blocksProcessed++;
+
+    auto nextBlockTimeMs = startTimeMs + blocksProcessed * blockDurationMs;
+    auto waitTimeMs = nextBlockTimeMs - juce::Time::getMillisecondCounterHiRes();
+
+    if (waitTimeMs > 0.0) {
+      wait(static_cast<int>(waitTimeMs));
+    }
+  }
+}
+
+AnthemHeadlessAudioIODeviceType::AnthemHeadlessAudioIODeviceType()
+  : juce::AudioIODeviceType(AnthemHeadlessAudioIODevice::typeName) {}
+
+void AnthemHeadlessAudioIODeviceType::scanForDevices() {}
+
+juce::StringArray AnthemHeadlessAudioIODeviceType::getDeviceNames(bool wantInputNames) const {
+  if (wantInputNames) {
+    return {};
+  }
+
+  return { AnthemHeadlessAudioIODevice::deviceName };
+}
+
+int AnthemHeadlessAudioIODeviceType::getDefaultDeviceIndex(bool forInput) const {
+  return forInput ? -1 : 0;
+}
+
+int AnthemHeadlessAudioIODeviceType::getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const {
+  if (asInput || device == nullptr) {
+    return -1;
+  }
+
+  return device->getName() == AnthemHeadlessAudioIODevice::deviceName ? 0 : -1;
+}
+
+bool AnthemHeadlessAudioIODeviceType::hasSeparateInputsAndOutputs() const {
+  return false;
+}
+
+juce::AudioIODevice* AnthemHeadlessAudioIODeviceType::createDevice(
+  const juce::String& outputDeviceName,
+  [[maybe_unused]] const juce::String& inputDeviceName
+) {
+  if (outputDeviceName.isNotEmpty() && outputDeviceName != AnthemHeadlessAudioIODevice::deviceName) {
+    return nullptr;
+  }
+
+  return new AnthemHeadlessAudioIODevice();
+}
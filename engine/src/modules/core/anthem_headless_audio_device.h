@@ -0,0 +1,107 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+// A virtual audio device that doesn't talk to any hardware.
+//
+// This runs the audio callback on its own thread, paced by the high-resolution
+// clock so that blocks are requested at the same rate a real device would ask
+// for them. Output is discarded.
+//
+// This is used when the engine is started with --headless, e.g. on build and
+// render machines that have no audio hardware. Since it's a regular
+// juce::AudioIODevice, everything else in the engine (including IPC) works the
+// same as it does with a real device.
+class AnthemHeadlessAudioIODevice : public juce::AudioIODevice, private juce::Thread {
+public:
+  static constexpr const char* typeName = "Anthem Headless";
+  static constexpr const char* deviceName = "Anthem Headless Output";
+
+  AnthemHeadlessAudioIODevice();
+  ~AnthemHeadlessAudioIODevice() override;
+
+  juce::StringArray getOutputChannelNames() override;
+  juce::StringArray getInputChannelNames() override;
+
+  juce::Array<double> getAvailableSampleRates() override;
+  juce::Array<int> getAvailableBufferSizes() override;
+  int getDefaultBufferSize() override;
+
+  juce::String open(
+    const juce::BigInteger& inputChannels,
+    const juce::BigInteger& outputChannels,
+    double sampleRate,
+    int bufferSizeSamples
+  ) override;
+  void close() override;
+  bool isOpen() override;
+
+  void start(juce::AudioIODeviceCallback* callback) override;
+  void stop() override;
+  bool isPlaying() override;
+
+  juce::String getLastError() override;
+
+  int getCurrentBufferSizeSamples() override;
+  double getCurrentSampleRate() override;
+  int getCurrentBitDepth() override;
+
+  juce::BigInteger getActiveOutputChannels() const override;
+  juce::BigInteger getActiveInputChannels() const override;
+
+  int getOutputLatencyInSamples() override;
+  int getInputLatencyInSamples() override;
+
+private:
+  void run() override;
+
+  bool deviceIsOpen = false;
+
+  double sampleRate = 44100.0;
+  int bufferSize = 512;
+  juce::BigInteger activeOutputChannels;
+
+  juce::AudioBuffer<float> outputBuffer;
+
+  juce::CriticalSection callbackLock;
+  juce::AudioIODeviceCallback* callback = nullptr;
+};
+
+// The device type for AnthemHeadlessAudioIODevice. Registering this with a
+// juce::AudioDeviceManager before it is initialized means the manager will
+// only ever see the headless device.
+class AnthemHeadlessAudioIODeviceType : public juce::AudioIODeviceType {
+public:
+  AnthemHeadlessAudioIODeviceType();
+
+  void scanForDevices() override;
+  juce::StringArray getDeviceNames(bool wantInputNames) const override;
+  int getDefaultDeviceIndex(bool forInput) const override;
+  int getIndexOfDevice(juce::AudioIODevice* device, bool asInput) const override;
+  bool hasSeparateInputsAndOutputs() const override;
+  juce::AudioIODevice* createDevice(
+    const juce::String& outputDeviceName,
+    const juce::String& inputDeviceName
+  ) override;
+};
@@ -0,0 +1,36 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/core/constants.h"
+
+// The settings that the processing graph is prepared for.
+//
+// These come from the audio device when it starts, or from the offline
+// renderer. Processors are given these in prepareToPlay(), and graph buffers
+// are sized to maxBlockSize.
+struct AnthemProcessingConfig {
+  double sampleRate = DEFAULT_SAMPLE_RATE;
+
+  // The most samples that will ever be passed to a single process() call.
+  int maxBlockSize = MAX_AUDIO_BUFFER_SIZE;
+
+  bool operator==(const AnthemProcessingConfig& other) const = default;
+};
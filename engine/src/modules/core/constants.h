@@ -20,8 +20,15 @@
 #pragma once
 
 // Max audio buffer size
+//
+// This is an upper bound. Buffers in the processing graph are sized to the
+// maximum block size of the current device or render, which is usually much
+// smaller. See AnthemProcessingConfig.
 const int MAX_AUDIO_BUFFER_SIZE = 8192;
 
+// The sample rate to use before an audio device has been opened.
+const double DEFAULT_SAMPLE_RATE = 44100.0;
+
 // The default size for an event buffer, in number of events.
 //
 // This is the size of each event buffer when it is first allocated. If the
@@ -34,3 +41,16 @@ const int MAX_AUDIO_BUFFER_SIZE = 8192;
 // needs to send events to another node, or when a node needs to receive events
 // from either the sequencer or another node.
 const int DEFAULT_EVENT_BUFFER_SIZE = 1024;
+
+// When sizing the event allocator for a new graph, the most that event buffers
+// grew in previous graphs is multiplied by this to get the free space to leave
+// for growth.
+const int EVENT_ALLOCATOR_HEADROOM_FACTOR = 2;
+
+// The most breakpoints a control buffer can hold in a single block.
+//
+// Control values usually change a handful of times per block at most, and a
+// parameter being smoothed only needs two breakpoints. Signals that change
+// more often than this are written as audio-rate samples instead. See
+// AnthemControlBuffer.
+const int CONTROL_BUFFER_MAX_BREAKPOINTS = 32;
@@ -0,0 +1,171 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "model_change_tracker.h"
+
+#include <rfl/json.hpp>
+#include <rfl.hpp>
+
+#include <unordered_set>
+
+// Keyed collections in the project that we track per-entry. Each item is the
+// path to the collection; the segment after this path is the map key.
+static const std::vector<std::vector<std::string>> trackedCollections = {
+  {"generators"},
+  {"sequence", "patterns"},
+  {"sequence", "arrangements"},
+  {"processingGraph", "nodes"},
+  {"processingGraph", "connections"},
+};
+
+ModelChangeTracker::ModelChangeTracker() {
+  version = 0;
+  baselineVersion = 0;
+}
+
+void ModelChangeTracker::resetBaseline() {
+  baselineVersion = version;
+  lastChangedVersion.clear();
+  changedPathsByVersion.clear();
+}
+
+void ModelChangeTracker::recordModelReplaced() {
+  version++;
+  resetBaseline();
+}
+
+void ModelChangeTracker::recordUpdate(ModelUpdateRequest& request) {
+  version++;
+
+  auto path = getSubtreePath(request);
+
+  if (path.empty()) {
+    // We don't know what this touched, so the only safe thing to do is to
+    // treat it like a full replacement.
+    resetBaseline();
+    return;
+  }
+
+  auto key = joinPath(path);
+
+  auto lastChangedIter = lastChangedVersion.find(key);
+
+  if (lastChangedIter != lastChangedVersion.end()) {
+    changedPathsByVersion.erase(lastChangedIter->second);
+    lastChangedIter->second = version;
+  }
+  else {
+    if (lastChangedVersion.size() >= maxTrackedSubtrees) {
+      // Forget the oldest change. A client that has seen it has nothing to
+      // lose, but one that hasn't can't be diffed any more.
+      auto oldest = changedPathsByVersion.begin();
+
+      baselineVersion = oldest->first;
+      lastChangedVersion.erase(joinPath(oldest->second));
+      changedPathsByVersion.erase(oldest);
+    }
+
+    lastChangedVersion.emplace(key, version);
+  }
+
+  changedPathsByVersion.emplace(version, std::move(path));
+}
+
+bool ModelChangeTracker::canDiffFrom(uint64_t sinceVersion) {
+  return sinceVersion >= baselineVersion && sinceVersion <= version;
+}
+
+std::vector<std::vector<std::string>> ModelChangeTracker::getChangedSubtrees(uint64_t sinceVersion) {
+  std::vector<std::vector<std::string>> result;
+  std::unordered_set<std::string> changedTopLevelFields;
+
+  auto firstChange = changedPathsByVersion.upper_bound(sinceVersion);
+
+  for (auto iter = firstChange; iter != changedPathsByVersion.end(); iter++) {
+    if (iter->second.size() == 1) {
+      changedTopLevelFields.insert(iter->second[0]);
+    }
+  }
+
+  for (auto iter = firstChange; iter != changedPathsByVersion.end(); iter++) {
+    auto& path = iter->second;
+
+    if (path.size() > 1 && changedTopLevelFields.contains(path[0])) {
+      continue;
+    }
+
+    result.push_back(path);
+  }
+
+  return result;
+}
+
+std::vector<std::string> ModelChangeTracker::getSubtreePath(ModelUpdateRequest& request) {
+  std::vector<std::string> segments;
+
+  for (auto& access : *request.fieldAccesses) {
+    if (access->fieldName.has_value()) {
+      segments.push_back(access->fieldName.value());
+    }
+
+    if (access->serializedMapKey.has_value()) {
+      // Map keys are sent as JSON values. For string keys, this means they
+      // have quotes around them, so we decode them here to match the keys in
+      // the model.
+      auto decoded = rfl::json::read<std::string>(access->serializedMapKey.value());
+      segments.push_back(
+        decoded.error().has_value() ? access->serializedMapKey.value() : decoded.value()
+      );
+    }
+    else if (access->listIndex.has_value()) {
+      segments.push_back(std::to_string(access->listIndex.value()));
+    }
+  }
+
+  if (segments.empty()) {
+    return segments;
+  }
+
+  for (auto& collectionPath : trackedCollections) {
+    // The update must target something inside an entry of the collection, not
+    // the collection itself.
+    if (segments.size() <= collectionPath.size()) {
+      continue;
+    }
+
+    if (std::equal(collectionPath.begin(), collectionPath.end(), segments.begin())) {
+      return std::vector<std::string>(segments.begin(), segments.begin() + collectionPath.size() + 1);
+    }
+  }
+
+  return { segments[0] };
+}
+
+std::string ModelChangeTracker::joinPath(const std::vector<std::string>& path) {
+  std::string result;
+
+  for (size_t i = 0; i < path.size(); i++) {
+    if (i > 0) {
+      result += "/";
+    }
+    result += path[i];
+  }
+
+  return result;
+}
@@ -0,0 +1,104 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "messages/messages.h"
+
+// Keeps track of which parts of the project model have changed, so that the
+// engine can send back just the changed parts of the model instead of the
+// whole thing.
+//
+// Every ModelUpdateRequest bumps the model version. For each update, we figure
+// out which subtree of the project it touched, and remember the version at
+// which that subtree last changed. A client that has seen version N can then
+// ask for everything that changed after N.
+//
+// Subtrees are either a top-level field on the project (e.g. "sequence"), or a
+// single entry in one of the large keyed collections in the project (e.g. one
+// pattern in "sequence/patterns"). Tracking individual entries in these
+// collections means that editing a note only marks one pattern as changed,
+// rather than the entire sequence.
+//
+// Subtree paths are stored as lists of path segments, where each segment is
+// either a field name or a map key.
+//
+// We only remember the last maxTrackedSubtrees subtrees that changed. When a
+// new one would go over that, we forget the one that changed longest ago,
+// and clients that last saw a version from before that change get a full
+// snapshot instead.
+class ModelChangeTracker {
+private:
+  static constexpr size_t maxTrackedSubtrees = 4096;
+
+  uint64_t version;
+
+  // Any client that last saw a version before this one needs a full snapshot,
+  // since we don't know what changed before this point. This is moved forward
+  // whenever the whole model is replaced, and whenever we forget a change.
+  uint64_t baselineVersion;
+
+  // Map of subtree path (joined with '/') to the version at which it was last
+  // changed.
+  std::unordered_map<std::string, uint64_t> lastChangedVersion;
+
+  // The path of each subtree in lastChangedVersion, keyed by the version at
+  // which it last changed. Each version changes at most one subtree, and this
+  // is ordered, so we can find everything that changed after a given version
+  // without looking at anything older.
+  std::map<uint64_t, std::vector<std::string>> changedPathsByVersion;
+
+  // Forgets every change, and moves the baseline up to the current version.
+  void resetBaseline();
+
+  static std::vector<std::string> getSubtreePath(ModelUpdateRequest& request);
+public:
+  ModelChangeTracker();
+
+  // Records that the whole model was replaced, e.g. with ModelInitRequest.
+  // Clients will need a full snapshot after this.
+  void recordModelReplaced();
+
+  // Records a model update. This should be called for every update that is
+  // applied to the model.
+  void recordUpdate(ModelUpdateRequest& request);
+
+  uint64_t getVersion() {
+    return version;
+  }
+
+  // Returns true if a client that last saw the given version can be brought
+  // up to date using the changed subtrees alone.
+  bool canDiffFrom(uint64_t sinceVersion);
+
+  // Returns the paths for all subtrees that changed after the given version.
+  //
+  // If a top-level field is in the result, then none of its descendants will
+  // be, since the top-level field already contains them.
+  std::vector<std::vector<std::string>> getChangedSubtrees(uint64_t sinceVersion);
+
+  // Joins a subtree path into a single string, e.g. "sequence/patterns/abc".
+  static std::string joinPath(const std::vector<std::string>& path);
+};
@@ -23,24 +23,13 @@ void CopyControlBufferAction::execute(int numSamples) {
   auto& sourceBuffer = source->getOutputControlBuffer(sourcePortId);
   auto& destinationBuffer = destination->getInputControlBuffer(destinationPortId);
 
-  // Ensure the buffers have the same number of channels and the same size
-  jassert(sourceBuffer.getNumChannels() == destinationBuffer.getNumChannels());
-  jassert(sourceBuffer.getNumSamples() == destinationBuffer.getNumSamples());
-
-  for (int channel = 0; channel < sourceBuffer.getNumChannels(); ++channel) {
-    for (int sample = 0; sample < numSamples; ++sample) {
-      float sourceSample = sourceBuffer.getSample(channel, sample);
-
-      // Overwrite the destination, unless the source is NaN
-      if (!std::isnan(sourceSample)) {
-        // Scale the incoming value based on the min/max values defined by the
-        // parameter definition
-        auto scaledSample = sourceSample * (maxParameterValue - minParameterValue) + minParameterValue;
-
-        destinationBuffer.setSample(channel, sample, scaledSample);
-      }
-    }
-  }
+  // Scale the incoming value based on the min/max values defined by the
+  // parameter definition. If the source is a list of breakpoints, this just
+  // scales the breakpoints. NaN samples in the source don't overwrite the
+  // destination.
+  destinationBuffer.copyScaledFrom(
+    sourceBuffer, maxParameterValue - minParameterValue, minParameterValue, numSamples
+  );
 }
 
 void CopyControlBufferAction::debugPrint() {
@@ -0,0 +1,62 @@
+/*
+  Copyright (C) 2024 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "merge_note_events_action.h"
+
+#include <iostream>
+
+MergeNoteEventsAction::MergeNoteEventsAction(
+  std::vector<AnthemProcessContext*> sources,
+  std::vector<int32_t> sourcePortIds,
+  AnthemProcessContext* destination,
+  int32_t destinationPortId
+) : sources(std::move(sources)), sourcePortIds(std::move(sourcePortIds)), destination(destination), destinationPortId(destinationPortId) {
+  jassert(this->sources.size() == this->sourcePortIds.size());
+
+  // The buffer objects live as long as their contexts, even if the event
+  // storage inside them is reallocated, so we can look them up once here.
+  for (size_t i = 0; i < this->sources.size(); i++) {
+    sourceBuffers.push_back(this->sources[i]->getOutputNoteEventBuffer(this->sourcePortIds[i]).get());
+  }
+
+  cursors.resize(sourceBuffers.size());
+}
+
+void MergeNoteEventsAction::execute([[maybe_unused]] int numSamples) {
+  auto* destinationBuffer = this->destination->getOwnedInputNoteEventBuffer(this->destinationPortId);
+
+  destinationBuffer->mergeFrom(sourceBuffers, cursors);
+}
+
+void MergeNoteEventsAction::debugPrint() {
+  std::cout << "MergeNoteEventsAction: ";
+
+  for (size_t i = 0; i < this->sources.size(); i++) {
+    if (i > 0) {
+      std::cout << ", ";
+    }
+
+    std::cout << this->sources[i]->getGraphNode()->id();
+  }
+
+  std::cout
+    << " -> "
+    << this->destination->getGraphNode()->id()
+    << std::endl;
+}
@@ -17,25 +17,42 @@
   along with Anthem. If not, see <https://www.gnu.org/licenses/>.
 */
 
+#pragma once
+
+#include <memory>
+#include <vector>
+
 #include "modules/processing_graph/compiler/anthem_process_context.h"
 #include "modules/processing_graph/compiler/actions/clear_buffers_action.h"
 
-class CopyNoteEventsAction : public AnthemGraphCompilerAction {
+// Merges the events from every output port connected to an input port into
+// that input port's buffer, ordered by time.
+//
+// This is only used for input ports with more than one connection. Input
+// ports with a single connection read the source buffer directly (see
+// AnthemProcessContext::setInputNoteEventView()), so they don't need an
+// action at all.
+class MergeNoteEventsAction : public AnthemGraphCompilerAction {
 public:
-  AnthemProcessContext* source;
-  int32_t sourcePortId;
+  std::vector<AnthemProcessContext*> sources;
+  std::vector<int32_t> sourcePortIds;
 
   AnthemProcessContext* destination;
   int32_t destinationPortId;
 
-  CopyNoteEventsAction(
-    AnthemProcessContext* source,
-    int32_t sourcePortId,
+  MergeNoteEventsAction(
+    std::vector<AnthemProcessContext*> sources,
+    std::vector<int32_t> sourcePortIds,
     AnthemProcessContext* destination,
     int32_t destinationPortId
-  ) : source(source), sourcePortId(sourcePortId), destination(destination), destinationPortId(destinationPortId) {}
+  );
 
   void execute(int numSamples) override;
 
   void debugPrint() override;
+
+private:
+  // These are filled in ahead of time, so execute() doesn't allocate.
+  std::vector<const AnthemEventBuffer*> sourceBuffers;
+  std::vector<size_t> cursors;
 };
@@ -21,9 +21,48 @@
 
 #include <iostream>
 
+#include "modules/util/denormals.h"
+
 void ProcessNodeAction::execute(int numSamples) {
   this->processor->process(*this->context, numSamples);
+
+#if JUCE_DEBUG
+  checkForDenormals(numSamples);
+#endif
+}
+
+#if JUCE_DEBUG
+void ProcessNodeAction::checkForDenormals(int numSamples) {
+  if (hasReportedDenormals) {
+    return;
+  }
+
+  auto report = [&](const char* portKind, int32_t portId) {
+    hasReportedDenormals = true;
+
+    // Logging isn't real-time safe, but this only happens once per node, and
+    // only in debug builds.
+    juce::Logger::writeToLog(
+      "Node " + juce::String(nodeId) + " wrote denormals to " + portKind + " output port " + juce::String(portId) +
+      ". This thread may be missing denormal protection - see modules/util/denormals.h."
+    );
+  };
+
+  for (auto& [portId, buffer] : context->getAllOutputAudioBuffers()) {
+    if (AnthemDenormals::containsDenormals(buffer, numSamples)) {
+      report("audio", portId);
+      return;
+    }
+  }
+
+  for (auto& [portId, buffer] : context->getAllOutputControlBuffers()) {
+    if (buffer.containsDenormals(numSamples)) {
+      report("control", portId);
+      return;
+    }
+  }
 }
+#endif
 
 void ProcessNodeAction::debugPrint() {
   std::cout << "ProcessNodeAction for node with ID: " << this->context->getGraphNode()->id() << std::endl;
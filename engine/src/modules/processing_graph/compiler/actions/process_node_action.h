@@ -20,19 +20,33 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "modules/processing_graph/compiler/anthem_process_context.h"
 #include "modules/processing_graph/compiler/actions/anthem_graph_compiler_action.h"
 #include "modules/processing_graph/processor/anthem_processor.h"
 
 class ProcessNodeAction : public AnthemGraphCompilerAction {
+private:
+#if JUCE_DEBUG
+  // We only report the first time this node writes denormals, so the log
+  // isn't flooded on every block.
+  bool hasReportedDenormals = false;
+
+  void checkForDenormals(int numSamples);
+#endif
 public:
   AnthemProcessContext* context;
   AnthemProcessor* processor;
 
+  // The ID of the node, for debug output. The context can only give us the
+  // node on the message thread.
+  std::string nodeId;
+
   void execute(int numSamples) override;
 
-  ProcessNodeAction(AnthemProcessContext* context, AnthemProcessor* processor) : context(context), processor(processor) {}
+  ProcessNodeAction(AnthemProcessContext* context, AnthemProcessor* processor, std::string nodeId)
+    : context(context), processor(processor), nodeId(std::move(nodeId)) {}
 
   void debugPrint() override;
 };
@@ -19,6 +19,8 @@
 
 #include "write_parameters_to_control_inputs_action.h"
 
+#include <cmath>
+
 void WriteParametersToControlInputsAction::execute(int numSamples) {
   auto& parameterValues = processContext->getParameterValues();
   auto& parameterSmoothers = processContext->getParameterSmoothers();
@@ -31,11 +33,28 @@ void WriteParametersToControlInputsAction::execute(int numSamples) {
       smoother->setTargetValue(value);
     }
 
-    for (int j = 0; j < numSamples; j++) {
-      smoother->process(1.0f / sampleRate);
-      auto currentValue = smoother->getCurrentValue();
-      processContext->getInputControlBuffer(id).setSample(0, j, currentValue);
+    auto& buffer = processContext->getInputControlBuffer(id);
+
+    // The smoother moves in a straight line, so rather than writing every
+    // sample, we write where the ramp starts and where it reaches the target.
+    // A parameter that isn't moving is a single breakpoint.
+    //
+    // Each sample gets the value after the smoother has advanced past it, so
+    // the first sample is already one step along the ramp.
+    auto slope = smoother->getRate() / sampleRate;
+    auto rampSamples = static_cast<int>(std::ceil(smoother->getTimeRemaining() * sampleRate)) - 1;
+
+    if (rampSamples <= 0) {
+      buffer.setValue(smoother->getTargetValue());
+    } else {
+      buffer.setValue(smoother->getCurrentValue() + slope, slope);
+
+      if (rampSamples < numSamples) {
+        buffer.addBreakpoint(rampSamples, smoother->getTargetValue());
+      }
     }
+
+    smoother->process(static_cast<float>(numSamples) / sampleRate);
   }
 }
 
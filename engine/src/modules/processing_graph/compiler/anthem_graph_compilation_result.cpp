@@ -19,6 +19,14 @@
 
 #include "anthem_graph_compilation_result.h"
 
+void AnthemGraphCompilationResult::prefault() {
+  // The event allocator's arenas are pre-faulted when they're allocated, so
+  // we only need to deal with the sample buffers here.
+  for (auto& processContext : processContexts) {
+    processContext->prefault();
+  }
+}
+
 void AnthemGraphCompilationResult::cleanup() {
   for (auto& processContext : processContexts) {
     processContext->cleanup();
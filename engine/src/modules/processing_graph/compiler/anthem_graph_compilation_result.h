@@ -20,9 +20,12 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <iostream>
 
+#include "modules/core/anthem_processing_config.h"
 #include "modules/processing_graph/compiler/actions/clear_buffers_action.h"
 #include "modules/processing_graph/compiler/anthem_process_context.h"
 #include "modules/sequencer/events/event.h"
@@ -30,6 +33,10 @@
 // This class is used to represent the result of compiling a processing graph.
 class AnthemGraphCompilationResult {
 public:
+  // The settings this result was compiled for. Buffers in the process
+  // contexts hold processingConfig.maxBlockSize samples.
+  AnthemProcessingConfig processingConfig;
+
   // All actions in a given group can be executed in parallel.
   // 
   // The way these groups are constructed currently is quite naive and no work
@@ -42,6 +49,13 @@ public:
     >
   > actionGroups;
 
+  // One entry per action group. If true, the actions in that group don't
+  // touch any shared state and can be run on separate threads at the same
+  // time. This is true for groups that process nodes, but not for groups
+  // that copy between ports, since several connections can write to the same
+  // input port.
+  std::vector<bool> actionGroupIsParallel;
+
   // This contains all process contexts. These are used in a number of different
   // actions, and are (among other things) provided to processors when process()
   // is called. Since there is no obvious owner, these are owned by the root
@@ -57,6 +71,13 @@ public:
     >
   > processContexts;
 
+  // The process context for each node, keyed by node ID.
+  //
+  // The model nodes can only be read from the message thread, so this lets
+  // other threads (e.g. the offline renderer) find the buffers for a given
+  // node.
+  std::unordered_map<std::string, AnthemProcessContext*> processContextsByNodeId;
+
   // This contains a shared_ptr reference to each graph node that was present
   // when this context was created.
   //
@@ -97,6 +118,12 @@ public:
     >
   > eventAllocator;
 
+  // How much of the event allocator was in use, and how many event buffers
+  // there were, when compilation finished. Anything the allocator hands out
+  // after that is event buffers growing.
+  size_t initialEventAllocatorUsage = 0;
+  size_t initialEventBufferCount = 0;
+
   void debugPrint() {
     juce::Logger::writeToLog("AnthemGraphCompilationResult");
     std::cout << actionGroups.size() << " action groups" << std::endl;
@@ -108,6 +135,11 @@ public:
     }
   }
 
+  // Touches every buffer in the process contexts, so that the audio thread
+  // doesn't take page faults the first time it processes this result. The
+  // compiler calls this before returning the result.
+  void prefault();
+
   // Clean up the compilation result. This must be called before the compilation
   // result is deallocated.
   void cleanup();
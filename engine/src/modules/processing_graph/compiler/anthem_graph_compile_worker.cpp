@@ -0,0 +1,145 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "anthem_graph_compile_worker.h"
+
+#include "anthem_graph_compiler.h"
+
+AnthemGraphCompileWorker::AnthemGraphCompileWorker(ResultHandler resultHandler)
+  : juce::Thread("AnthemGraphCompiler"), resultHandler(std::move(resultHandler)) {
+  startThread();
+}
+
+AnthemGraphCompileWorker::~AnthemGraphCompileWorker() {
+  signalThreadShouldExit();
+  notify();
+
+  // The compiler checks for cancellation between steps, so this should not
+  // take long.
+  stopThread(10000);
+}
+
+void AnthemGraphCompileWorker::requestCompile(
+  std::shared_ptr<const AnthemGraphTopologySnapshot> topology,
+  CompletionCallback onComplete
+) {
+  jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+  std::shared_ptr<const AnthemGraphTopologySnapshot> supersededTopology;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // If there's already a topology waiting, it's out of date now. We swap it
+    // out so that it's released here on the message thread, after the lock is
+    // released.
+    supersededTopology = std::move(pendingTopology);
+    pendingTopology = std::move(topology);
+    pendingCallbacks.push_back(std::move(onComplete));
+
+    requestGeneration++;
+  }
+
+  notify();
+}
+
+void AnthemGraphCompileWorker::releaseOnMessageThread(
+  std::shared_ptr<const AnthemGraphTopologySnapshot> topology,
+  AnthemGraphCompilationResult* result
+) {
+  juce::MessageManager::callAsync([topology = std::move(topology), result]() {
+    if (result != nullptr) {
+      result->cleanup();
+      delete result;
+    }
+  });
+}
+
+void AnthemGraphCompileWorker::run() {
+  while (!threadShouldExit()) {
+    std::shared_ptr<const AnthemGraphTopologySnapshot> topology;
+    std::vector<CompletionCallback> callbacks;
+    uint64_t generation;
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      topology = std::move(pendingTopology);
+      pendingTopology = nullptr;
+
+      callbacks = std::move(pendingCallbacks);
+      pendingCallbacks.clear();
+
+      generation = requestGeneration.load();
+    }
+
+    if (topology == nullptr) {
+      wait(-1);
+      continue;
+    }
+
+    auto isSuperseded = [this, generation]() {
+      return threadShouldExit() || requestGeneration.load() != generation;
+    };
+
+    AnthemGraphCompilationResult* result = nullptr;
+    std::optional<std::string> error = std::nullopt;
+
+    try {
+      result = AnthemGraphCompiler::compile(*topology, isSuperseded);
+    } catch (std::runtime_error& e) {
+      error = std::string(e.what());
+    }
+
+    if (isSuperseded()) {
+      // A newer request came in while we were compiling. Whoever was waiting
+      // on this compile gets the result of the newer one instead.
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        pendingCallbacks.insert(
+          pendingCallbacks.begin(),
+          std::make_move_iterator(callbacks.begin()),
+          std::make_move_iterator(callbacks.end())
+        );
+      }
+
+      releaseOnMessageThread(std::move(topology), result);
+      continue;
+    }
+
+    juce::MessageManager::callAsync(
+      [
+        resultHandler = resultHandler,
+        topology = std::move(topology),
+        callbacks = std::move(callbacks),
+        result,
+        error
+      ]() {
+        if (result != nullptr) {
+          resultHandler(result);
+        }
+
+        for (auto& callback : callbacks) {
+          callback(error);
+        }
+      }
+    );
+  }
+}
@@ -0,0 +1,93 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include "anthem_graph_compilation_result.h"
+#include "anthem_graph_topology_snapshot.h"
+
+// Compiles processing graphs on a background thread.
+//
+// Compiling a large graph can take a while, and if it happens on the message
+// thread, then model updates and heartbeats from the UI are held up until it's
+// done. Instead, the message thread takes a snapshot of the graph topology and
+// hands it to this worker.
+//
+// Only the most recent request matters, since the audio thread only ever wants
+// the latest graph. If a request comes in while another compile is running,
+// the running compile is cancelled, and everyone who was waiting on it is
+// answered when the newer compile finishes instead.
+class AnthemGraphCompileWorker : private juce::Thread {
+public:
+  // Called on the message thread with each successful result. The handler
+  // takes ownership of the result.
+  using ResultHandler = std::function<void(AnthemGraphCompilationResult* result)>;
+
+  // Called on the message thread once the compile for a request is done, after
+  // the result has been handed to the result handler. If the compile failed,
+  // error describes what went wrong.
+  using CompletionCallback = std::function<void(std::optional<std::string> error)>;
+
+  AnthemGraphCompileWorker(ResultHandler resultHandler);
+  ~AnthemGraphCompileWorker() override;
+
+  // Queues a compile of the given topology. This must be called on the
+  // message thread.
+  void requestCompile(
+    std::shared_ptr<const AnthemGraphTopologySnapshot> topology,
+    CompletionCallback onComplete
+  );
+
+private:
+  void run() override;
+
+  // Sends the given objects back to the message thread to be released. The
+  // snapshot and the compilation result both hold references to model nodes,
+  // which must not be destroyed on this thread.
+  static void releaseOnMessageThread(
+    std::shared_ptr<const AnthemGraphTopologySnapshot> topology,
+    AnthemGraphCompilationResult* result
+  );
+
+  ResultHandler resultHandler;
+
+  // Guards pendingTopology and pendingCallbacks.
+  std::mutex mutex;
+
+  // The most recent topology that hasn't been picked up by the worker yet.
+  std::shared_ptr<const AnthemGraphTopologySnapshot> pendingTopology;
+
+  // Callbacks for every request that hasn't been answered yet.
+  std::vector<CompletionCallback> pendingCallbacks;
+
+  // Incremented for each request. The worker uses this to notice that the
+  // compile it's running has been superseded.
+  std::atomic<uint64_t> requestGeneration = 0;
+};
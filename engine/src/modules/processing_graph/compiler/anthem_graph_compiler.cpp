@@ -19,19 +19,27 @@
 
 #include "anthem_graph_compiler.h"
 
-#include "modules/core/anthem.h"
-
 #include "generated/lib/model/model.h"
 
+#include <algorithm>
 #include <iostream>
 
 // See the header file for an overview of the graph processing algorithm. Each
 // step in the algorithm is annotated here.
 
-AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
-  auto& processingGraphModel = Anthem::getInstance().project->processingGraph();
-
+AnthemGraphCompilationResult* AnthemGraphCompiler::compile(
+  const AnthemGraphTopologySnapshot& topology,
+  const std::function<bool()>& shouldCancel
+) {
   AnthemGraphCompilationResult* result = new AnthemGraphCompilationResult();
+  result->processingConfig = topology.processingConfig;
+
+  // Cleans up the partial result if we need to stop early.
+  auto discardResult = [&result]() {
+    result->cleanup();
+    delete result;
+    result = nullptr;
+  };
 
   // We store these in a vector so that when it goes out of scope, the nodes
   // are destroyed. We will store the actual pointers in a set, which improves
@@ -40,55 +48,78 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
 
   std::set<AnthemGraphCompilerNode*> nodesToProcess;
 
-  std::map<Node*, std::shared_ptr<AnthemGraphCompilerNode>> nodeToCompilerNode;
-  std::map<NodeConnection*, std::shared_ptr<AnthemGraphCompilerEdge>> connectionToCompilerEdge;
+  std::map<const AnthemGraphTopologyNode*, std::shared_ptr<AnthemGraphCompilerNode>> nodeToCompilerNode;
+  std::map<const AnthemGraphTopologyConnection*, std::shared_ptr<AnthemGraphCompilerEdge>> connectionToCompilerEdge;
 
   std::cout
     << "\033[32m"
     << "AnthemGraphCompiler::compile(): Compiling graph with "
-    << processingGraphModel->nodes()->size()
-    << (processingGraphModel->nodes()->size() > 1 ? " nodes" : " node")
+    << topology.nodes.size()
+    << (topology.nodes.size() > 1 ? " nodes" : " node")
     << " and "
-    << processingGraphModel->connections()->size()
-    << (processingGraphModel->connections()->size() > 1 ? " connections" : " connection")
+    << topology.connections.size()
+    << (topology.connections.size() > 1 ? " connections" : " connection")
     << "\033[0m"
     << std::endl;
 
+  using EventAllocator = ArenaBufferAllocator<AnthemLiveEvent>;
+
   size_t totalEventPorts = 0;
+  size_t initialEventBufferBytes = 0;
+
+  // Get the total number of event ports in the graph, and the space their
+  // buffers take up.
+  for (auto& [id, node] : topology.nodes) {
+    totalEventPorts += node.midiInputPorts.size();
+    totalEventPorts += node.midiOutputPorts.size();
 
-  // Get the total number of event ports in the graph.
-  for (auto& nodePair : *processingGraphModel->nodes()) {
-    auto& node = nodePair.second;
-    totalEventPorts += node->midiInputPorts()->size();
-    totalEventPorts += node->midiOutputPorts()->size();
+    for (auto* ports : { &node.midiInputPorts, &node.midiOutputPorts }) {
+      for (auto& port : *ports) {
+        initialEventBufferBytes += EventAllocator::getFootprint(port.eventBufferSize);
+      }
+    }
   }
 
-  // Create a buffer allocator for events, and allocate double the size of the
-  // buffer for each port. This is because if any port buffer overflows, it will
-  // reallocate, so we need some free space.
+  // Create a buffer allocator for events. Each port gets a buffer up front,
+  // sized for the most events its node says it will produce in a block (see
+  // AnthemProcessor::getMaxEventsPerBlock()). Processors that don't know can
+  // still overflow their buffers, which will then reallocate, so we need some
+  // free space on top of that.
   //
-  // This is probably way too much free space, but I won't try to tweak it
-  // unless it becomes a problem.
-  result->eventAllocator = 
-    std::make_unique<ArenaBufferAllocator<AnthemLiveEvent>>(
-      totalEventPorts * DEFAULT_EVENT_BUFFER_SIZE * sizeof(AnthemLiveEvent) * 2
-    );
+  // The free space is based on how much event buffers grew in previous graphs,
+  // with some headroom. We always leave enough for one buffer to double in
+  // size, since the new buffer is allocated before the old one is freed.
+  //
+  // The allocator is used on the audio thread, so it isn't allowed to grow.
+  // If it fills up, event buffers stop growing instead.
+  auto eventAllocatorHeadroom = std::max(
+    EventAllocator::getFootprint(DEFAULT_EVENT_BUFFER_SIZE * 2),
+    topology.expectedEventAllocatorGrowth * EVENT_ALLOCATOR_HEADROOM_FACTOR
+  );
+
+  result->eventAllocator = std::make_unique<EventAllocator>(
+    EventAllocator::arenaOverhead + initialEventBufferBytes + eventAllocatorHeadroom,
+    false
+  );
 
   // Create contexts for each node
-  for (auto& pair : *processingGraphModel->nodes()) {
-    auto& node = pair.second;
-
-    auto context = new AnthemProcessContext(node, result->eventAllocator.get());
+  //
+  // Note that we don't set the runtimeContext field on the model nodes here,
+  // since we may not be on the message thread. The caller does this when the
+  // result is applied.
+  for (auto& [id, node] : topology.nodes) {
+    auto context = new AnthemProcessContext(
+      node, result->eventAllocator.get(), topology.processingConfig.maxBlockSize
+    );
     result->processContexts.push_back(std::unique_ptr<AnthemProcessContext>(context));
+    result->processContextsByNodeId[id] = context;
 
-    result->graphNodes.push_back(node);
-
-    auto compilerNode = std::make_shared<AnthemGraphCompilerNode>(node, context);
+    result->graphNodes.push_back(node.node);
 
-    node->runtimeContext = std::make_optional(context);
+    auto compilerNode = std::make_shared<AnthemGraphCompilerNode>(&node, context);
 
     vectorOfNodesToProcess.push_back(compilerNode);
-    nodeToCompilerNode[node.get()] = compilerNode;
+    nodeToCompilerNode[&node] = compilerNode;
     nodesToProcess.insert(compilerNode.get());
   }
 
@@ -96,7 +127,7 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
   std::cout << std::endl;
 
   for (auto& node : vectorOfNodesToProcess) {
-    node->assignEdges(nodeToCompilerNode, connectionToCompilerEdge);
+    node->assignEdges(topology, nodeToCompilerNode, connectionToCompilerEdge);
   }
 
   std::unique_ptr<std::vector<std::unique_ptr<AnthemGraphCompilerAction>>> actions =
@@ -129,6 +160,7 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
   }
 
   result->actionGroups.push_back(std::move(actions));
+  result->actionGroupIsParallel.push_back(true);
 
   actions = std::make_unique<std::vector<std::unique_ptr<AnthemGraphCompilerAction>>>();
 
@@ -142,6 +174,10 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
   // connection to a given contorl input, then the value from that connection
   // will overwrite the parameter value in a future step.
   //
+  // This is cheap for parameters that aren't moving, since those are written
+  // as a single breakpoint rather than a value per sample. See
+  // AnthemControlBuffer.
+  //
   // We don't skip this step for control input ports that have attached inputs,
   // though we probably could. It's not necessarily trivial to skip though,
   // because the control value is smoothed in this step, and not processing the
@@ -149,11 +185,14 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
 
   for (auto& node : nodesToProcess) {
     actions->push_back(
-      std::make_unique<WriteParametersToControlInputsAction>(node->context, 44100.0f)
+      std::make_unique<WriteParametersToControlInputsAction>(
+        node->context, static_cast<float>(topology.processingConfig.sampleRate)
+      )
     );
   }
 
   result->actionGroups.push_back(std::move(actions));
+  result->actionGroupIsParallel.push_back(true);
 
   actions = std::make_unique<std::vector<std::unique_ptr<AnthemGraphCompilerAction>>>();
 
@@ -179,6 +218,14 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
   int j = 0;
 
   while (!nodesToProcess.empty()) {
+    // If a newer compile has been requested, this result will never be used,
+    // so we stop here instead of finishing the work.
+    if (shouldCancel && shouldCancel()) {
+      juce::Logger::writeToLog("Graph compilation was cancelled.");
+      discardResult();
+      return nullptr;
+    }
+
     j++;
     juce::Logger::writeToLog("\033[32mLoop iteration " + std::to_string(j) + "\033[0m");
     std::cout << "Nodes still left to process: " << std::to_string(nodesToProcess.size()) << std::endl;
@@ -189,6 +236,7 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
     // engine from being shut down. Since the engine is hidden from the user, we
     // shouldn't risk this.
     if (lastSize == nodesToProcess.size()) {
+      discardResult();
       throw std::runtime_error("Infinite loop detected in graph compiler");
     }
 
@@ -201,24 +249,25 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
     // Step 3: Process nodes that are ready to process
     for (auto& node : nodesToProcess) {
       if (node->readyToProcess) {
-        std::cout << "Processing node " << node->node->id() << std::endl;
+        std::cout << "Processing node " << node->node->id << std::endl;
 
         nodesToRemoveFromProcessing.push_back(node);
         i++;
 
-        auto processor = node->node->getProcessor();
-        if (!processor.has_value()) {
-          std::cout << "Error: Node " << node->node->id() << " has no processor." << std::endl;
+        auto& processor = node->node->processor;
+        if (!processor) {
+          std::cout << "Error: Node " << node->node->id << " has no processor." << std::endl;
           continue;
         }
 
-        actions->push_back(std::make_unique<ProcessNodeAction>(node->context, processor.value().get()));
+        actions->push_back(std::make_unique<ProcessNodeAction>(node->context, processor.get(), node->node->id));
       }
     }
 
     juce::Logger::writeToLog("Step 3: Added process actions for " + std::to_string(i) + " nodes");
 
     result->actionGroups.push_back(std::move(actions));
+    result->actionGroupIsParallel.push_back(true);
 
     actions = std::make_unique<std::vector<std::unique_ptr<AnthemGraphCompilerAction>>>();
 
@@ -240,59 +289,93 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
     // Step 4: Process connections
     for (auto& node : nodesToRemoveFromProcessing) {
       for (auto& edge : node->outputEdges) {
-        auto& sourceNodeId = edge->edgeSource->sourceNodeId();
-        auto& destinationNodeId = edge->edgeSource->destinationNodeId();
-        auto& sourcePortId = edge->edgeSource->sourcePortId();
-        auto& destinationPortId = edge->edgeSource->destinationPortId();
-
-        auto& sourceNode = processingGraphModel->nodes()->at(sourceNodeId);
-        auto& destinationNode = processingGraphModel->nodes()->at(destinationNodeId);
+        auto& sourceNode = topology.nodes.at(edge->edgeSource->sourceNodeId);
+        auto& destinationNode = topology.nodes.at(edge->edgeSource->destinationNodeId);
 
-        auto sourcePortResult = sourceNode->getPortById(sourcePortId);
-        auto destinationPortResult = destinationNode->getPortById(destinationPortId);
+        auto sourcePort = sourceNode.getPortById(edge->edgeSource->sourcePortId);
+        auto destinationPort = destinationNode.getPortById(edge->edgeSource->destinationPortId);
 
-        if (!sourcePortResult.has_value() || !destinationPortResult.has_value()) {
+        if (sourcePort == nullptr || destinationPort == nullptr) {
           std::cout << "Error: Could not find source or destination port" << std::endl;
           continue;
         }
 
-        auto& sourcePort = sourcePortResult.value();
-        auto& destinationPort = destinationPortResult.value();
-
         switch (edge->type) {
           case NodePortDataType::audio:
             actions->push_back(
               std::make_unique<CopyAudioBufferAction>(
                 edge->sourceNodeContext,
-                sourcePort->id(),
+                sourcePort->id,
                 edge->destinationNodeContext,
-                destinationPort->id()
+                destinationPort->id
               )
             );
             break;
-          case NodePortDataType::midi:
+          case NodePortDataType::midi: {
+            // Find every connection to this input port. There's usually only
+            // one, in which case the input can read the source's buffer
+            // directly.
+            auto& destinationCompilerNode = nodeToCompilerNode.at(&destinationNode);
+
+            std::vector<AnthemGraphCompilerEdge*> edgesToPort;
+            bool otherEdgesProcessed = true;
+
+            for (auto& inputEdge : destinationCompilerNode->inputEdges) {
+              if (inputEdge->type != NodePortDataType::midi ||
+                  inputEdge->edgeSource->destinationPortId != destinationPort->id) {
+                continue;
+              }
+
+              edgesToPort.push_back(inputEdge.get());
+
+              if (inputEdge.get() != edge.get() && !inputEdge->processed) {
+                otherEdgesProcessed = false;
+              }
+            }
+
+            if (edgesToPort.size() <= 1) {
+              edge->destinationNodeContext->setInputNoteEventView(
+                destinationPort->id,
+                edge->sourceNodeContext->getOutputNoteEventBuffer(sourcePort->id).get()
+              );
+              break;
+            }
+
+            // Otherwise, we wait until all the sources for this port are ready,
+            // and then merge them all at once so the events stay in order.
+            if (!otherEdgesProcessed) {
+              break;
+            }
+
+            std::vector<AnthemProcessContext*> sourceContexts;
+            std::vector<int32_t> sourcePortIds;
+
+            for (auto* edgeToPort : edgesToPort) {
+              sourceContexts.push_back(edgeToPort->sourceNodeContext);
+              sourcePortIds.push_back(edgeToPort->edgeSource->sourcePortId);
+            }
+
             actions->push_back(
-              std::make_unique<CopyNoteEventsAction>(
-                edge->sourceNodeContext,
-                sourcePort->id(),
+              std::make_unique<MergeNoteEventsAction>(
+                std::move(sourceContexts),
+                std::move(sourcePortIds),
                 edge->destinationNodeContext,
-                destinationPort->id()
+                destinationPort->id
               )
             );
             break;
+          }
           case NodePortDataType::control:
-            auto& portParameterConfig = sourcePort->config()->parameterConfig().value();
-            auto minParameterValue = (float) portParameterConfig->minimumValue();
-            auto maxParameterValue = (float) portParameterConfig->maximumValue();
+            jassert(sourcePort->hasParameterConfig);
 
             actions->push_back(
               std::make_unique<CopyControlBufferAction>(
                 edge->sourceNodeContext,
-                sourcePort->id(),
+                sourcePort->id,
                 edge->destinationNodeContext,
-                destinationPort->id(),
-                minParameterValue,
-                maxParameterValue
+                destinationPort->id,
+                sourcePort->minimumValue,
+                sourcePort->maximumValue
               )
             );
             break;
@@ -307,6 +390,7 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
     std::cout << std::endl;
 
     result->actionGroups.push_back(std::move(actions));
+    result->actionGroupIsParallel.push_back(false);
 
     actions = std::make_unique<std::vector<std::unique_ptr<AnthemGraphCompilerAction>>>();
 
@@ -317,13 +401,13 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
     for (auto& node : nodesToProcess) {
       bool allInputsProcessed = true;
 
-      std::cout << "Checking node " << node->node->id() << std::endl;
+      std::cout << "Checking node " << node->node->id << std::endl;
 
       for (auto& edge : node->inputEdges) {
         if (!edge->processed) {
           std::cout << "\033[34m";
           std::cout << "Found unprocessed edge with pointer " << std::hex << edge.get() << std::dec << std::endl;
-          std::cout << "This compiler edge represents a real edge with pointer " << std::hex << edge->edgeSource.get() << std::dec << std::endl;
+          std::cout << "This compiler edge represents the connection with ID " << edge->edgeSource->id << std::endl;
           std::cout << "\033[0m";
           allInputsProcessed = false;
           break;
@@ -342,5 +426,15 @@ AnthemGraphCompilationResult* AnthemGraphCompiler::compile() {
     std::cout << std::endl;
   }
 
+  // Anything the allocator has to hand out beyond this is growth, which the
+  // graph processor tracks to size the next graph's allocator.
+  result->initialEventAllocatorUsage = result->eventAllocator->getStats().used;
+  result->initialEventBufferCount = totalEventPorts;
+
+  // This runs on the compile thread, so the page faults for all the new
+  // buffers happen here rather than in the first few blocks on the audio
+  // thread.
+  result->prefault();
+
   return result;
 }
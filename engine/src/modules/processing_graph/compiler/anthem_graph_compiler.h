@@ -31,6 +31,11 @@
      from the source port to the destination port. This must be done in a single
      thread in series, because if multiple connections are copying to the same
      port, two threads cannot be copying the data at the same time.
+
+     Event connections are the exception. An event input with one connection
+     reads the source buffer directly, so there's nothing to copy. An event
+     input with several connections gets a single action that merges all of
+     its sources by time, once the last of them is ready.
   5. Find all nodes whose incoming connections are all marked as processed. Mark
      these as ready to process.
   6. Repeat steps 3-5 until all nodes are marked as processed.
@@ -38,6 +43,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "modules/core/constants.h"
@@ -49,17 +55,26 @@
 
 #include "anthem_graph_compilation_result.h"
 #include "anthem_graph_compiler_node.h"
+#include "anthem_graph_topology_snapshot.h"
 
 #include "actions/clear_buffers_action.h"
 #include "actions/process_node_action.h"
 #include "actions/copy_audio_buffer_action.h"
 #include "actions/copy_control_buffer_action.h"
 #include "actions/write_parameters_to_control_inputs_action.h"
-#include "actions/copy_note_events_action.h"
+#include "actions/merge_note_events_action.h"
 
 // This class is used to compile a processing graph into a set of processing
 // instructions that can be executed in a real-time context.
 class AnthemGraphCompiler {
 public:
-  static AnthemGraphCompilationResult* compile();
+  // Compiles the given topology. This only reads from the snapshot, so it can
+  // be called from any thread.
+  //
+  // The compiler checks shouldCancel periodically, and if it returns true, the
+  // compilation is abandoned and this returns nullptr.
+  static AnthemGraphCompilationResult* compile(
+    const AnthemGraphTopologySnapshot& topology,
+    const std::function<bool()>& shouldCancel = {}
+  );
 };
@@ -22,14 +22,15 @@
 #include <memory>
 
 #include "generated/lib/model/model.h"
-#include "modules/processing_graph/model/node_connection.h"
+#include "modules/processing_graph/compiler/anthem_graph_topology_snapshot.h"
 
-class AnthemGraphNodeConnection;
+class AnthemProcessContext;
 
 class AnthemGraphCompilerEdge {
 public:
-  // The edge in the node graph
-  std::shared_ptr<NodeConnection> edgeSource;
+  // The edge in the node graph. This points into the topology snapshot that
+  // is being compiled.
+  const AnthemGraphTopologyConnection* edgeSource;
 
   AnthemProcessContext* sourceNodeContext;
 
@@ -42,7 +43,7 @@ public:
   bool processed = false;
 
   AnthemGraphCompilerEdge(
-    std::shared_ptr<NodeConnection> edge,
+    const AnthemGraphTopologyConnection* edge,
     AnthemProcessContext* sourceNodeContext,
     AnthemProcessContext* destinationNodeContext,
     NodePortDataType type
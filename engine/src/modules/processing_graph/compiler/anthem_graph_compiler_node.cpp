@@ -18,87 +18,68 @@
 */
 
 #include "anthem_graph_compiler_node.h"
-#include "modules/core/anthem.h"
 
 void AnthemGraphCompilerNode::assignEdges(
-  std::map<Node*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
-  std::map<NodeConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge
+  const AnthemGraphTopologySnapshot& topology,
+  std::map<const AnthemGraphTopologyNode*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
+  std::map<const AnthemGraphTopologyConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge
 ) {
-  for (auto& port : *node->audioInputPorts()) {
-    for (auto& connectionId : *port->connections()) {
-      auto& connection = Anthem::getInstance().project->processingGraph()->connections()->at(connectionId);
-      assignEdge(nodeToCompilerNode, connectionToCompilerEdge, inputEdges, connection);
-    }
-  }
-
-  for (auto& port : *node->controlInputPorts()) {
-    for (auto& connectionId : *port->connections()) {
-      auto& connection = Anthem::getInstance().project->processingGraph()->connections()->at(connectionId);
-      assignEdge(nodeToCompilerNode, connectionToCompilerEdge, inputEdges, connection);
-    }
-  }
-
-  for (auto& port : *node->midiInputPorts()) {
-    for (auto& connectionId : *port->connections()) {
-      auto& connection = Anthem::getInstance().project->processingGraph()->connections()->at(connectionId);
-      assignEdge(nodeToCompilerNode, connectionToCompilerEdge, inputEdges, connection);
-    }
-  }
+  assignEdgesForPorts(topology, nodeToCompilerNode, connectionToCompilerEdge, inputEdges, node->audioInputPorts);
+  assignEdgesForPorts(topology, nodeToCompilerNode, connectionToCompilerEdge, inputEdges, node->controlInputPorts);
+  assignEdgesForPorts(topology, nodeToCompilerNode, connectionToCompilerEdge, inputEdges, node->midiInputPorts);
 
-  for (auto& port : *node->audioOutputPorts()) {
-    for (auto& connectionId : *port->connections()) {
-      auto& connection = Anthem::getInstance().project->processingGraph()->connections()->at(connectionId);
-      assignEdge(nodeToCompilerNode, connectionToCompilerEdge, outputEdges, connection);
-    }
-  }
-
-  for (auto& port : *node->controlOutputPorts()) {
-    for (auto& connectionId : *port->connections()) {
-      auto& connection = Anthem::getInstance().project->processingGraph()->connections()->at(connectionId);
-      assignEdge(nodeToCompilerNode, connectionToCompilerEdge, outputEdges, connection);
-    }
-  }
+  assignEdgesForPorts(topology, nodeToCompilerNode, connectionToCompilerEdge, outputEdges, node->audioOutputPorts);
+  assignEdgesForPorts(topology, nodeToCompilerNode, connectionToCompilerEdge, outputEdges, node->controlOutputPorts);
+  assignEdgesForPorts(topology, nodeToCompilerNode, connectionToCompilerEdge, outputEdges, node->midiOutputPorts);
+}
 
-  for (auto& port : *node->midiOutputPorts()) {
-    for (auto& connectionId : *port->connections()) {
-      auto& connection = Anthem::getInstance().project->processingGraph()->connections()->at(connectionId);
-      assignEdge(nodeToCompilerNode, connectionToCompilerEdge, outputEdges, connection);
+void AnthemGraphCompilerNode::assignEdgesForPorts(
+  const AnthemGraphTopologySnapshot& topology,
+  std::map<const AnthemGraphTopologyNode*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
+  std::map<const AnthemGraphTopologyConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge,
+  std::vector<std::shared_ptr<AnthemGraphCompilerEdge>>& edgeContainer,
+  const std::vector<AnthemGraphTopologyPort>& ports
+) {
+  for (auto& port : ports) {
+    for (auto& connectionId : port.connectionIds) {
+      auto& connection = topology.connections.at(connectionId);
+      assignEdge(topology, nodeToCompilerNode, connectionToCompilerEdge, edgeContainer, connection);
     }
   }
 }
 
 void AnthemGraphCompilerNode::assignEdge(
-  std::map<Node*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
-  std::map<NodeConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge,
+  const AnthemGraphTopologySnapshot& topology,
+  std::map<const AnthemGraphTopologyNode*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
+  std::map<const AnthemGraphTopologyConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge,
   std::vector<std::shared_ptr<AnthemGraphCompilerEdge>>& edgeContainer,
-  std::shared_ptr<NodeConnection>& connection
+  const AnthemGraphTopologyConnection& connection
 ) {
-  auto& sourceNode = Anthem::getInstance().project->processingGraph()->nodes()->at(connection->sourceNodeId());
-  auto& destinationNode = Anthem::getInstance().project->processingGraph()->nodes()->at(connection->destinationNodeId());
+  auto& sourceNode = topology.nodes.at(connection.sourceNodeId);
+  auto& destinationNode = topology.nodes.at(connection.destinationNodeId);
 
-  auto sourceNodePort = sourceNode->getPortById(connection->sourcePortId());
-  auto destinationNodePort = destinationNode->getPortById(connection->destinationPortId());
+  auto sourceNodePort = sourceNode.getPortById(connection.sourcePortId);
 
-  auto& sourceCompilerNode = nodeToCompilerNode[sourceNode.get()];
-  auto& destinationCompilerNode = nodeToCompilerNode[destinationNode.get()];
+  auto& sourceCompilerNode = nodeToCompilerNode[&sourceNode];
+  auto& destinationCompilerNode = nodeToCompilerNode[&destinationNode];
 
   auto sourceNodeContext = sourceCompilerNode->context;
   auto destinationNodeContext = destinationCompilerNode->context;
 
-  auto portType = sourceNodePort.value()->config()->dataType();
+  auto portType = sourceNodePort->dataType;
 
   // If we've already created a compiler edge for this connection, use it
-  if (connectionToCompilerEdge.find(connection.get()) != connectionToCompilerEdge.end()) {
-    edgeContainer.push_back(connectionToCompilerEdge[connection.get()]);
+  if (connectionToCompilerEdge.find(&connection) != connectionToCompilerEdge.end()) {
+    edgeContainer.push_back(connectionToCompilerEdge[&connection]);
   } else {
     auto edge = std::make_shared<AnthemGraphCompilerEdge>(
-      connection,
+      &connection,
       sourceNodeContext,
       destinationNodeContext,
       portType
     );
 
-    connectionToCompilerEdge[connection.get()] = edge;
+    connectionToCompilerEdge[&connection] = edge;
 
     edgeContainer.push_back(edge);
   }
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "modules/processing_graph/compiler/anthem_graph_compiler_edge.h"
+#include "modules/processing_graph/compiler/anthem_graph_topology_snapshot.h"
 
 #include "generated/lib/model/model.h"
 
@@ -34,8 +35,9 @@ class AnthemProcessContext;
 // track of details about nodes being processed.
 class AnthemGraphCompilerNode {
 public:
-  // The node that this compiled node represents
-  std::shared_ptr<Node> node;
+  // The node that this compiled node represents. This points into the
+  // topology snapshot that is being compiled.
+  const AnthemGraphTopologyNode* node;
 
   std::vector<std::shared_ptr<AnthemGraphCompilerEdge>> inputEdges;
   std::vector<std::shared_ptr<AnthemGraphCompilerEdge>> outputEdges;
@@ -46,18 +48,28 @@ public:
   // Whether this node is ready to process
   bool readyToProcess = false;
 
-  AnthemGraphCompilerNode(std::shared_ptr<Node> node, AnthemProcessContext* context) : node(node), context(context) {}
+  AnthemGraphCompilerNode(const AnthemGraphTopologyNode* node, AnthemProcessContext* context) : node(node), context(context) {}
 
   // Populate the input and output edges for this node
   void assignEdges(
-    std::map<Node*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
-    std::map<NodeConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge
+    const AnthemGraphTopologySnapshot& topology,
+    std::map<const AnthemGraphTopologyNode*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
+    std::map<const AnthemGraphTopologyConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge
   );
 private:
+  void assignEdgesForPorts(
+    const AnthemGraphTopologySnapshot& topology,
+    std::map<const AnthemGraphTopologyNode*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
+    std::map<const AnthemGraphTopologyConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge,
+    std::vector<std::shared_ptr<AnthemGraphCompilerEdge>>& edgeContainer,
+    const std::vector<AnthemGraphTopologyPort>& ports
+  );
+
   void assignEdge(
-    std::map<Node*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
-    std::map<NodeConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge,
+    const AnthemGraphTopologySnapshot& topology,
+    std::map<const AnthemGraphTopologyNode*, std::shared_ptr<AnthemGraphCompilerNode>>& nodeToCompilerNode,
+    std::map<const AnthemGraphTopologyConnection*, std::shared_ptr<AnthemGraphCompilerEdge>>& connectionToCompilerEdge,
     std::vector<std::shared_ptr<AnthemGraphCompilerEdge>>& edgeContainer,
-    std::shared_ptr<NodeConnection>& connection
+    const AnthemGraphTopologyConnection& connection
   );
 };
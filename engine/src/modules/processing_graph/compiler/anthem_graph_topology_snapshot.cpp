@@ -0,0 +1,163 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "anthem_graph_topology_snapshot.h"
+
+#include <algorithm>
+
+#include <juce_events/juce_events.h>
+
+static void copyPorts(
+  std::vector<AnthemGraphTopologyPort>& destination,
+  AnthemModelVector<std::shared_ptr<NodePort>>& ports
+) {
+  destination.reserve(ports.size());
+
+  for (auto& port : ports) {
+    AnthemGraphTopologyPort portCopy {
+      .id = static_cast<int32_t>(port->id()),
+      .dataType = port->config()->dataType(),
+    };
+
+    for (auto& connectionId : *port->connections()) {
+      portCopy.connectionIds.push_back(connectionId);
+    }
+
+    auto& parameterConfig = port->config()->parameterConfig();
+
+    if (parameterConfig.has_value()) {
+      portCopy.hasParameterConfig = true;
+      portCopy.parameterValue = static_cast<float>(port->parameterValue().value_or(0.0));
+      portCopy.minimumValue = static_cast<float>(parameterConfig.value()->minimumValue());
+      portCopy.maximumValue = static_cast<float>(parameterConfig.value()->maximumValue());
+      portCopy.smoothingDurationSeconds = parameterConfig.value()->smoothingDurationSeconds();
+    }
+
+    destination.push_back(std::move(portCopy));
+  }
+}
+
+const AnthemGraphTopologyPort* AnthemGraphTopologyNode::getPortById(int32_t id) const {
+  for (auto* ports : {
+    &audioInputPorts,
+    &audioOutputPorts,
+    &controlInputPorts,
+    &controlOutputPorts,
+    &midiInputPorts,
+    &midiOutputPorts,
+  }) {
+    for (auto& port : *ports) {
+      if (port.id == id) {
+        return &port;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+std::shared_ptr<const AnthemGraphTopologySnapshot> AnthemGraphTopologySnapshot::create(
+  Project& project,
+  const AnthemProcessingConfig& processingConfig,
+  size_t expectedEventAllocatorGrowth
+) {
+  jassert(juce::MessageManager::getInstance()->isThisTheMessageThread());
+
+  auto snapshot = std::make_shared<AnthemGraphTopologySnapshot>();
+  snapshot->processingConfig = processingConfig;
+  snapshot->expectedEventAllocatorGrowth = expectedEventAllocatorGrowth;
+
+  auto& processingGraphModel = project.processingGraph();
+
+  for (auto& [id, node] : *processingGraphModel->nodes()) {
+    AnthemGraphTopologyNode nodeCopy {
+      .id = id,
+      .node = node,
+      .processor = node->getProcessor().value_or(nullptr),
+    };
+
+    if (nodeCopy.processor != nullptr) {
+      nodeCopy.processor->prepareIfNeeded(processingConfig);
+    }
+
+    copyPorts(nodeCopy.audioInputPorts, *node->audioInputPorts());
+    copyPorts(nodeCopy.audioOutputPorts, *node->audioOutputPorts());
+    copyPorts(nodeCopy.controlInputPorts, *node->controlInputPorts());
+    copyPorts(nodeCopy.controlOutputPorts, *node->controlOutputPorts());
+    copyPorts(nodeCopy.midiInputPorts, *node->midiInputPorts());
+    copyPorts(nodeCopy.midiOutputPorts, *node->midiOutputPorts());
+
+    for (auto& port : nodeCopy.midiOutputPorts) {
+      port.eventBufferSize = nodeCopy.processor != nullptr
+        ? nodeCopy.processor->getMaxEventsPerBlock(port.id, processingConfig.maxBlockSize)
+        : DEFAULT_EVENT_BUFFER_SIZE;
+    }
+
+    snapshot->nodes.emplace(id, std::move(nodeCopy));
+  }
+
+  for (auto& [id, connection] : *processingGraphModel->connections()) {
+    snapshot->connections.emplace(id, AnthemGraphTopologyConnection {
+      .id = id,
+      .sourceNodeId = connection->sourceNodeId(),
+      .sourcePortId = static_cast<int32_t>(connection->sourcePortId()),
+      .destinationNodeId = connection->destinationNodeId(),
+      .destinationPortId = static_cast<int32_t>(connection->destinationPortId()),
+    });
+  }
+
+  snapshot->planEventInputBufferSizes();
+
+  return snapshot;
+}
+
+void AnthemGraphTopologySnapshot::planEventInputBufferSizes() {
+  for (auto& [id, node] : nodes) {
+    for (auto& port : node.midiInputPorts) {
+      // An input with one connection reads straight from its source (see
+      // AnthemGraphCompiler), so it only needs a buffer of its own if events
+      // from several sources are merged into it.
+      size_t mergedSize = 0;
+
+      if (port.connectionIds.size() > 1) {
+        for (auto& connectionId : port.connectionIds) {
+          auto connection = connections.find(connectionId);
+
+          if (connection == connections.end()) {
+            continue;
+          }
+
+          auto sourceNode = nodes.find(connection->second.sourceNodeId);
+
+          if (sourceNode == nodes.end()) {
+            continue;
+          }
+
+          auto sourcePort = sourceNode->second.getPortById(connection->second.sourcePortId);
+
+          if (sourcePort != nullptr) {
+            mergedSize += sourcePort->eventBufferSize;
+          }
+        }
+      }
+
+      port.eventBufferSize = std::max<size_t>(mergedSize, 1);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "modules/core/anthem_processing_config.h"
+#include "modules/core/project.h"
+#include "modules/processing_graph/model/node.h"
+#include "modules/processing_graph/processor/anthem_processor.h"
+#include "generated/lib/model/model.h"
+
+// A copy of a single port, as seen by the graph compiler.
+struct AnthemGraphTopologyPort {
+  int32_t id;
+  NodePortDataType dataType;
+
+  // The IDs of the connections attached to this port.
+  std::vector<std::string> connectionIds;
+
+  // The following are only meaningful for ports that have a parameter config,
+  // which is all control input ports and (usually) control output ports.
+  bool hasParameterConfig = false;
+  float parameterValue = 0.0f;
+  float minimumValue = 0.0f;
+  float maximumValue = 1.0f;
+  double smoothingDurationSeconds = 0.0;
+
+  // For event ports, the number of events to make room for in this port's
+  // buffer. See AnthemProcessor::getMaxEventsPerBlock().
+  size_t eventBufferSize = 0;
+};
+
+// A copy of a single node, as seen by the graph compiler.
+struct AnthemGraphTopologyNode {
+  std::string id;
+
+  // The live model node. The compiler thread must not read from this, since
+  // the model is mutated on the message thread without any locking. It's only
+  // carried along so the compilation result can keep the node alive, and so
+  // the result can be attached to the node once it's back on the message
+  // thread.
+  std::shared_ptr<Node> node;
+
+  // The processor for this node, or nullptr if the node doesn't have one.
+  std::shared_ptr<AnthemProcessor> processor;
+
+  std::vector<AnthemGraphTopologyPort> audioInputPorts;
+  std::vector<AnthemGraphTopologyPort> audioOutputPorts;
+  std::vector<AnthemGraphTopologyPort> controlInputPorts;
+  std::vector<AnthemGraphTopologyPort> controlOutputPorts;
+  std::vector<AnthemGraphTopologyPort> midiInputPorts;
+  std::vector<AnthemGraphTopologyPort> midiOutputPorts;
+
+  const AnthemGraphTopologyPort* getPortById(int32_t id) const;
+};
+
+// A copy of a single connection, as seen by the graph compiler.
+struct AnthemGraphTopologyConnection {
+  std::string id;
+
+  std::string sourceNodeId;
+  int32_t sourcePortId;
+
+  std::string destinationNodeId;
+  int32_t destinationPortId;
+};
+
+// An immutable copy of the processing graph topology.
+//
+// The project model is owned by the message thread, and nothing in it is safe
+// to read from another thread. Graph compilation can take a while for large
+// graphs, so we copy out everything the compiler needs on the message thread,
+// and then hand the copy to the compiler thread.
+//
+// Since this holds shared_ptr references to model nodes, it should be released
+// on the message thread as well.
+class AnthemGraphTopologySnapshot {
+public:
+  std::unordered_map<std::string, AnthemGraphTopologyNode> nodes;
+  std::unordered_map<std::string, AnthemGraphTopologyConnection> connections;
+
+  // The settings to compile the graph for.
+  AnthemProcessingConfig processingConfig;
+
+  // How many bytes event buffers have grown by, at most, in previous graphs.
+  // The compiler sizes the event allocator from this. See
+  // AnthemGraphProcessor::getEventAllocatorGrowthHighWater().
+  size_t expectedEventAllocatorGrowth = 0;
+
+  // Creates a snapshot of the processing graph in the given project. This must
+  // be called on the JUCE message thread.
+  //
+  // Any processor that hasn't been prepared for the given config is prepared
+  // here. Processors that are new to the graph aren't being processed yet, so
+  // this is safe. Processors that are already in the graph will have been
+  // prepared for this config already, since the config only changes while
+  // the graph isn't being processed (see Anthem::prepareToPlay()).
+  static std::shared_ptr<const AnthemGraphTopologySnapshot> create(
+    Project& project,
+    const AnthemProcessingConfig& processingConfig,
+    size_t expectedEventAllocatorGrowth = 0
+  );
+
+private:
+  // Sizes each event input buffer from the output ports connected to it. The
+  // output ports must be sized first.
+  void planEventInputBufferSizes();
+};
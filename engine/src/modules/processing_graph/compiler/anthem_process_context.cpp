@@ -20,45 +20,72 @@
 #include "anthem_process_context.h"
 
 #include "modules/core/constants.h"
+#include "modules/util/audio_thread_memory.h"
+
+namespace {
+  void prefaultBuffers(std::unordered_map<int32_t, juce::AudioSampleBuffer>& buffers) {
+    for (auto& [id, buffer] : buffers) {
+      for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+        AnthemAudioThreadMemory::prefault(
+          buffer.getWritePointer(channel), sizeof(float) * static_cast<size_t>(buffer.getNumSamples())
+        );
+      }
+    }
+  }
+}
 
-AnthemProcessContext::AnthemProcessContext(std::shared_ptr<Node>& graphNode, ArenaBufferAllocator<AnthemLiveEvent>* eventAllocator) : graphNode(graphNode) {
-  for (auto& port : *graphNode->audioInputPorts()) {
-    inputAudioBuffers[port->id()] = juce::AudioSampleBuffer(2, MAX_AUDIO_BUFFER_SIZE);
+AnthemProcessContext::AnthemProcessContext(
+  const AnthemGraphTopologyNode& graphNode,
+  ArenaBufferAllocator<AnthemLiveEvent>* eventAllocator,
+  int maxBlockSize
+) : graphNode(graphNode.node) {
+  for (auto& port : graphNode.audioInputPorts) {
+    inputAudioBuffers[port.id] = juce::AudioSampleBuffer(2, maxBlockSize);
   }
 
-  for (auto& port : *graphNode->audioOutputPorts()) {
-    outputAudioBuffers[port->id()] = juce::AudioSampleBuffer(2, MAX_AUDIO_BUFFER_SIZE);
+  for (auto& port : graphNode.audioOutputPorts) {
+    outputAudioBuffers[port.id] = juce::AudioSampleBuffer(2, maxBlockSize);
   }
 
-  for (auto& port : *graphNode->controlInputPorts()) {
-    inputControlBuffers[port->id()] = juce::AudioSampleBuffer(1, MAX_AUDIO_BUFFER_SIZE);
+  for (auto& port : graphNode.controlInputPorts) {
+    inputControlBuffers[port.id] = AnthemControlBuffer(maxBlockSize);
   }
 
-  for (auto& port : *graphNode->controlOutputPorts()) {
-    outputControlBuffers[port->id()] = juce::AudioSampleBuffer(1, MAX_AUDIO_BUFFER_SIZE);
+  for (auto& port : graphNode.controlOutputPorts) {
+    outputControlBuffers[port.id] = AnthemControlBuffer(maxBlockSize);
   }
 
-  for (auto& port : *graphNode->midiInputPorts()) {
-    inputNoteEventBuffers[port->id()] = std::move(std::make_unique<AnthemEventBuffer>(eventAllocator, 1024));
+  for (auto& port : graphNode.midiInputPorts) {
+    inputNoteEventBuffers[port.id] = std::move(std::make_unique<AnthemEventBuffer>(eventAllocator, port.eventBufferSize));
   }
 
-  for (auto& port : *graphNode->midiOutputPorts()) {
-    outputNoteEventBuffers[port->id()] = std::move(std::make_unique<AnthemEventBuffer>(eventAllocator, 1024));
+  for (auto& port : graphNode.midiOutputPorts) {
+    outputNoteEventBuffers[port.id] = std::move(std::make_unique<AnthemEventBuffer>(eventAllocator, port.eventBufferSize));
   }
 
-  for (auto& port : *graphNode->controlInputPorts()) {
-    parameterValues[port->id()] = new std::atomic<float>(port->parameterValue().value_or(0.0f));
+  for (auto& port : graphNode.controlInputPorts) {
+    parameterValues[port.id] = new std::atomic<float>(port.parameterValue);
   }
 
-  for (auto& port : *graphNode->controlInputPorts()) {
-    auto parameterValue = port->parameterValue().value_or(0.0f);
-    auto& parameterConfig = port->config()->parameterConfig();
+  for (auto& port : graphNode.controlInputPorts) {
+    jassert(port.hasParameterConfig);
 
-    auto smoother = std::make_unique<LinearParameterSmoother>(parameterValue, parameterConfig.value()->smoothingDurationSeconds());
-    parameterSmoothers[port->id()] = std::move(smoother);
+    auto smoother = std::make_unique<LinearParameterSmoother>(port.parameterValue, port.smoothingDurationSeconds);
+    parameterSmoothers[port.id] = std::move(smoother);
   }
+}
+
+void AnthemProcessContext::prefault() {
+  prefaultBuffers(inputAudioBuffers);
+  prefaultBuffers(outputAudioBuffers);
 
-  this->graphNode = graphNode;
+  for (auto& [id, buffer] : inputControlBuffers) {
+    buffer.prefault();
+  }
+
+  for (auto& [id, buffer] : outputControlBuffers) {
+    buffer.prefault();
+  }
 }
 
 void AnthemProcessContext::cleanup() {
@@ -114,27 +141,27 @@ juce::AudioSampleBuffer& AnthemProcessContext::getOutputAudioBuffer(int32_t id)
   return outputAudioBuffers[id];
 }
 
-void AnthemProcessContext::setAllInputControlBuffers(std::unordered_map<int32_t, juce::AudioSampleBuffer>& buffers) {
+void AnthemProcessContext::setAllInputControlBuffers(std::unordered_map<int32_t, AnthemControlBuffer>& buffers) {
   inputControlBuffers = std::move(buffers);
 }
 
-void AnthemProcessContext::setAllOutputControlBuffers(std::unordered_map<int32_t, juce::AudioSampleBuffer>& buffers) {
+void AnthemProcessContext::setAllOutputControlBuffers(std::unordered_map<int32_t, AnthemControlBuffer>& buffers) {
   outputControlBuffers = std::move(buffers);
 }
 
-std::unordered_map<int32_t, juce::AudioSampleBuffer>& AnthemProcessContext::getAllInputControlBuffers() {
+std::unordered_map<int32_t, AnthemControlBuffer>& AnthemProcessContext::getAllInputControlBuffers() {
   return inputControlBuffers;
 }
 
-std::unordered_map<int32_t, juce::AudioSampleBuffer>& AnthemProcessContext::getAllOutputControlBuffers() {
+std::unordered_map<int32_t, AnthemControlBuffer>& AnthemProcessContext::getAllOutputControlBuffers() {
   return outputControlBuffers;
 }
 
-juce::AudioSampleBuffer& AnthemProcessContext::getInputControlBuffer(int32_t id) {
+AnthemControlBuffer& AnthemProcessContext::getInputControlBuffer(int32_t id) {
   return inputControlBuffers[id];
 }
 
-juce::AudioSampleBuffer& AnthemProcessContext::getOutputControlBuffer(int32_t id) {
+AnthemControlBuffer& AnthemProcessContext::getOutputControlBuffer(int32_t id) {
   return outputControlBuffers[id];
 }
 
@@ -154,10 +181,24 @@ std::unordered_map<int32_t, std::unique_ptr<AnthemEventBuffer>>& AnthemProcessCo
   return outputNoteEventBuffers;
 }
 
-std::unique_ptr<AnthemEventBuffer>& AnthemProcessContext::getInputNoteEventBuffer(int32_t id) {
-  return inputNoteEventBuffers[id];
+const AnthemEventBuffer* AnthemProcessContext::getInputNoteEventBuffer(int32_t id) {
+  auto view = inputNoteEventViews.find(id);
+
+  if (view != inputNoteEventViews.end()) {
+    return view->second;
+  }
+
+  return inputNoteEventBuffers[id].get();
+}
+
+AnthemEventBuffer* AnthemProcessContext::getOwnedInputNoteEventBuffer(int32_t id) {
+  return inputNoteEventBuffers[id].get();
 }
 
 std::unique_ptr<AnthemEventBuffer>& AnthemProcessContext::getOutputNoteEventBuffer(int32_t id) {
   return outputNoteEventBuffers[id];
 }
+
+void AnthemProcessContext::setInputNoteEventView(int32_t id, const AnthemEventBuffer* source) {
+  inputNoteEventViews[id] = source;
+}
@@ -26,10 +26,12 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_events/juce_events.h>
 
+#include "modules/processing_graph/processor/anthem_control_buffer.h"
 #include "modules/processing_graph/processor/anthem_event_buffer.h"
 #include "generated/lib/model/model.h"
 #include "modules/util/linear_parameter_smoother.h"
 #include "modules/processing_graph/model/node.h"
+#include "modules/processing_graph/compiler/anthem_graph_topology_snapshot.h"
 
 // This class acts as a context for node graph processors. It is passed to the
 // `process()` method of each `AnthemProcessor`, and provides a way to query
@@ -39,22 +41,39 @@ private:
   std::unordered_map<int32_t, juce::AudioSampleBuffer> inputAudioBuffers;
   std::unordered_map<int32_t, juce::AudioSampleBuffer> outputAudioBuffers;
 
-  std::unordered_map<int32_t, juce::AudioSampleBuffer> inputControlBuffers;
-  std::unordered_map<int32_t, juce::AudioSampleBuffer> outputControlBuffers;
+  std::unordered_map<int32_t, AnthemControlBuffer> inputControlBuffers;
+  std::unordered_map<int32_t, AnthemControlBuffer> outputControlBuffers;
 
   std::unordered_map<int32_t, std::unique_ptr<AnthemEventBuffer>> inputNoteEventBuffers;
   std::unordered_map<int32_t, std::unique_ptr<AnthemEventBuffer>> outputNoteEventBuffers;
 
+  // Input ports that read straight from another node's output buffer instead
+  // of their own buffer. See setInputNoteEventView().
+  std::unordered_map<int32_t, const AnthemEventBuffer*> inputNoteEventViews;
+
   std::unordered_map<int32_t, std::atomic<float>*> parameterValues;
   std::unordered_map<int32_t, std::unique_ptr<LinearParameterSmoother>> parameterSmoothers;
 
   std::weak_ptr<Node> graphNode;
 public:
-  AnthemProcessContext(std::shared_ptr<Node>& graphNode, ArenaBufferAllocator<AnthemLiveEvent>* eventAllocator);
+  // Contexts are created by the graph compiler, which may run off the message
+  // thread, so this reads from the topology snapshot instead of the model.
+  //
+  // Audio buffers, and the samples in control buffers, are sized to hold
+  // maxBlockSize samples.
+  AnthemProcessContext(
+    const AnthemGraphTopologyNode& graphNode,
+    ArenaBufferAllocator<AnthemLiveEvent>* eventAllocator,
+    int maxBlockSize
+  );
 
   // Clean up the context. This must be called before the context is deallocated.
   void cleanup();
 
+  // Touches the memory for all audio and control buffers. See
+  // AnthemGraphCompilationResult::prefault().
+  void prefault();
+
   std::shared_ptr<Node> getGraphNode() {
     // This function is for debugging. The graph node is mutated on the JUCE
     // message thread without any concern for thread safety, so we throw if
@@ -78,14 +97,16 @@ public:
   juce::AudioSampleBuffer& getInputAudioBuffer(int32_t id);
   juce::AudioSampleBuffer& getOutputAudioBuffer(int32_t id);
 
-  void setAllInputControlBuffers(std::unordered_map<int32_t, juce::AudioSampleBuffer>& buffers);
-  void setAllOutputControlBuffers(std::unordered_map<int32_t, juce::AudioSampleBuffer>& buffers);
+  void setAllInputControlBuffers(std::unordered_map<int32_t, AnthemControlBuffer>& buffers);
+  void setAllOutputControlBuffers(std::unordered_map<int32_t, AnthemControlBuffer>& buffers);
 
-  std::unordered_map<int32_t, juce::AudioSampleBuffer>& getAllInputControlBuffers();
-  std::unordered_map<int32_t, juce::AudioSampleBuffer>& getAllOutputControlBuffers();
+  std::unordered_map<int32_t, AnthemControlBuffer>& getAllInputControlBuffers();
+  std::unordered_map<int32_t, AnthemControlBuffer>& getAllOutputControlBuffers();
 
-  juce::AudioSampleBuffer& getInputControlBuffer(int32_t id);
-  juce::AudioSampleBuffer& getOutputControlBuffer(int32_t id);
+  // Control buffers usually hold a few breakpoints rather than a value for
+  // every sample. See AnthemControlBuffer.
+  AnthemControlBuffer& getInputControlBuffer(int32_t id);
+  AnthemControlBuffer& getOutputControlBuffer(int32_t id);
 
   void setAllInputNoteEventBuffers(std::unordered_map<int32_t, std::unique_ptr<AnthemEventBuffer>>& buffers);
   void setAllOutputNoteEventBuffers(std::unordered_map<int32_t, std::unique_ptr<AnthemEventBuffer>>& buffers);
@@ -93,9 +114,24 @@ public:
   std::unordered_map<int32_t, std::unique_ptr<AnthemEventBuffer>>& getAllInputNoteEventBuffers();
   std::unordered_map<int32_t, std::unique_ptr<AnthemEventBuffer>>& getAllOutputNoteEventBuffers();
 
-  std::unique_ptr<AnthemEventBuffer>& getInputNoteEventBuffer(int32_t id);
+  // Gets the events for an input port. This may be another node's output
+  // buffer, so it's read-only.
+  const AnthemEventBuffer* getInputNoteEventBuffer(int32_t id);
+
+  // Gets this node's own buffer for an input port, ignoring any view. This is
+  // for the graph's actions that fill input buffers, not for processors.
+  AnthemEventBuffer* getOwnedInputNoteEventBuffer(int32_t id);
+
   std::unique_ptr<AnthemEventBuffer>& getOutputNoteEventBuffer(int32_t id);
 
+  // Makes an input port read from the given buffer, which is the output
+  // buffer of the only node connected to it. This saves copying the events
+  // for every block.
+  //
+  // This is set up by the graph compiler, and the source buffer must belong
+  // to the same compilation result.
+  void setInputNoteEventView(int32_t id, const AnthemEventBuffer* source);
+
   std::unordered_map<int32_t, std::atomic<float>*>& getParameterValues() {
     return parameterValues;
   }
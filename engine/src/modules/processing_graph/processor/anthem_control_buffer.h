@@ -0,0 +1,250 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "modules/core/constants.h"
+#include "modules/util/audio_thread_memory.h"
+#include "modules/util/denormals.h"
+
+// A point where a control signal starts a new straight line. From this
+// sample until the next breakpoint, the value at sample s is
+// value + slope * (s - sample).
+struct AnthemControlBreakpoint {
+  int32_t sample;
+  float value;
+
+  // The change in value per sample.
+  float slope;
+};
+
+// The values for a single control port, for a single processing block.
+//
+// Most control values change rarely, so rather than writing a value for every
+// sample, writers usually describe the block as a list of breakpoints, where
+// each one holds or ramps linearly until the next. A parameter that isn't
+// moving is a single breakpoint, no matter how large the block is.
+//
+// Processors that need a value for every sample can call getReadPointer(),
+// which fills in the samples the first time it's called in a block.
+// Processors that generate audio-rate control signals can write samples
+// directly with getWritePointer().
+class AnthemControlBuffer {
+  std::array<AnthemControlBreakpoint, CONTROL_BUFFER_MAX_BREAKPOINTS> breakpoints;
+  int numBreakpoints;
+
+  // If dense is true, these samples are the value of the buffer, and the
+  // breakpoints are ignored. Otherwise, the first numValidSamples samples
+  // are a cache of the breakpoints.
+  std::vector<float> samples;
+  bool dense;
+  int numValidSamples;
+
+  float getBreakpointValue(const AnthemControlBreakpoint& breakpoint, int sample) const {
+    return breakpoint.value + breakpoint.slope * static_cast<float>(sample - breakpoint.sample);
+  }
+public:
+  // Samples are allocated up front, so this doesn't allocate on the audio
+  // thread.
+  AnthemControlBuffer(int maxBlockSize = 0)
+    : numBreakpoints(1),
+      samples(static_cast<size_t>(maxBlockSize), 0.0f),
+      dense(false),
+      numValidSamples(0) {
+    breakpoints[0] = AnthemControlBreakpoint { .sample = 0, .value = 0.0f, .slope = 0.0f };
+  }
+
+  // Starts the block with the given value and slope, removing anything that
+  // was written before.
+  void setValue(float value, float slope = 0.0f) {
+    breakpoints[0] = AnthemControlBreakpoint { .sample = 0, .value = value, .slope = slope };
+    numBreakpoints = 1;
+    dense = false;
+    numValidSamples = 0;
+  }
+
+  // Adds a breakpoint after the ones that are already in the buffer.
+  //
+  // Breakpoints must be added in time order. If the buffer is full, or has
+  // been written with getWritePointer() this block, the breakpoint is dropped
+  // and this returns false.
+  bool addBreakpoint(int32_t sample, float value, float slope = 0.0f) {
+    if (dense || numBreakpoints >= CONTROL_BUFFER_MAX_BREAKPOINTS) {
+      jassertfalse;
+      return false;
+    }
+
+    auto& last = breakpoints[static_cast<size_t>(numBreakpoints - 1)];
+    jassert(sample >= last.sample);
+
+    if (sample == last.sample) {
+      last = AnthemControlBreakpoint { .sample = sample, .value = value, .slope = slope };
+    } else {
+      breakpoints[static_cast<size_t>(numBreakpoints)] = AnthemControlBreakpoint { .sample = sample, .value = value, .slope = slope };
+      numBreakpoints++;
+    }
+
+    numValidSamples = 0;
+    return true;
+  }
+
+  // True if the buffer holds samples instead of breakpoints.
+  bool isDense() const {
+    return dense;
+  }
+
+  // True if the value is the same for the whole block. This is a cheap check
+  // that processors can use to skip per-sample work.
+  bool isConstant() const {
+    return !dense && numBreakpoints == 1 && breakpoints[0].slope == 0.0f;
+  }
+
+  int getNumBreakpoints() const {
+    return dense ? 0 : numBreakpoints;
+  }
+
+  const AnthemControlBreakpoint& getBreakpoint(int index) const {
+    return breakpoints[static_cast<size_t>(index)];
+  }
+
+  // Gets the value at a single sample. This searches the breakpoints, so
+  // processors that read every sample should use getReadPointer() instead.
+  float getValue(int sample) const {
+    if (dense) {
+      return samples[static_cast<size_t>(sample)];
+    }
+
+    int index = numBreakpoints - 1;
+
+    while (index > 0 && breakpoints[static_cast<size_t>(index)].sample > sample) {
+      index--;
+    }
+
+    return getBreakpointValue(breakpoints[static_cast<size_t>(index)], sample);
+  }
+
+  // Gets a value for each of the first numSamples samples in the block.
+  //
+  // If the buffer holds breakpoints, the samples are filled in from them the
+  // first time this is called in a block.
+  const float* getReadPointer(int numSamples) {
+    jassert(numSamples <= static_cast<int>(samples.size()));
+
+    if (dense || numValidSamples >= numSamples) {
+      return samples.data();
+    }
+
+    for (int i = 0; i < numBreakpoints; i++) {
+      auto& breakpoint = breakpoints[static_cast<size_t>(i)];
+      auto end = i + 1 < numBreakpoints ? std::min(breakpoints[static_cast<size_t>(i + 1)].sample, numSamples) : numSamples;
+
+      if (breakpoint.slope == 0.0f) {
+        std::fill(samples.begin() + breakpoint.sample, samples.begin() + std::max(end, breakpoint.sample), breakpoint.value);
+        continue;
+      }
+
+      for (int sample = breakpoint.sample; sample < end; sample++) {
+        samples[static_cast<size_t>(sample)] = getBreakpointValue(breakpoint, sample);
+      }
+    }
+
+    numValidSamples = numSamples;
+    return samples.data();
+  }
+
+  // Gets the samples for the block, for processors that write a new value
+  // for every sample. The caller must write each of the samples it processes.
+  float* getWritePointer() {
+    dense = true;
+    return samples.data();
+  }
+
+  // Overwrites this buffer with the source values scaled by scale and offset,
+  // for the first numSamples samples in the block.
+  //
+  // If the source holds breakpoints, then the breakpoints are scaled, and
+  // nothing is done per sample. Otherwise, source samples that are NaN leave
+  // the value in this buffer as it was.
+  void copyScaledFrom(AnthemControlBuffer& source, float scale, float offset, int numSamples) {
+    bool hasNaN = false;
+
+    for (int i = 0; i < source.getNumBreakpoints(); i++) {
+      hasNaN = hasNaN || std::isnan(source.breakpoints[static_cast<size_t>(i)].value);
+    }
+
+    if (!source.dense && !hasNaN) {
+      for (int i = 0; i < source.numBreakpoints; i++) {
+        auto& breakpoint = source.breakpoints[static_cast<size_t>(i)];
+        breakpoints[static_cast<size_t>(i)] = AnthemControlBreakpoint {
+          .sample = breakpoint.sample,
+          .value = breakpoint.value * scale + offset,
+          .slope = breakpoint.slope * scale,
+        };
+      }
+
+      numBreakpoints = source.numBreakpoints;
+      dense = false;
+      numValidSamples = 0;
+      return;
+    }
+
+    auto* sourceSamples = source.getReadPointer(numSamples);
+
+    // Samples that are skipped keep their current value, so we fill in the
+    // current value first.
+    getReadPointer(numSamples);
+    auto* destinationSamples = getWritePointer();
+
+    for (int sample = 0; sample < numSamples; sample++) {
+      if (!std::isnan(sourceSamples[sample])) {
+        destinationSamples[sample] = sourceSamples[sample] * scale + offset;
+      }
+    }
+  }
+
+  // Checks the first numSamples samples for denormals. See denormals.h.
+  bool containsDenormals(int numSamples) const {
+    if (dense) {
+      return AnthemDenormals::countDenormals(samples.data(), numSamples) > 0;
+    }
+
+    for (int i = 0; i < numBreakpoints; i++) {
+      auto& breakpoint = breakpoints[static_cast<size_t>(i)];
+
+      if (AnthemDenormals::isDenormal(breakpoint.value) || AnthemDenormals::isDenormal(breakpoint.slope)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // Touches the memory for the samples. See AnthemGraphCompilationResult::prefault().
+  void prefault() {
+    AnthemAudioThreadMemory::prefault(samples.data(), sizeof(float) * samples.size());
+  }
+};
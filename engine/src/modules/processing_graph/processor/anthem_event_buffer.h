@@ -20,10 +20,15 @@
 #pragma once
 
 #include <stdexcept>
+#include <vector>
 
 #include "modules/util/arena_allocator.h"
 #include "modules/sequencer/events/event.h"
 
+// A list of events for a single port, for a single processing block.
+//
+// Events are always kept in time order, so processors can read them from
+// front to back without sorting.
 class AnthemEventBuffer {
   // ALlocator for this buffer. This allocator maintains a huge buffer of memory
   // that can be used to reallocate our buffer if it gets too big, without
@@ -68,11 +73,14 @@ public:
 
   // Reallocation function. This function will reallocate the buffer to a new
   // size. This function will copy the old buffer into the new buffer.
-  void reallocate(size_t newSize) {
+  //
+  // Returns false if the allocator is out of space, in which case the buffer
+  // is left as it was.
+  bool reallocate(size_t newSize) {
     auto result = allocator->allocate(newSize);
 
     if (!result.success) {
-      throw std::runtime_error("Failed to reallocate buffer for event buffer.");
+      return false;
     }
 
     // Copy the old buffer into the new buffer.
@@ -87,15 +95,31 @@ public:
     buffer = result.memoryStart;
     deallocatePtr = result.deallocatePtr;
     size = newSize;
+
+    return true;
   }
 
-  // Adds an event to the buffer.
+  // Adds an event to the buffer, keeping the buffer in time order. Events
+  // with the same time stay in the order they were added.
+  //
+  // Events are almost always added in order, so we check the end of the
+  // buffer first, and otherwise search backward for where the event goes.
+  //
+  // If the buffer is full and can't grow, the event is dropped. This runs on
+  // the audio thread, where throwing isn't an option.
   void addEvent(AnthemLiveEvent event) {
-    if (numEvents >= size) {
-      reallocate(size * 2);
+    if (numEvents >= size && !reallocate(size * 2)) {
+      return;
+    }
+
+    size_t index = numEvents;
+
+    while (index > 0 && buffer[index - 1].time.offset > event.time.offset) {
+      buffer[index] = buffer[index - 1];
+      index--;
     }
 
-    buffer[numEvents] = event;
+    buffer[index] = event;
     numEvents++;
   }
 
@@ -105,17 +129,60 @@ public:
   }
 
   // Returns the event at the given index.
-  AnthemLiveEvent& getEvent(size_t index) {
+  const AnthemLiveEvent& getEvent(size_t index) const {
     return buffer[index];
   }
 
   // Returns the number of events in the buffer.
-  size_t getNumEvents() {
+  size_t getNumEvents() const {
     return numEvents;
   }
 
   // Returns the size of the buffer.
-  size_t getSize() {
+  size_t getSize() const {
     return size;
   }
+
+  // Adds the events from each source buffer to this buffer, ordered by time.
+  //
+  // Each source must already be ordered by time. Events with the same time
+  // keep the order of their sources, so the result doesn't depend on the
+  // order that sources finish processing in.
+  //
+  // cursors is scratch space, and must have one entry per source. It's passed
+  // in so this doesn't allocate on the audio thread.
+  void mergeFrom(const std::vector<const AnthemEventBuffer*>& sources, std::vector<size_t>& cursors) {
+    jassert(cursors.size() == sources.size());
+
+    for (auto& cursor : cursors) {
+      cursor = 0;
+    }
+
+    // There are usually only a handful of sources, so we find the earliest
+    // event with a linear search instead of keeping a heap.
+    while (true) {
+      size_t earliestSource = sources.size();
+      int32_t earliestOffset = 0;
+
+      for (size_t i = 0; i < sources.size(); i++) {
+        if (cursors[i] >= sources[i]->numEvents) {
+          continue;
+        }
+
+        auto offset = sources[i]->buffer[cursors[i]].time.offset;
+
+        if (earliestSource == sources.size() || offset < earliestOffset) {
+          earliestSource = i;
+          earliestOffset = offset;
+        }
+      }
+
+      if (earliestSource == sources.size()) {
+        return;
+      }
+
+      addEvent(sources[earliestSource]->buffer[cursors[earliestSource]]);
+      cursors[earliestSource]++;
+    }
+  }
 };
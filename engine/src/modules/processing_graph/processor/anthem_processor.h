@@ -19,9 +19,13 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <memory>
 
+#include "modules/core/anthem_processing_config.h"
+#include "modules/core/constants.h"
+
 class AnthemGraphNode;
 class AnthemProcessContext;
 
@@ -31,6 +35,10 @@ class AnthemProcessContext;
 // This serves as a base class for internal and external plugins, but also for
 // several internal processing modules that interact with the processing graph.
 class AnthemProcessor {
+private:
+  // The config this processor was last prepared with, if any.
+  bool isPrepared = false;
+  AnthemProcessingConfig preparedConfig;
 public:
   // The name of the processor.
   std::string name;
@@ -42,4 +50,37 @@ public:
   // This method is called by the processing graph to process audio, MIDI and
   // control data. It is called once per processing block.
   virtual void process(AnthemProcessContext& context, int numSamples) = 0;
+
+  // This method is called before the processor is first processed, and again
+  // whenever the sample rate or maximum block size changes. process() will
+  // never be called with more than maxBlockSize samples.
+  //
+  // This is called on the message thread, and never while process() could be
+  // running, so it's safe to allocate here.
+  virtual void prepareToPlay([[maybe_unused]] double sampleRate, [[maybe_unused]] int maxBlockSize) {}
+
+  // Returns the most events that this processor will ever write to the given
+  // event output port in a single block of up to maxBlockSize samples.
+  //
+  // The graph compiler sizes event buffers from this, so that they never need
+  // to grow on the audio thread. Processors that can't say should leave this
+  // as-is, and their buffers will grow if they need to.
+  //
+  // This is called on the message thread, after prepareToPlay().
+  virtual size_t getMaxEventsPerBlock([[maybe_unused]] int32_t portId, [[maybe_unused]] int maxBlockSize) {
+    return DEFAULT_EVENT_BUFFER_SIZE;
+  }
+
+  // Calls prepareToPlay() if the processor hasn't already been prepared with
+  // the given config.
+  void prepareIfNeeded(const AnthemProcessingConfig& config) {
+    if (isPrepared && preparedConfig == config) {
+      return;
+    }
+
+    prepareToPlay(config.sampleRate, config.maxBlockSize);
+
+    isPrepared = true;
+    preparedConfig = config;
+  }
 };
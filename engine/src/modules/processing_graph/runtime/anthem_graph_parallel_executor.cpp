@@ -0,0 +1,105 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "anthem_graph_parallel_executor.h"
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+AnthemGraphParallelExecutor::Worker::Worker(AnthemGraphParallelExecutor& executor, int index)
+  : juce::Thread("AnthemGraphWorker" + juce::String(index)), executor(executor) {}
+
+void AnthemGraphParallelExecutor::Worker::run() {
+  // See modules/util/denormals.h.
+  juce::ScopedNoDenormals noDenormals;
+
+  while (!threadShouldExit()) {
+    wakeUp.wait(-1);
+
+    if (threadShouldExit()) {
+      break;
+    }
+
+    executor.runActions();
+    executor.activeWorkers.fetch_sub(1, std::memory_order_acq_rel);
+  }
+}
+
+AnthemGraphParallelExecutor::AnthemGraphParallelExecutor(int numWorkers) {
+  for (int i = 0; i < numWorkers; i++) {
+    auto worker = std::make_unique<Worker>(*this, i);
+    worker->startThread(juce::Thread::Priority::high);
+    workers.push_back(std::move(worker));
+  }
+}
+
+AnthemGraphParallelExecutor::~AnthemGraphParallelExecutor() {
+  for (auto& worker : workers) {
+    worker->signalThreadShouldExit();
+    worker->wakeUp.signal();
+  }
+
+  for (auto& worker : workers) {
+    worker->stopThread(10000);
+  }
+}
+
+void AnthemGraphParallelExecutor::runActions() {
+  auto& actions = *currentActions;
+
+  while (true) {
+    auto index = nextAction.fetch_add(1, std::memory_order_relaxed);
+
+    if (index >= actions.size()) {
+      break;
+    }
+
+    actions[index]->execute(currentNumSamples);
+  }
+}
+
+void AnthemGraphParallelExecutor::execute(std::vector<std::unique_ptr<AnthemGraphCompilerAction>>& actions, int numSamples) {
+  // Waking the workers costs more than running a single action, so small
+  // groups are run on this thread.
+  if (workers.empty() || actions.size() < 2) {
+    for (auto& action : actions) {
+      action->execute(numSamples);
+    }
+
+    return;
+  }
+
+  currentActions = &actions;
+  currentNumSamples = numSamples;
+  nextAction.store(0, std::memory_order_relaxed);
+
+  // The release here publishes the fields above to the workers.
+  activeWorkers.store(static_cast<int>(workers.size()), std::memory_order_release);
+
+  for (auto& worker : workers) {
+    worker->wakeUp.signal();
+  }
+
+  runActions();
+
+  // Wait for every worker, not just for every action, so that no worker is
+  // still reading the fields above when the next group overwrites them.
+  while (activeWorkers.load(std::memory_order_acquire) > 0) {
+    juce::Thread::yield();
+  }
+}
@@ -0,0 +1,85 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <juce_core/juce_core.h>
+
+#include "modules/processing_graph/compiler/actions/anthem_graph_compiler_action.h"
+
+// Runs the actions in an action group across several threads.
+//
+// The graph compiler groups actions that can run at the same time (see
+// AnthemGraphCompilationResult::actionGroupIsParallel). The graph processor
+// normally runs them one after another, but when one of these is passed to
+// AnthemGraphProcessor::process(), each parallel group is split between the
+// worker threads here and the calling thread, and process() waits for the
+// whole group to finish before moving on to the next one.
+//
+// Waking the workers for every group has a cost, and the workers aren't
+// real-time threads, so this is meant for offline rendering rather than the
+// audio device callback.
+class AnthemGraphParallelExecutor {
+private:
+  class Worker : public juce::Thread {
+  private:
+    AnthemGraphParallelExecutor& executor;
+  public:
+    juce::WaitableEvent wakeUp;
+
+    Worker(AnthemGraphParallelExecutor& executor, int index);
+
+    void run() override;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers;
+
+  // The group that is currently being run. These are only written while no
+  // workers are running.
+  std::vector<std::unique_ptr<AnthemGraphCompilerAction>>* currentActions = nullptr;
+  int currentNumSamples = 0;
+
+  // The index of the next action in the current group that hasn't been
+  // claimed by a thread yet.
+  std::atomic<size_t> nextAction = 0;
+
+  // The number of workers that haven't finished with the current group.
+  std::atomic<int> activeWorkers = 0;
+
+  // Claims and runs actions from the current group until there are none
+  // left.
+  void runActions();
+public:
+  // Creates an executor with the given number of worker threads. The thread
+  // that calls execute() also runs actions, so this should be one less than
+  // the number of cores to use.
+  AnthemGraphParallelExecutor(int numWorkers);
+  ~AnthemGraphParallelExecutor();
+
+  int getNumWorkers() {
+    return static_cast<int>(workers.size());
+  }
+
+  // Runs every action in the group and returns once they've all finished.
+  void execute(std::vector<std::unique_ptr<AnthemGraphCompilerAction>>& actions, int numSamples);
+};
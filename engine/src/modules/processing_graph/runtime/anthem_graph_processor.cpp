@@ -19,11 +19,14 @@
 
 #include "anthem_graph_processor.h"
 
+#include "modules/util/audio_thread_memory.h"
+
 AnthemGraphProcessor::AnthemGraphProcessor() : clearDeletionQueueTimedCallback(juce::TimedCallback([this]() {
         this->clearDeletionQueueFromMainThread();
+        this->reportPageFaults();
       })),
-      processingStepsQueue(ThreadSafeQueue<AnthemGraphCompilationResult*>(512)),
-      processingStepsDeletionQueue(ThreadSafeQueue<AnthemGraphCompilationResult*>(512)) {
+      processingStepsQueue(512),
+      processingStepsDeletionQueue(512) {
   // Set up a JUCE timer to clear the deletion queue every 1s
   // this->clearDeletionQueueTimedCallback = std::move();
   this->clearDeletionQueueTimedCallback.startTimer(2000);
@@ -31,32 +34,165 @@ AnthemGraphProcessor::AnthemGraphProcessor() : clearDeletionQueueTimedCallback(j
 }
 
 void AnthemGraphProcessor::setProcessingStepsFromMainThread(AnthemGraphCompilationResult* compilationResult) {
-  this->processingStepsQueue.add(compilationResult);
+  this->latestCompilationResult = compilationResult;
+  this->unsentCompilationResults.push_back(compilationResult);
+
+  sendUnsentCompilationResults();
+}
+
+void AnthemGraphProcessor::sendUnsentCompilationResults() {
+  size_t sent = 0;
+
+  // The queue only fills up if nothing has been processing for a long time,
+  // e.g. if the audio device is stopped. We hold on to anything that doesn't
+  // fit, rather than leaking it, and try again from the timer.
+  while (sent < unsentCompilationResults.size() &&
+         processingStepsQueue.tryPush(unsentCompilationResults[sent])) {
+    sent++;
+  }
+
+  unsentCompilationResults.erase(unsentCompilationResults.begin(), unsentCompilationResults.begin() + sent);
 }
 
 void AnthemGraphProcessor::clearDeletionQueueFromMainThread() {
-  auto nextCompilationResult = this->processingStepsDeletionQueue.read();
+  sendUnsentCompilationResults();
+
+  auto nextCompilationResult = this->processingStepsDeletionQueue.tryPop();
 
   while (nextCompilationResult) {
     auto* ptr = nextCompilationResult.value();
+    recordRetiredCompilationResult(ptr);
     ptr->cleanup();
     delete ptr;
 
-    nextCompilationResult = this->processingStepsDeletionQueue.read();
+    nextCompilationResult = this->processingStepsDeletionQueue.tryPop();
+  }
+}
+
+namespace {
+  // Reads the telemetry for a single compilation result.
+  AnthemEventAllocatorTelemetry getTelemetryForResult(AnthemGraphCompilationResult* result) {
+    auto stats = result->eventAllocator->getStats();
+
+    AnthemEventAllocatorTelemetry telemetry {
+      .capacity = stats.capacity,
+      .used = stats.used,
+      .highWater = stats.highWater,
+      .fragmentation = stats.fragmentation,
+      .reallocations = stats.allocations - std::min(stats.allocations, result->initialEventBufferCount),
+      .overflows = stats.failedAllocations,
+    };
+
+    telemetry.totalReallocations = telemetry.reallocations;
+    telemetry.totalOverflows = telemetry.overflows;
+    telemetry.growthHighWater = stats.highWater > result->initialEventAllocatorUsage
+      ? stats.highWater - result->initialEventAllocatorUsage
+      : 0;
+
+    return telemetry;
   }
 }
 
-void AnthemGraphProcessor::process(int numSamples) {
-  auto nextCompilationResult = std::move(this->processingStepsQueue.read());
+void AnthemGraphProcessor::recordRetiredCompilationResult(AnthemGraphCompilationResult* result) {
+  auto telemetry = getTelemetryForResult(result);
+
+  if (telemetry.overflows > 0) {
+    juce::Logger::writeToLog(
+      "Graph processor: event buffers couldn't grow " + juce::String(static_cast<juce::int64>(telemetry.overflows)) +
+      " times, so some events were dropped. Later graphs will reserve more space for events."
+    );
+  }
+
+  auto& retired = retiredEventAllocatorTelemetry;
+  retired.totalReallocations += telemetry.reallocations;
+  retired.totalOverflows += telemetry.overflows;
+  retired.growthHighWater = std::max(retired.growthHighWater, telemetry.growthHighWater);
+}
+
+AnthemEventAllocatorTelemetry AnthemGraphProcessor::getEventAllocatorTelemetry() {
+  AnthemEventAllocatorTelemetry telemetry;
+
+  if (latestCompilationResult != nullptr) {
+    telemetry = getTelemetryForResult(latestCompilationResult);
+  }
+
+  telemetry.totalReallocations += retiredEventAllocatorTelemetry.totalReallocations;
+  telemetry.totalOverflows += retiredEventAllocatorTelemetry.totalOverflows;
+  telemetry.growthHighWater = std::max(telemetry.growthHighWater, retiredEventAllocatorTelemetry.growthHighWater);
+
+  return telemetry;
+}
+
+size_t AnthemGraphProcessor::getEventAllocatorGrowthHighWater() {
+  return getEventAllocatorTelemetry().growthHighWater;
+}
+
+void AnthemGraphProcessor::setPageFaultCountingEnabled(bool enabled) {
+  isCountingPageFaults.store(enabled, std::memory_order_relaxed);
+}
+
+AnthemGraphProcessor::PageFaultStats AnthemGraphProcessor::getPageFaultStats() {
+  return PageFaultStats {
+    .lastBlock = pageFaultsInLastBlock.load(std::memory_order_relaxed),
+    .total = totalPageFaults.load(std::memory_order_relaxed),
+    .blocksWithPageFaults = blocksWithPageFaults.load(std::memory_order_relaxed),
+  };
+}
+
+void AnthemGraphProcessor::reportPageFaults() {
+  auto stats = getPageFaultStats();
+
+  if (stats.blocksWithPageFaults == lastReportedBlocksWithPageFaults) {
+    return;
+  }
+
+  juce::Logger::writeToLog(
+    "Graph processor: " + juce::String(stats.blocksWithPageFaults - lastReportedBlocksWithPageFaults) +
+    " blocks took page faults since the last report (" + juce::String(stats.total) + " faults in total, " +
+    juce::String(stats.lastBlock) + " in the last block)."
+  );
+
+  lastReportedBlocksWithPageFaults = stats.blocksWithPageFaults;
+}
+
+void AnthemGraphProcessor::process(int numSamples, AnthemGraphParallelExecutor* executor) {
+  if (!isCountingPageFaults.load(std::memory_order_relaxed)) {
+    processBlock(numSamples, executor);
+    return;
+  }
+
+  auto pageFaultsBefore = AnthemAudioThreadMemory::getPageFaultCount();
+
+  processBlock(numSamples, executor);
+
+  auto pageFaults = AnthemAudioThreadMemory::getPageFaultCount() - pageFaultsBefore;
+
+  pageFaultsInLastBlock.store(pageFaults, std::memory_order_relaxed);
+
+  if (pageFaults > 0) {
+    totalPageFaults.fetch_add(pageFaults, std::memory_order_relaxed);
+    blocksWithPageFaults.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void AnthemGraphProcessor::processBlock(int numSamples, AnthemGraphParallelExecutor* executor) {
+  // We only take a new result if there's room to send the old one back for
+  // deletion. Otherwise, the new one waits in the queue until there is.
+  while (this->processingStepsDeletionQueue.getNumFreeSlots() > 0) {
+    auto nextCompilationResult = this->processingStepsQueue.tryPop();
+
+    if (!nextCompilationResult) {
+      break;
+    }
 
-  while (nextCompilationResult) {
     juce::Logger::writeToLog("Audio thread: New compilation result found, replacing old one");
     if (this->processingSteps != nullptr) {
-      this->processingStepsDeletionQueue.add(this->processingSteps);
+      // This can't fail, since we checked for room above.
+      [[maybe_unused]] auto added = this->processingStepsDeletionQueue.tryPush(this->processingSteps);
+      jassert(added);
     }
 
     this->processingSteps = nextCompilationResult.value();
-    nextCompilationResult = this->processingStepsQueue.read();
   }
 
   // The audio thread can't do anything until it receives the first graph
@@ -65,14 +201,26 @@ void AnthemGraphProcessor::process(int numSamples) {
     return;
   }
 
+  // Graph buffers are only as large as the block size the graph was prepared
+  // for. See Anthem::prepareToPlay().
+  jassert(numSamples <= this->processingSteps->processingConfig.maxBlockSize);
+
   auto& actionGroups = this->processingSteps->actionGroups;
+  auto& actionGroupIsParallel = this->processingSteps->actionGroupIsParallel;
+
+  for (size_t i = 0; i < actionGroups.size(); i++) {
+    auto& group = actionGroups[i];
+
+    if (executor != nullptr && actionGroupIsParallel[i]) {
+      executor->execute(*group, numSamples);
+      continue;
+    }
 
-  for (auto& group : actionGroups) {
-    // Actions within groups can be executed in parallel, but we're not doing
-    // that yet because the grouping is naive and we haven't profiled the
-    // performance characteristics of everything yet. Some actions may be too
-    // small to benefit from parallel execution, and the way we're grouping
-    // at the moment may be suboptimal for some graphs.
+    // Without an executor (e.g. on the audio thread), actions are run in
+    // series. The grouping is naive and we haven't profiled the performance
+    // characteristics of everything yet, and some actions may be too small to
+    // benefit from parallel execution. Offline renders pass an executor and
+    // take the branch above instead.
     //
     // ALso, the action groups that write output buffers to input buffers
     // cannot be safely executed in parallel because they may have two actions
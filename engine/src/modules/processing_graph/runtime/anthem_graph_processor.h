@@ -19,12 +19,40 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <juce_events/juce_events.h>
 
 #include "modules/processing_graph/compiler/anthem_graph_compilation_result.h"
-#include "modules/util/thread_safe_queue.h"
+#include "modules/processing_graph/runtime/anthem_graph_parallel_executor.h"
+#include "modules/util/ring_buffer.h"
+
+// Statistics about the memory that event buffers are allocated from. Sizes are
+// in bytes. See ArenaBufferAllocatorStats.
+struct AnthemEventAllocatorTelemetry {
+  // These are for the most recently compiled graph.
+  size_t capacity = 0;
+  size_t used = 0;
+  size_t highWater = 0;
+  double fragmentation = 0.0;
+
+  // How many times an event buffer grew, and how many times one couldn't
+  // grow because the allocator was full, in the most recently compiled graph.
+  size_t reallocations = 0;
+  size_t overflows = 0;
+
+  // The same, for every graph so far.
+  size_t totalReallocations = 0;
+  size_t totalOverflows = 0;
+
+  // The most that event buffers have grown by in any graph so far. This is
+  // used to size the event allocator for the next graph.
+  size_t growthHighWater = 0;
+};
 
 // This class is used to handle the audio thread concerns of the processing
 // graph. It owns a read-only instance of AnthemGraphTopology as well as a
@@ -37,13 +65,66 @@
 class AnthemGraphProcessor {
 private:
   AnthemGraphCompilationResult* processingSteps;
-  ThreadSafeQueue<AnthemGraphCompilationResult*> processingStepsQueue;
-  ThreadSafeQueue<AnthemGraphCompilationResult*> processingStepsDeletionQueue;
+  SpscRingBuffer<AnthemGraphCompilationResult*> processingStepsQueue;
+  SpscRingBuffer<AnthemGraphCompilationResult*> processingStepsDeletionQueue;
+
+  // Results that didn't fit in processingStepsQueue, oldest first. These are
+  // sent from the message thread once there's room. Only used on the message
+  // thread.
+  std::vector<AnthemGraphCompilationResult*> unsentCompilationResults;
+
+  void sendUnsentCompilationResults();
   juce::TimedCallback clearDeletionQueueTimedCallback;
+
+  // See setPageFaultCountingEnabled().
+  std::atomic<bool> isCountingPageFaults { false };
+  std::atomic<int64_t> pageFaultsInLastBlock { 0 };
+  std::atomic<int64_t> totalPageFaults { 0 };
+  std::atomic<int64_t> blocksWithPageFaults { 0 };
+
+  // Only used on the message thread, to decide whether there's anything new
+  // to report.
+  int64_t lastReportedBlocksWithPageFaults = 0;
+
+  void processBlock(int numSamples, AnthemGraphParallelExecutor* executor);
+
+  // Event allocator telemetry. These are only used on the message thread.
+  //
+  // The latest result is the last one handed to the audio thread. It's only
+  // deleted after a newer one is handed over, so it's safe to read from the
+  // message thread until then.
+  AnthemGraphCompilationResult* latestCompilationResult = nullptr;
+  AnthemEventAllocatorTelemetry retiredEventAllocatorTelemetry;
+
+  // Adds the telemetry from a result that is about to be deleted to the
+  // totals.
+  void recordRetiredCompilationResult(AnthemGraphCompilationResult* result);
+
+  // Logs a message if any blocks have taken page faults since the last time
+  // this was called. Called on the message thread.
+  void reportPageFaults();
 public:
+  struct PageFaultStats {
+    int64_t lastBlock;
+    int64_t total;
+    int64_t blocksWithPageFaults;
+  };
+
   // Processes a single block of audio in the graph. This will also process and
   // propagate MIDI and control data.
-  void process(int numSamples);
+  //
+  // If an executor is given, action groups that can run in parallel are split
+  // across its threads. See AnthemGraphParallelExecutor.
+  void process(int numSamples, AnthemGraphParallelExecutor* executor = nullptr);
+
+  // Gets the processing steps that were used for the last call to process(),
+  // or nullptr if there aren't any yet.
+  //
+  // This must only be called from the thread that calls process(). The result
+  // is only valid until the next call to process().
+  AnthemGraphCompilationResult* getProcessingSteps() {
+    return processingSteps;
+  }
 
   // This function adds a new set of processing steps to the queue. This is
   // intended to be called from the main thread, and the processing steps will
@@ -55,5 +136,31 @@ public:
   // results are added to a deletion queue and then cleared from the main thread.
   void clearDeletionQueueFromMainThread();
 
+  // Turns on counting of page faults taken during each call to process().
+  //
+  // Page faults on the audio thread usually mean it's touching memory for the
+  // first time, or memory that has been paged out, and they're a common
+  // source of clicks. Counting costs a system call per block, so this is off
+  // by default. While it's on, new faults are logged from the message thread
+  // every couple of seconds.
+  //
+  // On Linux, this only counts faults on the thread that calls process(), so
+  // faults on AnthemGraphParallelExecutor workers aren't included. On other
+  // platforms, faults on every thread in the process are counted.
+  void setPageFaultCountingEnabled(bool enabled);
+
+  PageFaultStats getPageFaultStats();
+
+  // Gets statistics about event buffer memory, for the current graph and for
+  // all graphs so far. This must be called on the message thread.
+  AnthemEventAllocatorTelemetry getEventAllocatorTelemetry();
+
+  // The most that event buffers have grown by in any graph so far, including
+  // the current one. Pass this to AnthemGraphTopologySnapshot::create(), so
+  // the next graph's event allocator is sized for it.
+  //
+  // This must be called on the message thread.
+  size_t getEventAllocatorGrowthHighWater();
+
   AnthemGraphProcessor();
 };
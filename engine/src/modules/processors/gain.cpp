@@ -50,10 +50,26 @@ void GainProcessor::process(AnthemProcessContext& context, int numSamples) {
 
   auto& amplitudeControlBuffer = context.getInputControlBuffer(GainProcessorModelBase::gainPortId);
 
+  // The gain usually isn't moving, in which case we don't need a value for
+  // each sample.
+  if (amplitudeControlBuffer.isConstant()) {
+    auto amplitude = amplitudeControlBuffer.getValue(0);
+
+    for (int channel = 0; channel < audioOutBuffer.getNumChannels(); ++channel) {
+      juce::FloatVectorOperations::multiply(
+        audioOutBuffer.getWritePointer(channel), audioInBuffer.getReadPointer(channel), amplitude, numSamples
+      );
+    }
+
+    return;
+  }
+
+  auto* amplitudeSamples = amplitudeControlBuffer.getReadPointer(numSamples);
+
   for (int sample = 0; sample < numSamples; sample++) {
     for (int channel = 0; channel < audioOutBuffer.getNumChannels(); ++channel) {
       auto inputSample = audioInBuffer.getReadPointer(channel)[sample];
-      auto amplitudeSample = amplitudeControlBuffer.getReadPointer(0)[sample];
+      auto amplitudeSample = amplitudeSamples[sample];
 
       audioOutBuffer.getWritePointer(channel)[sample] = inputSample * amplitudeSample;
     }
@@ -21,10 +21,40 @@
 
 #include "modules/core/anthem.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 #include "modules/processing_graph/compiler/anthem_process_context.h"
 
+namespace {
+  // Anything quieter than this is treated as silence. This catches denormals,
+  // and since every comparison with NaN is false, it catches NaN as well.
+  constexpr float silenceThreshold = std::numeric_limits<float>::min();
+
+  constexpr float limit = 1.0f;
+
+  inline float limitSample(float sample) {
+    sample = std::abs(sample) >= silenceThreshold ? sample : 0.0f;
+    return std::clamp(sample, -limit, limit);
+  }
+
+  // These are written as plain loops with no branches in the body, so the
+  // compiler can vectorize the copy, the flush and the clip as one pass.
+  void writeLimited(float* destination, const float* source, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+      destination[i] = limitSample(source[i]);
+    }
+  }
+
+  void writeLimitedMono(float* destination, const float* left, const float* right, int numSamples) {
+    for (int i = 0; i < numSamples; i++) {
+      destination[i] = limitSample(0.5f * (left[i] + right[i]));
+    }
+  }
+}
+
 MasterOutputProcessor::MasterOutputProcessor(const MasterOutputProcessorModelImpl& _impl)
       : AnthemProcessor("MasterOutput"), MasterOutputProcessorModelBase(_impl) {
   buffer = juce::AudioSampleBuffer(Anthem::NUM_CHANNELS, MAX_AUDIO_BUFFER_SIZE);
@@ -32,10 +62,61 @@ MasterOutputProcessor::MasterOutputProcessor(const MasterOutputProcessorModelImp
 
 MasterOutputProcessor::~MasterOutputProcessor() {}
 
+void MasterOutputProcessor::prepareToPlay([[maybe_unused]] double sampleRate, int maxBlockSize) {
+  buffer.setSize(Anthem::NUM_CHANNELS, maxBlockSize);
+  buffer.clear();
+}
+
 void MasterOutputProcessor::process(AnthemProcessContext& context, int numSamples) {
   auto& inputBuffer = context.getInputAudioBuffer(MasterOutputProcessorModelBase::inputPortId);
 
+  if (deviceOutputChannels == nullptr) {
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+      this->buffer.copyFrom(channel, 0, inputBuffer, channel, 0, numSamples);
+    }
+
+    return;
+  }
+
+  auto numInputChannels = std::min(inputBuffer.getNumChannels(), static_cast<int>(Anthem::NUM_CHANNELS));
+
+  for (int channel = 0; channel < numDeviceOutputChannels; channel++) {
+    auto* destination = deviceOutputChannels[channel];
+
+    if (destination == nullptr) {
+      continue;
+    }
+
+    destination += deviceOutputStartSample;
+
+    if (numDeviceOutputChannels == 1 && numInputChannels >= 2) {
+      writeLimitedMono(destination, inputBuffer.getReadPointer(0), inputBuffer.getReadPointer(1), numSamples);
+    } else if (channel < numInputChannels) {
+      writeLimited(destination, inputBuffer.getReadPointer(channel), numSamples);
+    } else {
+      juce::FloatVectorOperations::clear(destination, numSamples);
+    }
+  }
+
+  hasWrittenToDeviceOutput = true;
+}
+
+void MasterOutputProcessor::setDeviceOutput(float* const* channels, int numChannels, int startSample) {
+  deviceOutputChannels = channels;
+  numDeviceOutputChannels = numChannels;
+  deviceOutputStartSample = startSample;
+  hasWrittenToDeviceOutput = false;
+}
+
+void MasterOutputProcessor::clearDeviceOutput() {
+  deviceOutputChannels = nullptr;
+  numDeviceOutputChannels = 0;
+  deviceOutputStartSample = 0;
+}
+
+void MasterOutputProcessor::limitBuffer(int numSamples) {
   for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
-    this->buffer.copyFrom(channel, 0, inputBuffer, channel, 0, numSamples);
+    auto* samples = buffer.getWritePointer(channel);
+    writeLimited(samples, samples, numSamples);
   }
 }
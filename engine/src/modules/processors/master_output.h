@@ -28,7 +28,25 @@
 
 #include "generated/lib/model/processing_graph/processors/master_output.h"
 
+// The final node in the processing graph.
+//
+// By default, this copies its input into buffer, which is read by whatever is
+// driving the graph, e.g. the offline renderer. When processing for the audio
+// device, the audio callback can instead point this at the device's output
+// channels with setDeviceOutput(), and the input is written straight to the
+// device, with no intermediate copy.
+//
+// Anything written to the device goes through a safety limiter, which clips
+// the signal to [-1, 1] and replaces NaNs and denormals with silence. The
+// buffer isn't limited, so renders to float files keep the full signal.
 class MasterOutputProcessor : public AnthemProcessor, public MasterOutputProcessorModelBase {
+private:
+  // Set by the audio callback for the duration of a block. See
+  // setDeviceOutput().
+  float* const* deviceOutputChannels = nullptr;
+  int numDeviceOutputChannels = 0;
+  int deviceOutputStartSample = 0;
+  bool hasWrittenToDeviceOutput = false;
 public:
   juce::AudioSampleBuffer buffer;
 
@@ -45,8 +63,31 @@ public:
     return 0;
   }
 
+  void prepareToPlay(double sampleRate, int maxBlockSize) override;
   void process(AnthemProcessContext& context, int numSamples) override;
 
+  // Makes process() write to the given device channels, starting at
+  // startSample, instead of to buffer. If the device has one channel, the
+  // input is mixed down to mono. If it has more than NUM_CHANNELS, the extra
+  // channels are cleared. Null channel pointers are skipped.
+  //
+  // This must only be called on the thread that drives the graph processor,
+  // and clearDeviceOutput() must be called before the device pointers become
+  // invalid.
+  void setDeviceOutput(float* const* channels, int numChannels, int startSample);
+  void clearDeviceOutput();
+
+  // Whether process() has written to the device output since it was last set.
+  // If it hasn't (e.g. the graph hasn't been compiled yet), the caller needs
+  // to clear the device output itself.
+  bool hasWrittenDeviceOutput() {
+    return hasWrittenToDeviceOutput;
+  }
+
+  // Applies the safety limiter to the first numSamples samples of buffer, for
+  // callers that send buffer to the device themselves.
+  void limitBuffer(int numSamples);
+
   void initialize(std::shared_ptr<AnthemModelBase> self, std::shared_ptr<AnthemModelBase> parent) override {
     MasterOutputProcessorModelBase::initialize(self, parent);
 
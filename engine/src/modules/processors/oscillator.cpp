@@ -0,0 +1,162 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "oscillator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include <juce_core/juce_core.h>
+
+namespace {
+  constexpr double phaseScale = 4294967296.0;
+}
+
+double AnthemOscillator::getFrequencyForPitch(double pitch) {
+  return 440.0 * std::pow(2.0, (pitch - 69.0) / 12.0);
+}
+
+uint32_t AnthemOscillator::getPhaseIncrement(double frequency, double sampleRate) {
+  auto cycles = frequency / sampleRate;
+  cycles -= std::floor(cycles);
+
+  // cycles can round up to exactly 1 here, which wraps to 0, as it should.
+  return static_cast<uint32_t>(static_cast<uint64_t>(cycles * phaseScale));
+}
+
+void AnthemOscillator::getPhaseIncrements(const float* frequencies, double sampleRate, uint32_t* increments, int numSamples) {
+  auto scale = phaseScale / sampleRate;
+
+  for (int i = 0; i < numSamples; i++) {
+    // Going through int64_t means negative frequencies wrap around to the
+    // right increment.
+    increments[i] = static_cast<uint32_t>(static_cast<int64_t>(frequencies[i] * scale));
+  }
+}
+
+AnthemWavetable::AnthemWavetable(const std::vector<double>& harmonicAmplitudes) {
+  auto numHarmonics = std::min(static_cast<int>(harmonicAmplitudes.size()), maxHarmonics);
+
+  // Find the last level that has room for every harmonic. Levels before it
+  // would be the same.
+  firstStoredLevel = 0;
+
+  while (firstStoredLevel < numLevels - 1 && (maxHarmonics >> (firstStoredLevel + 1)) >= numHarmonics) {
+    firstStoredLevel++;
+  }
+
+  auto numStoredLevels = numLevels - firstStoredLevel;
+  samples.assign(static_cast<size_t>(numStoredLevels) * (tableSize + 1), 0.0f);
+
+  // Harmonic n at sample i is sin(2 * pi * n * i / tableSize), so every value
+  // we need is in a single cycle of a sine with tableSize samples.
+  std::vector<double> sine(tableSize);
+
+  for (int i = 0; i < tableSize; i++) {
+    sine[static_cast<size_t>(i)] = std::sin(2.0 * juce::MathConstants<double>::pi * i / tableSize);
+  }
+
+  std::vector<double> level(tableSize);
+
+  for (int storedLevel = 0; storedLevel < numStoredLevels; storedLevel++) {
+    auto levelHarmonics = std::min(numHarmonics, maxHarmonics >> (firstStoredLevel + storedLevel));
+
+    std::fill(level.begin(), level.end(), 0.0);
+
+    for (int harmonic = 1; harmonic <= levelHarmonics; harmonic++) {
+      auto amplitude = harmonicAmplitudes[static_cast<size_t>(harmonic - 1)];
+
+      if (amplitude == 0.0) {
+        continue;
+      }
+
+      for (int i = 0; i < tableSize; i++) {
+        level[static_cast<size_t>(i)] += amplitude * sine[static_cast<size_t>((harmonic * i) % tableSize)];
+      }
+    }
+
+    auto* destination = samples.data() + static_cast<size_t>(storedLevel) * (tableSize + 1);
+
+    for (int i = 0; i < tableSize; i++) {
+      destination[i] = static_cast<float>(level[static_cast<size_t>(i)]);
+    }
+
+    destination[tableSize] = destination[0];
+  }
+}
+
+AnthemWavetable AnthemWavetable::createSine() {
+  return AnthemWavetable({ 1.0 });
+}
+
+AnthemWavetable AnthemWavetable::createSaw() {
+  // The Fourier series for a saw is -(2 / pi) * sum of sin(n * x) / n. The
+  // sign puts the jump from 1 to -1 at the start of the cycle.
+  std::vector<double> harmonics(maxHarmonics);
+
+  for (int n = 1; n <= maxHarmonics; n++) {
+    harmonics[static_cast<size_t>(n - 1)] = -2.0 / (juce::MathConstants<double>::pi * n);
+  }
+
+  return AnthemWavetable(harmonics);
+}
+
+int AnthemWavetable::getLevelForPhaseIncrement(uint32_t increment) {
+  // A negative increment plays the same harmonics as a positive one.
+  if (increment > 0x80000000u) {
+    increment = 0u - increment;
+  }
+
+  // Level k has maxHarmonics >> k harmonics. The highest one is below Nyquist
+  // if increment * (maxHarmonics >> k) < 2^31, which works out to the
+  // increment having at most (32 - numLevels) + k significant bits.
+  auto level = static_cast<int>(std::bit_width(increment)) - (32 - numLevels);
+
+  return std::clamp(level, 0, numLevels - 1);
+}
+
+void AnthemWavetable::render(uint32_t& phase, uint32_t increment, float* output, int numSamples) const {
+  auto* level = getLevel(getLevelForPhaseIncrement(increment));
+  auto startPhase = phase;
+
+  // Each phase is worked out from the start of the block rather than from
+  // the sample before, so there's no dependency between samples.
+  for (int i = 0; i < numSamples; i++) {
+    output[i] = lookup(level, startPhase + static_cast<uint32_t>(i) * increment);
+  }
+
+  phase = startPhase + static_cast<uint32_t>(numSamples) * increment;
+}
+
+void AnthemWavetable::render(uint32_t& phase, const uint32_t* increments, float* output, int numSamples) const {
+  uint32_t highestIncrement = 0;
+
+  for (int i = 0; i < numSamples; i++) {
+    auto increment = increments[i];
+    highestIncrement = std::max(highestIncrement, increment > 0x80000000u ? 0u - increment : increment);
+  }
+
+  auto* level = getLevel(getLevelForPhaseIncrement(highestIncrement));
+
+  for (int i = 0; i < numSamples; i++) {
+    output[i] = lookup(level, phase);
+    phase += increments[i];
+  }
+}
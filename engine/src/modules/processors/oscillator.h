@@ -0,0 +1,128 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Building blocks for oscillators in instruments.
+//
+// Phases are fixed-point: a uint32_t where 2^32 is one full cycle. Adding a
+// phase increment wraps around at the end of the cycle for free, so there's
+// no fmod, and the phase never loses precision however long a note plays.
+namespace AnthemOscillator {
+  // The frequency of a pitch in semitones, where 69 is A4 (440 Hz), as in
+  // MIDI. This calls std::pow, so it should be worked out when a note starts
+  // or a pitch changes, not for every sample.
+  double getFrequencyForPitch(double pitch);
+
+  // The amount to advance the phase by each sample to play the given
+  // frequency. Negative frequencies play backwards.
+  uint32_t getPhaseIncrement(double frequency, double sampleRate);
+
+  // Converts a frequency for each sample to a phase increment for each
+  // sample. This is much cheaper than getPhaseIncrement(), but frequencies
+  // must be less than 2^31 times the sample rate.
+  void getPhaseIncrements(const float* frequencies, double sampleRate, uint32_t* increments, int numSamples);
+}
+
+// A single cycle of a waveform, stored as a set of band-limited tables.
+//
+// A waveform with sharp edges, like a saw, has harmonics all the way up. If
+// we play it back at a high pitch, the harmonics above Nyquist fold back
+// down as aliasing. To avoid that, we keep a copy of the table (a level) for
+// each octave, where each level has half as many harmonics as the one
+// before it. Oscillators pick the level for the pitch they're playing, so
+// that every harmonic they play is below Nyquist.
+//
+// Tables are built with additive synthesis, which allocates and is slow, so
+// they should be created on the message thread. Reading from them is real-time
+// safe.
+class AnthemWavetable {
+public:
+  // Each level has 2^tableBits samples, plus one more at the end that repeats
+  // the first, so that interpolation never has to wrap.
+  static constexpr int tableBits = 11;
+  static constexpr int tableSize = 1 << tableBits;
+
+  // Level 0 has maxHarmonics harmonics, which is plenty for the lowest notes
+  // at any sample rate, and the last level has just the fundamental.
+  static constexpr int numLevels = 10;
+  static constexpr int maxHarmonics = 1 << (numLevels - 1);
+private:
+  static constexpr int fractionBits = 32 - tableBits;
+  static constexpr uint32_t fractionMask = (1u << fractionBits) - 1;
+  static constexpr float fractionScale = 1.0f / static_cast<float>(1u << fractionBits);
+
+  std::vector<float> samples;
+
+  // Levels with at least as many harmonics as the waveform has are all the
+  // same, so we only store one of them. This is the first level that is
+  // stored. For a sine, it's the last level, and only one level is stored.
+  int firstStoredLevel;
+public:
+  // Creates a wavetable from the amplitude of each harmonic, starting with
+  // the fundamental. Each harmonic is a sine, starting at phase 0. Harmonics
+  // past maxHarmonics are ignored.
+  AnthemWavetable(const std::vector<double>& harmonicAmplitudes);
+
+  static AnthemWavetable createSine();
+
+  // A saw that rises from -1 to 1 over the cycle, before band-limiting.
+  static AnthemWavetable createSaw();
+
+  // Gets the level to use for the given phase increment. This is the level
+  // with the most harmonics where every harmonic is below Nyquist.
+  static int getLevelForPhaseIncrement(uint32_t increment);
+
+  // Gets the samples for a level. See getLevelForPhaseIncrement().
+  const float* getLevel(int level) const {
+    auto storedLevel = level > firstStoredLevel ? level - firstStoredLevel : 0;
+    return samples.data() + static_cast<size_t>(storedLevel) * (tableSize + 1);
+  }
+
+  // Reads a level at the given phase, with linear interpolation.
+  //
+  // This is branch-free, so in loops over several voices or samples, the
+  // compiler can vectorize everything but the two table reads. Those need a
+  // gather, which baseline x86-64 doesn't have.
+  static float lookup(const float* level, uint32_t phase) {
+    auto index = phase >> fractionBits;
+
+    // Converting from a signed int is much cheaper to vectorize, and the
+    // fraction always fits.
+    auto fraction = static_cast<float>(static_cast<int32_t>(phase & fractionMask)) * fractionScale;
+
+    auto a = level[index];
+    auto b = level[index + 1];
+
+    return a + fraction * (b - a);
+  }
+
+  // Writes numSamples samples at a fixed phase increment, and advances the
+  // phase.
+  void render(uint32_t& phase, uint32_t increment, float* output, int numSamples) const;
+
+  // Writes numSamples samples with a separate phase increment for each
+  // sample, and advances the phase. The level is picked for the highest
+  // increment, so nothing in the block aliases.
+  void render(uint32_t& phase, const uint32_t* increments, float* output, int numSamples) const;
+};
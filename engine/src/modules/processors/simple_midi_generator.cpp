@@ -19,13 +19,15 @@
 
 #include "simple_midi_generator.h"
 
+#include <algorithm>
+
 #include "modules/processing_graph/compiler/anthem_process_context.h"
 #include "modules/sequencer/events/event.h"
 
 SimpleMidiGeneratorProcessor::SimpleMidiGeneratorProcessor(const SimpleMidiGeneratorProcessorModelImpl& _impl)
     : AnthemProcessor("SimpleMidiGenerator"), SimpleMidiGeneratorProcessorModelBase(_impl) {
-  sampleRate = 44100; // TODO: This should be dynamic - in the context maybe?
-  durationSamples = 22050;
+  sampleRate = DEFAULT_SAMPLE_RATE;
+  durationSamples = static_cast<size_t>(sampleRate / 2);
   velocity = 80;
   noteOn = false;
 
@@ -36,6 +38,20 @@ SimpleMidiGeneratorProcessor::SimpleMidiGeneratorProcessor(const SimpleMidiGener
 
 SimpleMidiGeneratorProcessor::~SimpleMidiGeneratorProcessor() {}
 
+void SimpleMidiGeneratorProcessor::prepareToPlay(double sampleRate, [[maybe_unused]] int maxBlockSize) {
+  this->sampleRate = sampleRate;
+
+  // Each note lasts half a second.
+  durationSamples = static_cast<size_t>(sampleRate / 2);
+  currentNoteDuration = std::min(currentNoteDuration, durationSamples);
+}
+
+size_t SimpleMidiGeneratorProcessor::getMaxEventsPerBlock([[maybe_unused]] int32_t portId, int maxBlockSize) {
+  // The first block has an extra note on, and after that, each note that ends
+  // in the block adds a note off and a note on.
+  return 1 + 2 * (static_cast<size_t>(maxBlockSize) / durationSamples + 1);
+}
+
 void SimpleMidiGeneratorProcessor::process(AnthemProcessContext& context, int numSamples) {
   auto& midiOutBuffer = context.getOutputNoteEventBuffer(SimpleMidiGeneratorProcessorModelBase::midiOutputPortId);
 
@@ -44,15 +60,7 @@ void SimpleMidiGeneratorProcessor::process(AnthemProcessContext& context, int nu
     currentNoteId = 0;
     currentNoteDuration = 0;
     midiOutBuffer->addEvent(
-      AnthemLiveEvent {
-        .time = AnthemLiveTime {
-          .offset = 0
-        },
-        .event = AnthemEvent {
-          .type = AnthemEventType::NoteOn,
-          .noteOn = AnthemNoteOnEvent(currentNote, 0, static_cast<float>(velocity), 0.0f, currentNoteId)
-        }
-      }
+      AnthemLiveEvent::createNoteOn(0, 0, currentNote, static_cast<float>(velocity), currentNoteId)
     );
 
     noteOn = true;
@@ -61,24 +69,12 @@ void SimpleMidiGeneratorProcessor::process(AnthemProcessContext& context, int nu
   size_t samplesLeft = static_cast<size_t>(numSamples);
 
   while (samplesLeft > 0) {
-    size_t samplesToProcess = std::min(
-      samplesLeft,
-      durationSamples - currentNoteDuration
-    );
-
-    currentNoteDuration += samplesToProcess;
-    samplesLeft -= samplesToProcess;
-
+    // A note that ends exactly at the end of a block is switched at the start
+    // of the next one, so every event lands inside the block that sends it.
     if (currentNoteDuration >= durationSamples) {
-      AnthemLiveEvent noteOffEvent = AnthemLiveEvent {
-        .time = AnthemLiveTime {
-          .offset = 0
-        },
-        .event = AnthemEvent {
-          .type = AnthemEventType::NoteOff,
-          .noteOff = AnthemNoteOffEvent(currentNote, 0, 0.0f, currentNoteId)
-        }
-      };
+      auto offset = static_cast<int32_t>(static_cast<size_t>(numSamples) - samplesLeft);
+
+      AnthemLiveEvent noteOffEvent = AnthemLiveEvent::createNoteOff(offset, 0, currentNote, 0.0f, currentNoteId);
 
       midiOutBuffer->addEvent(noteOffEvent);
 
@@ -91,17 +87,17 @@ void SimpleMidiGeneratorProcessor::process(AnthemProcessContext& context, int nu
         currentNote = 50;
       }
 
-      AnthemLiveEvent noteOnEvent = AnthemLiveEvent {
-        .time = AnthemLiveTime {
-          .offset = 0
-        },
-        .event = AnthemEvent {
-          .type = AnthemEventType::NoteOn,
-          .noteOn = AnthemNoteOnEvent(currentNote, 0, static_cast<float>(velocity), 0.0f, currentNoteId)
-        }
-      };
+      AnthemLiveEvent noteOnEvent = AnthemLiveEvent::createNoteOn(offset, 0, currentNote, static_cast<float>(velocity), currentNoteId);
 
       midiOutBuffer->addEvent(noteOnEvent);
     }
+
+    size_t samplesToProcess = std::min(
+      samplesLeft,
+      durationSamples - currentNoteDuration
+    );
+
+    currentNoteDuration += samplesToProcess;
+    samplesLeft -= samplesToProcess;
   }
 }
@@ -46,5 +46,7 @@ public:
     return 0;
   }
 
+  void prepareToPlay(double sampleRate, int maxBlockSize) override;
+  size_t getMaxEventsPerBlock(int32_t portId, int maxBlockSize) override;
   void process(AnthemProcessContext& context, int numSamples) override;
 };
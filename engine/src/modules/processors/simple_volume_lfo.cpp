@@ -25,6 +25,7 @@ SimpleVolumeLfoProcessor::SimpleVolumeLfoProcessor(const SimpleVolumeLfoProcesso
   : AnthemProcessor("SimpleVolumeLfo"), SimpleVolumeLfoProcessorModelBase(_impl) {
   rate = 0.0001f;
   amplitude = 1;
+  increasing = false;
 }
 
 SimpleVolumeLfoProcessor::~SimpleVolumeLfoProcessor() {}
@@ -19,69 +19,195 @@
 
 #include "tone_generator.h"
 
+#include <algorithm>
 #include <iostream>
-#include <cmath>
 
 #include "modules/processing_graph/compiler/anthem_process_context.h"
 
 ToneGeneratorProcessor::ToneGeneratorProcessor(const ToneGeneratorProcessorModelImpl& _impl)
-      : AnthemProcessor("ToneGenerator"), ToneGeneratorProcessorModelBase(_impl) {
+      : AnthemProcessor("ToneGenerator"), ToneGeneratorProcessorModelBase(_impl),
+        sineTable(AnthemWavetable::createSine()),
+        voiceAllocator(maxVoices) {
   phase = 0;
-  // amplitude = 0.125;
-  // this->frequency = frequency;
-  sampleRate = 44100.0; // TODO: This should be dynamic - in the context maybe?
-
-  hasNoteOverride = false;
-  noteOverride = 0;
+  sampleRate = DEFAULT_SAMPLE_RATE;
+  envelopeStep = static_cast<float>(1.0 / (envelopeSeconds * sampleRate));
 }
 
 ToneGeneratorProcessor::~ToneGeneratorProcessor() {}
 
+void ToneGeneratorProcessor::prepareToPlay(double sampleRate, int maxBlockSize) {
+  this->sampleRate = sampleRate;
+  envelopeStep = static_cast<float>(1.0 / (envelopeSeconds * sampleRate));
+
+  phaseIncrements.assign(static_cast<size_t>(maxBlockSize), 0u);
+  voiceMix.assign(static_cast<size_t>(maxBlockSize), 0.0f);
+
+  // Phase increments depend on the sample rate, so we stop any notes that
+  // are playing.
+  voiceAllocator.reset();
+  voicePhase.fill(0u);
+  voicePhaseIncrement.fill(0u);
+  voiceGain.fill(0.0f);
+  voiceGainStep.fill(0.0f);
+}
+
 void ToneGeneratorProcessor::process(AnthemProcessContext& context, int numSamples) {
   auto& audioOutBuffer = context.getOutputAudioBuffer(ToneGeneratorProcessorModelBase::audioOutputPortId);
 
   auto& frequencyControlBuffer = context.getInputControlBuffer(ToneGeneratorProcessorModelBase::frequencyPortId);
   auto& amplitudeControlBuffer = context.getInputControlBuffer(ToneGeneratorProcessorModelBase::amplitudePortId);
 
-  // Process incoming MIDI events
-  auto& midiInBuffer = context.getInputNoteEventBuffer(ToneGeneratorProcessorModelBase::midiInputPortId);
+  // The frequency usually doesn't change within a block, so we only convert
+  // it to a phase increment once.
+  if (frequencyControlBuffer.isConstant()) {
+    auto increment = AnthemOscillator::getPhaseIncrement(frequencyControlBuffer.getValue(0), sampleRate);
+    std::fill(phaseIncrements.begin(), phaseIncrements.begin() + numSamples, increment);
+  } else {
+    AnthemOscillator::getPhaseIncrements(
+      frequencyControlBuffer.getReadPointer(numSamples), sampleRate, phaseIncrements.data(), numSamples
+    );
+  }
 
-  for (size_t i = 0; i < midiInBuffer->getNumEvents(); ++i) {
-    auto& liveEvent = midiInBuffer->getEvent(i);
+  auto* amplitudeSamples = amplitudeControlBuffer.getReadPointer(numSamples);
 
-    if (liveEvent.event.type == AnthemEventType::NoteOn) {
-      hasNoteOverride = true;
-      noteOverride = liveEvent.event.noteOn.pitch;
+  auto* midiInBuffer = context.getInputNoteEventBuffer(ToneGeneratorProcessorModelBase::midiInputPortId);
 
-      // We're deliberately ignoring the live timing information here for
-      // simplicity. This would not be correct for a real device - we should be
-      // reading liveEvent.time, which represents the time since the start of
-      // the processing block.
+  // Each event is applied on its own sample.
+  AnthemVoiceAllocator::splitBlockAtEvents(
+    midiInBuffer,
+    numSamples,
+    [&](const AnthemLiveEvent& event) {
+      handleEvent(event);
+    },
+    [&](int startSample, int endSample) {
+      render(startSample, endSample, amplitudeSamples, audioOutBuffer);
+    }
+  );
+}
 
-    } else if (liveEvent.event.type == AnthemEventType::NoteOff) {
-      hasNoteOverride = false;
+void ToneGeneratorProcessor::handleEvent(const AnthemLiveEvent& event) {
+  if (event.type == AnthemEventType::NoteOn) {
+    auto allocation = voiceAllocator.startVoice(event);
+    auto i = static_cast<size_t>(allocation.voiceIndex);
+
+    // The frequency only depends on the pitch, so we work it out once here
+    // rather than for every sample. Velocity is ignored.
+    auto frequency = AnthemOscillator::getFrequencyForPitch(event.pitch);
+
+    // A stolen voice is cut off and starts again from silence.
+    voicePhase[i] = 0u;
+    voicePhaseIncrement[i] = AnthemOscillator::getPhaseIncrement(frequency, sampleRate);
+    voiceGain[i] = 0.0f;
+    voiceGainStep[i] = envelopeStep;
+  } else if (event.type == AnthemEventType::NoteOff) {
+    auto count = voiceAllocator.releaseVoices(event, releasedVoiceIndices.data());
+
+    for (int j = 0; j < count; j++) {
+      voiceGainStep[static_cast<size_t>(releasedVoiceIndices[static_cast<size_t>(j)])] = -envelopeStep;
     }
   }
+}
+
+void ToneGeneratorProcessor::render(
+  int startSample,
+  int endSample,
+  const float* amplitudeSamples,
+  juce::AudioSampleBuffer& audioOutBuffer
+) {
+  auto numSamples = endSample - startSample;
 
-  // Generate a sine wave
-  for (int sample = 0; sample < numSamples; ++sample) {
-    auto frequency = frequencyControlBuffer.getReadPointer(0)[sample];
-    auto amplitude = amplitudeControlBuffer.getReadPointer(0)[sample];
+  if (voiceAllocator.getNumActiveVoices() == 0) {
+    auto* out = audioOutBuffer.getWritePointer(0) + startSample;
 
-    if (hasNoteOverride) {
-      frequency = 440.0f * std::pow(2.0f, (noteOverride - 69) / 12.0f);
+    sineTable.render(phase, phaseIncrements.data() + startSample, out, numSamples);
+    juce::FloatVectorOperations::multiply(out, amplitudeSamples + startSample, numSamples);
+
+    for (int channel = 1; channel < audioOutBuffer.getNumChannels(); ++channel) {
+      juce::FloatVectorOperations::copy(audioOutBuffer.getWritePointer(channel) + startSample, out, numSamples);
     }
 
-    const float value = amplitude * (float) std::sin(
-      2.0 * juce::MathConstants<float>::pi * phase
-    );
+    return;
+  }
+
+  renderVoices(startSample, endSample);
+
+  for (int channel = 0; channel < audioOutBuffer.getNumChannels(); ++channel) {
+    auto* out = audioOutBuffer.getWritePointer(channel);
+
+    for (int sample = startSample; sample < endSample; ++sample) {
+      out[sample] = amplitudeSamples[sample] * voiceMix[static_cast<size_t>(sample)];
+    }
+  }
+
+  // Voices that have finished fading out are freed.
+  for (int i = 0; i < maxVoices; i++) {
+    auto& voice = voiceAllocator.getVoice(i);
 
-    for (int channel = 0; channel < audioOutBuffer.getNumChannels(); ++channel) {
-      audioOutBuffer.getWritePointer(channel)[sample] = value;
+    if (voice.isActive && voice.isReleased && voiceGain[static_cast<size_t>(i)] <= 0.0f) {
+      voiceAllocator.freeVoice(i);
+      voicePhaseIncrement[static_cast<size_t>(i)] = 0u;
+      voiceGainStep[static_cast<size_t>(i)] = 0.0f;
     }
+  }
+}
 
-    // Increment phase based on frequency
-    phase = std::fmod((phase + (frequency / sampleRate)), 1.0);
+void ToneGeneratorProcessor::renderVoices(int startSample, int endSample) {
+  std::fill(voiceMix.begin() + startSample, voiceMix.begin() + endSample, 0.0f);
+
+  // A sine has no harmonics to band-limit, so every level is the same.
+  auto* sine = sineTable.getLevel(0);
+
+  for (int group = 0; group < maxVoices; group += voiceLaneCount) {
+    bool isGroupActive = false;
+
+    for (int lane = 0; lane < voiceLaneCount; lane++) {
+      isGroupActive = isGroupActive || voiceAllocator.getVoice(group + lane).isActive;
+    }
+
+    // Voices are handed out lowest index first, so most groups are usually
+    // empty.
+    if (!isGroupActive) {
+      continue;
+    }
+
+    // We copy the group into locals, so that the compiler can keep it in
+    // registers for the whole loop. The inner loop works on every lane at
+    // once, with no branches.
+    alignas(32) uint32_t phases[voiceLaneCount];
+    alignas(32) uint32_t increments[voiceLaneCount];
+    alignas(32) float gains[voiceLaneCount];
+    alignas(32) float gainSteps[voiceLaneCount];
+
+    for (int lane = 0; lane < voiceLaneCount; lane++) {
+      auto i = static_cast<size_t>(group + lane);
+      phases[lane] = voicePhase[i];
+      increments[lane] = voicePhaseIncrement[i];
+      gains[lane] = voiceGain[i];
+      gainSteps[lane] = voiceGainStep[i];
+    }
+
+    for (int sample = startSample; sample < endSample; sample++) {
+      alignas(32) float values[voiceLaneCount];
+
+      for (int lane = 0; lane < voiceLaneCount; lane++) {
+        // std::clamp would compile to branches here.
+        gains[lane] = std::min(std::max(gains[lane] + gainSteps[lane], 0.0f), 1.0f);
+        values[lane] = gains[lane] * AnthemWavetable::lookup(sine, phases[lane]);
+        phases[lane] += increments[lane];
+      }
+
+      // The compiler won't reorder float additions by itself, so we add the
+      // lanes in pairs to keep the sum in vector registers.
+      static_assert(voiceLaneCount == 8);
+      voiceMix[static_cast<size_t>(sample)] +=
+        ((values[0] + values[1]) + (values[2] + values[3])) + ((values[4] + values[5]) + (values[6] + values[7]));
+    }
+
+    for (int lane = 0; lane < voiceLaneCount; lane++) {
+      auto i = static_cast<size_t>(group + lane);
+      voicePhase[i] = phases[lane];
+      voiceGain[i] = gains[lane];
+    }
   }
 }
 
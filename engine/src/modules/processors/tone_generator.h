@@ -19,18 +19,67 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
+#include <vector>
+
+#include <juce_audio_basics/juce_audio_basics.h>
 
 #include "generated/lib/model/model.h"
 #include "modules/processing_graph/processor/anthem_processor.h"
+#include "modules/processors/oscillator.h"
+#include "modules/processors/voice_allocator.h"
 
+// Plays a sine wave for each incoming note, or a single sine wave at the
+// frequency parameter if no notes are playing.
 class ToneGeneratorProcessor : public AnthemProcessor, public ToneGeneratorProcessorModelBase {
 private:
-  double phase;
+  static constexpr int maxVoices = 128;
+
+  // Voices are rendered in groups of this many, one voice per lane, so that
+  // each group fits in a single AVX register.
+  static constexpr int voiceLaneCount = 8;
+
+  static_assert(maxVoices % voiceLaneCount == 0);
+
+  AnthemWavetable sineTable;
+
+  // The phase for the tone that plays when there are no notes.
+  uint32_t phase;
   double sampleRate;
 
-  bool hasNoteOverride;
-  int noteOverride;
+  AnthemVoiceAllocator voiceAllocator;
+
+  // The state for each voice, indexed the same way as the voices in
+  // voiceAllocator. Each field has its own array, so that a group of voices
+  // can be loaded into vector registers together. Voices that aren't playing
+  // have a gain of 0, so they can be rendered along with the others.
+  alignas(32) std::array<uint32_t, maxVoices> voicePhase {};
+  alignas(32) std::array<uint32_t, maxVoices> voicePhaseIncrement {};
+  alignas(32) std::array<float, maxVoices> voiceGain {};
+  alignas(32) std::array<float, maxVoices> voiceGainStep {};
+
+  // Voices fade in and out over this many seconds, to avoid clicks.
+  static constexpr double envelopeSeconds = 0.005;
+  float envelopeStep;
+
+  // Scratch space, allocated in prepareToPlay().
+  std::vector<uint32_t> phaseIncrements;
+  std::vector<float> voiceMix;
+  std::array<int, maxVoices> releasedVoiceIndices {};
+
+  void handleEvent(const AnthemLiveEvent& event);
+
+  // Renders the samples in [startSample, endSample) into the output.
+  void render(
+    int startSample,
+    int endSample,
+    const float* amplitudeSamples,
+    juce::AudioSampleBuffer& audioOutBuffer
+  );
+
+  // Adds the voices that are playing to voiceMix.
+  void renderVoices(int startSample, int endSample);
 public:
   ToneGeneratorProcessor(const ToneGeneratorProcessorModelImpl& _impl);
   ~ToneGeneratorProcessor() override;
@@ -41,6 +90,7 @@ public:
   ToneGeneratorProcessor(ToneGeneratorProcessor&&) noexcept = default;
   ToneGeneratorProcessor& operator=(ToneGeneratorProcessor&&) noexcept = default;
 
+  void prepareToPlay(double sampleRate, int maxBlockSize) override;
   void process(AnthemProcessContext& context, int numSamples) override;
 
   void initialize(std::shared_ptr<AnthemModelBase> self, std::shared_ptr<AnthemModelBase> parent) override;
@@ -0,0 +1,116 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "voice_allocator.h"
+
+#include <juce_core/juce_core.h>
+
+AnthemVoiceAllocator::Allocation AnthemVoiceAllocator::startVoice(const AnthemLiveEvent& noteOn) {
+  jassert(!voices.empty());
+
+  int voiceIndex = -1;
+  bool isStolen = false;
+
+  for (size_t i = 0; i < voices.size(); i++) {
+    if (!voices[i].isActive) {
+      voiceIndex = static_cast<int>(i);
+      break;
+    }
+  }
+
+  if (voiceIndex < 0) {
+    isStolen = true;
+    voiceIndex = 0;
+
+    // Released voices are usually fading out, so they're the least likely to
+    // be missed. Otherwise, we take the oldest voice.
+    for (size_t i = 1; i < voices.size(); i++) {
+      auto& voice = voices[i];
+      auto& best = voices[static_cast<size_t>(voiceIndex)];
+
+      bool isBetter = voice.isReleased != best.isReleased
+        ? voice.isReleased
+        : voice.startOrder < best.startOrder;
+
+      if (isBetter) {
+        voiceIndex = static_cast<int>(i);
+      }
+    }
+  } else {
+    numActiveVoices++;
+  }
+
+  voices[static_cast<size_t>(voiceIndex)] = AnthemVoice {
+    .isActive = true,
+    .isReleased = false,
+    .noteId = noteOn.noteOn.id,
+    .pitch = noteOn.pitch,
+    .channel = noteOn.channel,
+    .velocity = noteOn.noteOn.velocity,
+    .startOrder = nextStartOrder++,
+  };
+
+  return Allocation {
+    .voiceIndex = voiceIndex,
+    .isStolen = isStolen,
+  };
+}
+
+bool AnthemVoiceAllocator::matchesNoteOff(const AnthemVoice& voice, const AnthemLiveEvent& noteOff) const {
+  if (!voice.isActive || voice.isReleased) {
+    return false;
+  }
+
+  if (noteOff.noteOff.id != -1) {
+    return voice.noteId == noteOff.noteOff.id;
+  }
+
+  return voice.pitch == noteOff.pitch && voice.channel == noteOff.channel;
+}
+
+int AnthemVoiceAllocator::releaseVoices(const AnthemLiveEvent& noteOff, int* releasedVoiceIndices) {
+  int count = 0;
+
+  for (size_t i = 0; i < voices.size(); i++) {
+    if (matchesNoteOff(voices[i], noteOff)) {
+      voices[i].isReleased = true;
+      releasedVoiceIndices[count++] = static_cast<int>(i);
+    }
+  }
+
+  return count;
+}
+
+void AnthemVoiceAllocator::freeVoice(int voiceIndex) {
+  auto& voice = voices[static_cast<size_t>(voiceIndex)];
+
+  if (voice.isActive) {
+    voice.isActive = false;
+    voice.isReleased = false;
+    numActiveVoices--;
+  }
+}
+
+void AnthemVoiceAllocator::reset() {
+  for (auto& voice : voices) {
+    voice = AnthemVoice();
+  }
+
+  numActiveVoices = 0;
+}
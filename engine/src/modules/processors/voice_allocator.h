@@ -0,0 +1,136 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "modules/processing_graph/processor/anthem_event_buffer.h"
+#include "modules/sequencer/events/event.h"
+
+// A voice in an instrument, which plays a single note.
+struct AnthemVoice {
+  // Whether the voice is playing. Released voices are still active until
+  // the instrument frees them, e.g. once their release has finished.
+  bool isActive = false;
+
+  // Whether the voice has received a note off.
+  bool isReleased = false;
+
+  int32_t noteId = -1;
+  int16_t pitch = 0;
+  uint8_t channel = 0;
+  float velocity = 0.0f;
+
+  // Increases with each voice that is started. Used to find the oldest voice
+  // when stealing.
+  uint64_t startOrder = 0;
+};
+
+// Keeps track of which voices in an instrument are playing which notes.
+//
+// The number of voices is fixed when the allocator is created, so nothing is
+// allocated on the audio thread. When every voice is in use, a new note
+// steals a voice: the oldest released voice if there is one, and otherwise
+// the oldest voice.
+//
+// This only tracks voices. Instruments keep the state for each voice (phase,
+// envelope, etc.) in their own arrays, indexed the same way, so they can
+// store it in whatever layout is fastest to render. Free voices are always
+// handed out lowest index first, which keeps the voices that are playing
+// packed toward the start of those arrays.
+class AnthemVoiceAllocator {
+  std::vector<AnthemVoice> voices;
+  int numActiveVoices = 0;
+  uint64_t nextStartOrder = 0;
+
+  bool matchesNoteOff(const AnthemVoice& voice, const AnthemLiveEvent& noteOff) const;
+public:
+  AnthemVoiceAllocator(int maxVoices = 0) : voices(static_cast<size_t>(maxVoices)) {}
+
+  struct Allocation {
+    int voiceIndex;
+
+    // True if the voice was playing another note, which has been cut off.
+    bool isStolen;
+  };
+
+  // Starts a voice for a note on event, stealing one if needed.
+  //
+  // The allocator must have at least one voice.
+  Allocation startVoice(const AnthemLiveEvent& noteOn);
+
+  // Marks the voices playing the note in a note off event as released, and
+  // returns how many there were.
+  //
+  // Notes are matched by ID. A note off with an ID of -1 matches every voice
+  // with the same pitch and channel, as in CLAP. The indices of the released
+  // voices are written to releasedVoiceIndices, which must have room for
+  // getMaxVoices() entries.
+  int releaseVoices(const AnthemLiveEvent& noteOff, int* releasedVoiceIndices);
+
+  // Makes a voice available again.
+  void freeVoice(int voiceIndex);
+
+  // Frees every voice.
+  void reset();
+
+  const AnthemVoice& getVoice(int voiceIndex) const {
+    return voices[static_cast<size_t>(voiceIndex)];
+  }
+
+  int getMaxVoices() const {
+    return static_cast<int>(voices.size());
+  }
+
+  int getNumActiveVoices() const {
+    return numActiveVoices;
+  }
+
+  // Splits a block at the times of the given events, so that instruments can
+  // render everything between two events in one go and still apply each
+  // event on the right sample.
+  //
+  // Calls render(startSample, endSample) for each stretch of samples, and
+  // handleEvent(event) for each event, in time order. Empty stretches are
+  // skipped. Events outside the block are handled at its first or last
+  // sample.
+  template <typename HandleEvent, typename Render>
+  static void splitBlockAtEvents(const AnthemEventBuffer* events, int numSamples, HandleEvent&& handleEvent, Render&& render) {
+    int sample = 0;
+
+    for (size_t i = 0; i < events->getNumEvents(); i++) {
+      auto& event = events->getEvent(i);
+      auto eventSample = std::clamp(event.time.offset, 0, std::max(numSamples - 1, 0));
+
+      if (eventSample > sample) {
+        render(sample, eventSample);
+        sample = eventSample;
+      }
+
+      handleEvent(event);
+    }
+
+    if (sample < numSamples) {
+      render(sample, numSamples);
+    }
+  }
+};
@@ -0,0 +1,294 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "anthem_offline_renderer.h"
+
+#include <algorithm>
+
+#include "modules/core/anthem.h"
+#include "modules/core/constants.h"
+
+// The number of samples the file writer can buffer before the render thread
+// has to wait for it.
+static const int WRITER_BUFFER_SIZE = 1 << 18;
+
+// The most threads to use for writing files. Encoding is cheap next to
+// processing the graph, so a couple of threads can keep up with many files.
+static const int MAX_WRITER_THREADS = 2;
+
+AnthemOfflineRenderer::AnthemOfflineRenderer(
+  AnthemGraphProcessor* graphProcessor,
+  std::shared_ptr<MasterOutputProcessor> masterOutputProcessor,
+  AnthemOfflineRenderOptions options,
+  CompletionCallback onComplete
+) : juce::Thread("AnthemOfflineRenderer"),
+    graphProcessor(graphProcessor),
+    masterOutputProcessorSharedPtr(std::move(masterOutputProcessor)),
+    options(std::move(options)),
+    onComplete(std::move(onComplete)) {
+  this->masterOutputProcessor = masterOutputProcessorSharedPtr.get();
+}
+
+AnthemOfflineRenderer::~AnthemOfflineRenderer() {
+  stopThread(10000);
+}
+
+void AnthemOfflineRenderer::start() {
+  startThread(juce::Thread::Priority::high);
+}
+
+void AnthemOfflineRenderer::cancel() {
+  signalThreadShouldExit();
+}
+
+std::unique_ptr<juce::AudioFormatWriter> AnthemOfflineRenderer::createWriter(
+  const juce::File& file,
+  RenderFileFormat format,
+  double sampleRate,
+  int numChannels,
+  int bitDepth,
+  std::string& error
+) {
+  std::unique_ptr<juce::AudioFormat> audioFormat;
+
+  switch (format) {
+    case RenderFileFormat::wav:
+      audioFormat = std::make_unique<juce::WavAudioFormat>();
+      break;
+    case RenderFileFormat::flac:
+      audioFormat = std::make_unique<juce::FlacAudioFormat>();
+      break;
+  }
+
+  if (!audioFormat->getPossibleBitDepths().contains(bitDepth)) {
+    error = "Bit depth " + std::to_string(bitDepth) + " is not supported for " + audioFormat->getFormatName().toStdString() + " files.";
+    return nullptr;
+  }
+
+  file.deleteFile();
+
+  auto stream = file.createOutputStream();
+
+  if (stream == nullptr) {
+    error = "Could not open " + file.getFullPathName().toStdString() + " for writing.";
+    return nullptr;
+  }
+
+  auto* writer = audioFormat->createWriterFor(
+    stream.get(),
+    sampleRate,
+    static_cast<unsigned int>(numChannels),
+    bitDepth,
+    {},
+    0
+  );
+
+  if (writer == nullptr) {
+    error = "Could not create a " + audioFormat->getFormatName().toStdString() + " writer.";
+    return nullptr;
+  }
+
+  // The writer owns the stream now.
+  stream.release();
+
+  return std::unique_ptr<juce::AudioFormatWriter>(writer);
+}
+
+void AnthemOfflineRenderer::run() {
+  // See modules/util/denormals.h.
+  juce::ScopedNoDenormals noDenormals;
+
+  auto result = render();
+
+  juce::MessageManager::callAsync([onComplete = onComplete, result]() {
+    onComplete(result);
+  });
+}
+
+void AnthemOfflineRenderer::findTapSources(std::vector<Output>& outputs, AnthemGraphCompilationResult* processingSteps) {
+  for (auto& output : outputs) {
+    if (!output.tap.has_value()) {
+      continue;
+    }
+
+    output.source = nullptr;
+
+    if (processingSteps == nullptr) {
+      continue;
+    }
+
+    auto contextIter = processingSteps->processContextsByNodeId.find(output.tap->nodeId);
+
+    if (contextIter == processingSteps->processContextsByNodeId.end()) {
+      continue;
+    }
+
+    auto& buffers = contextIter->second->getAllOutputAudioBuffers();
+    auto bufferIter = buffers.find(output.tap->portId);
+
+    if (bufferIter != buffers.end()) {
+      output.source = &bufferIter->second;
+    }
+  }
+}
+
+AnthemOfflineRenderResult AnthemOfflineRenderer::render() {
+  AnthemOfflineRenderResult result;
+
+  if (options.blockSize <= 0 || options.blockSize > MAX_AUDIO_BUFFER_SIZE) {
+    result.error = "Block size must be between 1 and " + std::to_string(MAX_AUDIO_BUFFER_SIZE) + ".";
+    return result;
+  }
+
+  if (options.sampleRate <= 0.0) {
+    result.error = "Sample rate must be greater than 0.";
+    return result;
+  }
+
+  auto numChannels = masterOutputProcessor->buffer.getNumChannels();
+
+  // Encoding and disk IO happen on these threads, so the render thread only
+  // has to copy each block into the writers' FIFOs. A TimeSliceThread can
+  // serve any number of writers, so we don't need one per file.
+  auto numFiles = static_cast<int>(options.taps.size()) + (options.outputFile != juce::File() ? 1 : 0);
+  auto numWriterThreads = std::clamp(numFiles, 1, MAX_WRITER_THREADS);
+
+  std::vector<std::unique_ptr<juce::TimeSliceThread>> writerThreads;
+
+  for (int i = 0; i < numWriterThreads; i++) {
+    auto writerThread = std::make_unique<juce::TimeSliceThread>("AnthemOfflineRenderWriter" + juce::String(i));
+    writerThread->startThread();
+    writerThreads.push_back(std::move(writerThread));
+  }
+
+  std::vector<Output> outputs;
+
+  auto stopWriters = [&]() {
+    // Destroying the threaded writers flushes anything left in their FIFOs to
+    // disk.
+    outputs.clear();
+
+    for (auto& writerThread : writerThreads) {
+      writerThread->stopThread(10000);
+    }
+  };
+
+  auto addOutput = [&](const juce::File& file, std::optional<AnthemOfflineRenderTap> tap) {
+    std::string error;
+    auto writer = createWriter(file, options.format, options.sampleRate, numChannels, options.bitDepth, error);
+
+    if (writer == nullptr) {
+      result.error = error;
+      return false;
+    }
+
+    auto& writerThread = *writerThreads[outputs.size() % writerThreads.size()];
+
+    outputs.push_back(Output {
+      .tap = std::move(tap),
+      .writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(
+        writer.release(), writerThread, WRITER_BUFFER_SIZE
+      ),
+      .source = nullptr,
+    });
+
+    return true;
+  };
+
+  if (options.outputFile != juce::File()) {
+    if (!addOutput(options.outputFile, std::nullopt)) {
+      stopWriters();
+      return result;
+    }
+
+    outputs.back().source = &masterOutputProcessor->buffer;
+  }
+
+  for (auto& tap : options.taps) {
+    if (!addOutput(tap.outputFile, tap)) {
+      stopWriters();
+      return result;
+    }
+  }
+
+  // Taps whose node has been removed since the render started are written as
+  // silence.
+  juce::AudioSampleBuffer silence(numChannels, options.blockSize);
+  silence.clear();
+
+  std::unique_ptr<AnthemGraphParallelExecutor> executor;
+
+  if (options.processingThreads > 1) {
+    executor = std::make_unique<AnthemGraphParallelExecutor>(options.processingThreads - 1);
+  }
+
+  AnthemGraphCompilationResult* lastProcessingSteps = nullptr;
+
+  auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+  while (result.samplesRendered < options.lengthInSamples && !threadShouldExit()) {
+    auto numSamples = static_cast<int>(
+      std::min<int64_t>(options.blockSize, options.lengthInSamples - result.samplesRendered)
+    );
+
+    graphProcessor->process(numSamples, executor.get());
+
+    // The graph may be recompiled during the render, in which case the tapped
+    // buffers move.
+    auto* processingSteps = graphProcessor->getProcessingSteps();
+
+    if (processingSteps != lastProcessingSteps) {
+      findTapSources(outputs, processingSteps);
+      lastProcessingSteps = processingSteps;
+    }
+
+    for (auto& output : outputs) {
+      auto* source = output.source != nullptr ? output.source : &silence;
+
+      // write() returns false if the FIFO is full. If that happens, we're
+      // ahead of the disk, so we give the writer a moment to catch up.
+      while (!output.writer->write(source->getArrayOfReadPointers(), numSamples)) {
+        if (threadShouldExit()) {
+          break;
+        }
+
+        juce::Thread::sleep(1);
+      }
+    }
+
+    result.samplesRendered += numSamples;
+  }
+
+  executor.reset();
+  stopWriters();
+
+  result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+  if (threadShouldExit()) {
+    result.error = "Render was cancelled.";
+    return result;
+  }
+
+  auto renderedSeconds = static_cast<double>(result.samplesRendered) / options.sampleRate;
+
+  result.success = true;
+  result.realTimeFactor = result.renderSeconds > 0.0 ? renderedSeconds / result.renderSeconds : 0.0;
+
+  return result;
+}
@@ -0,0 +1,167 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+#include "modules/processing_graph/runtime/anthem_graph_parallel_executor.h"
+#include "modules/processing_graph/runtime/anthem_graph_processor.h"
+#include "modules/processors/master_output.h"
+
+#include "messages/messages.h"
+
+// An audio output port to capture into its own file, e.g. the output of a
+// track's bus for a stem export.
+struct AnthemOfflineRenderTap {
+  std::string nodeId;
+  int32_t portId;
+  juce::File outputFile;
+};
+
+struct AnthemOfflineRenderOptions {
+  // The file to write the master output to. If this is juce::File(), the
+  // master output isn't written, which is useful if only taps are needed.
+  juce::File outputFile;
+  RenderFileFormat format = RenderFileFormat::wav;
+
+  // The length of the render, in samples.
+  int64_t lengthInSamples = 0;
+
+  // The number of samples to process per call to AnthemGraphProcessor::process.
+  // This doesn't need to match the audio device.
+  int blockSize = 512;
+
+  // The sample rate to render at. 0 means the sample rate the engine is
+  // currently running at.
+  double sampleRate = 0.0;
+
+  int bitDepth = 24;
+
+  // Other output ports to write alongside the master output. All files use
+  // the same format and bit depth.
+  std::vector<AnthemOfflineRenderTap> taps;
+
+  // The number of threads to process the graph with, including the render
+  // thread. Independent nodes are spread across these threads.
+  int processingThreads = 1;
+};
+
+struct AnthemOfflineRenderResult {
+  bool success = false;
+  std::optional<std::string> error = std::nullopt;
+
+  int64_t samplesRendered = 0;
+
+  // Wall-clock time spent rendering, including waiting for the file writer to
+  // finish.
+  double renderSeconds = 0.0;
+
+  // How many seconds of audio were rendered per second of wall-clock time. A
+  // value of 10 means the render ran ten times faster than real-time.
+  double realTimeFactor = 0.0;
+};
+
+// Renders the master output of the processing graph to a file, as fast as the
+// CPU allows.
+//
+// The renderer pulls blocks from AnthemGraphProcessor::process() on its own
+// thread, in the same way the audio device callback does, and streams the
+// master output to a file writer that runs on a separate thread. Since it goes
+// through the same graph processor as live playback, any improvements there
+// apply here too.
+//
+// Any number of other output ports can be captured in the same pass (see
+// AnthemOfflineRenderTap), so stems don't each need their own render. The
+// writers for all files share a small pool of writer threads, and if
+// processingThreads is more than 1, nodes that don't depend on each other are
+// processed on separate threads.
+//
+// The graph processor can only be driven from one thread at a time, so the
+// audio device callback must be detached while a render is running. See
+// Anthem::renderOffline().
+class AnthemOfflineRenderer : private juce::Thread {
+public:
+  // Called on the message thread when the render is finished.
+  using CompletionCallback = std::function<void(AnthemOfflineRenderResult result)>;
+
+  AnthemOfflineRenderer(
+    AnthemGraphProcessor* graphProcessor,
+    std::shared_ptr<MasterOutputProcessor> masterOutputProcessor,
+    AnthemOfflineRenderOptions options,
+    CompletionCallback onComplete
+  );
+  ~AnthemOfflineRenderer() override;
+
+  void start();
+
+  // Asks the render to stop early. The completion callback will still be
+  // called, with an error.
+  void cancel();
+
+  // Creates a writer for the given file. Returns nullptr and sets error if the
+  // file couldn't be opened or the format doesn't support the options.
+  static std::unique_ptr<juce::AudioFormatWriter> createWriter(
+    const juce::File& file,
+    RenderFileFormat format,
+    double sampleRate,
+    int numChannels,
+    int bitDepth,
+    std::string& error
+  );
+
+private:
+  void run() override;
+
+  AnthemOfflineRenderResult render();
+
+  // A file being written, and the buffer it's written from.
+  struct Output {
+    std::optional<AnthemOfflineRenderTap> tap;
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> writer;
+
+    // The buffer to read from for the current block. For taps, this is found
+    // again whenever the graph is recompiled, and is nullptr if the node or
+    // port no longer exists.
+    const juce::AudioSampleBuffer* source = nullptr;
+  };
+
+  // Points each tap at its port buffer in the given processing steps.
+  static void findTapSources(std::vector<Output>& outputs, AnthemGraphCompilationResult* processingSteps);
+
+  AnthemGraphProcessor* graphProcessor;
+
+  // The processor is kept alive here, but only the raw pointer is used from
+  // the render thread.
+  std::shared_ptr<MasterOutputProcessor> masterOutputProcessorSharedPtr;
+  MasterOutputProcessor* masterOutputProcessor;
+
+  AnthemOfflineRenderOptions options;
+  CompletionCallback onComplete;
+};
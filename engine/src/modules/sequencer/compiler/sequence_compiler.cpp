@@ -21,6 +21,86 @@
 #include "modules/core/anthem.h"
 
 #include <algorithm>
+#include <limits>
+
+#include <rfl/json.hpp>
+#include <rfl.hpp>
+
+namespace {
+  AnthemAutomationCurve getAutomationCurve(AutomationCurveType curve) {
+    switch (curve) {
+      case AutomationCurveType::smooth:
+        return AnthemAutomationCurve::Smooth;
+      case AutomationCurveType::stairs:
+        return AnthemAutomationCurve::Stairs;
+      case AutomationCurveType::wave:
+        return AnthemAutomationCurve::Wave;
+      case AutomationCurveType::hold:
+        return AnthemAutomationCurve::Hold;
+    }
+
+    return AnthemAutomationCurve::Smooth;
+  }
+
+  // Enums are serialized by name.
+  AnthemAutomationCurve getAutomationCurve(const std::string& curve) {
+    if (curve == "stairs") {
+      return AnthemAutomationCurve::Stairs;
+    }
+
+    if (curve == "wave") {
+      return AnthemAutomationCurve::Wave;
+    }
+
+    if (curve == "hold") {
+      return AnthemAutomationCurve::Hold;
+    }
+
+    return AnthemAutomationCurve::Smooth;
+  }
+
+  double toTicks(AnthemSequenceTime time) {
+    return static_cast<double>(time.ticks) + time.fraction;
+  }
+
+  // yyjson stores integers as signed or unsigned depending on their sign, and
+  // its getters return 0 for the other kind, so we check for both.
+  std::optional<double> getNumberField(yyjson_val* object, const char* name) {
+    auto* value = yyjson_obj_get(object, name);
+
+    if (yyjson_is_sint(value)) {
+      return static_cast<double>(yyjson_get_sint(value));
+    }
+
+    if (yyjson_is_uint(value)) {
+      return static_cast<double>(yyjson_get_uint(value));
+    }
+
+    if (yyjson_is_real(value)) {
+      return yyjson_get_real(value);
+    }
+
+    return std::nullopt;
+  }
+
+  std::optional<int64_t> getIntegerField(yyjson_val* object, const char* name) {
+    auto* value = yyjson_obj_get(object, name);
+
+    if (yyjson_is_sint(value)) {
+      return yyjson_get_sint(value);
+    }
+
+    if (yyjson_is_uint(value)) {
+      return static_cast<int64_t>(yyjson_get_uint(value));
+    }
+
+    return std::nullopt;
+  }
+
+  std::string getKey(yyjson_val* key) {
+    return std::string(yyjson_get_str(key), yyjson_get_len(key));
+  }
+}
 
 void AnthemSequenceCompiler::getChannelEventsForArrangement(std::string channelId, std::string arrangementId, std::vector<AnthemSequenceEvent>& events) {}
 
@@ -59,56 +139,288 @@ void AnthemSequenceCompiler::getChannelNoteEventsForPattern(
   auto notes = notesIter->second;
 
   for (auto& note : *notes) {
-    auto rangeOptional = clampStartAndEndToRange(
-      AnthemSequenceTime { .ticks = note->offset(), .fraction = 0. },
-      AnthemSequenceTime { .ticks = note->offset() + note->length(), .fraction = 0. },
-      range
-    );
-
-    if (!rangeOptional.has_value()) {
-      continue;
+    addNoteEvents(note->key(), note->velocity(), note->offset(), note->length(), range, offset, events);
+  }
+}
+
+void AnthemSequenceCompiler::addNoteEvents(
+  int64_t key,
+  double velocity,
+  int64_t offsetTicks,
+  int64_t lengthTicks,
+  std::optional<std::tuple<AnthemSequenceTime, AnthemSequenceTime>> range,
+  std::optional<AnthemSequenceTime> offset,
+  std::vector<AnthemSequenceEvent>& events
+) {
+  auto rangeOptional = clampStartAndEndToRange(
+    AnthemSequenceTime { .ticks = offsetTicks, .fraction = 0. },
+    AnthemSequenceTime { .ticks = offsetTicks + lengthTicks, .fraction = 0. },
+    range
+  );
+
+  if (!rangeOptional.has_value()) {
+    return;
+  }
+
+  auto [start, end] = rangeOptional.value();
+
+  auto startWithOffset = offset.has_value() ? start + offset.value() : start;
+  auto endWithOffset = offset.has_value() ? end + offset.value() : end;
+
+  // If a range is specified, then this is for a clip. The events that are
+  // output must be relative to the start of the clip. range.start is the
+  // start of the clip, so we subtract it from the start and end times.
+  if (range.has_value()) {
+    startWithOffset = startWithOffset - std::get<0>(range.value());
+    endWithOffset = endWithOffset - std::get<0>(range.value());
+  }
+
+  events.push_back(AnthemSequenceEvent {
+    .time = startWithOffset,
+    .event = AnthemEvent {
+      .type = AnthemEventType::NoteOn,
+      .noteOn = AnthemNoteOnEvent(
+        static_cast<int16_t>(key),
+        static_cast<int16_t>(0),
+        static_cast<float>(velocity),
+        0.f,
+        static_cast<int32_t>(-1)
+      )
+    }
+  });
+
+  events.push_back(AnthemSequenceEvent {
+    .time = endWithOffset,
+    .event = AnthemEvent {
+      .type = AnthemEventType::NoteOff,
+      .noteOff = AnthemNoteOffEvent(
+        static_cast<int16_t>(key),
+        static_cast<int16_t>(0),
+        0.f,
+        static_cast<int32_t>(-1)
+      )
+    }
+  });
+}
+
+void AnthemSequenceCompiler::getChannelAutomationForPattern(
+  std::string channelId,
+  std::string patternId,
+  std::optional<std::tuple<AnthemSequenceTime, AnthemSequenceTime>> range,
+  std::optional<AnthemSequenceTime> offset,
+  AnthemAutomationSegmentList& segments
+) {
+  auto& anthem = Anthem::getInstance();
+
+  auto patternIter = anthem.project->sequence()->patterns()->find(patternId);
+  if (patternIter == anthem.project->sequence()->patterns()->end()) {
+    return;
+  }
+
+  auto pattern = patternIter->second;
+
+  auto laneIter = pattern->automationLanes()->find(channelId);
+  if (laneIter == pattern->automationLanes()->end()) {
+    return;
+  }
+
+  std::vector<AutomationPoint> points;
+
+  for (auto& point : *laneIter->second->points()) {
+    points.push_back(AutomationPoint {
+      .offset = point->offset(),
+      .value = point->value(),
+      .tension = point->tension(),
+      .curve = getAutomationCurve(point->curve()),
+    });
+  }
+
+  addAutomationSegments(std::move(points), range, offset, segments);
+}
+
+void AnthemSequenceCompiler::addAutomationSegments(
+  std::vector<AutomationPoint> points,
+  std::optional<std::tuple<AnthemSequenceTime, AnthemSequenceTime>> range,
+  std::optional<AnthemSequenceTime> offset,
+  AnthemAutomationSegmentList& segments
+) {
+  if (points.empty()) {
+    return;
+  }
+
+  // Points should already be in order, but the segments must be, so we make
+  // sure. Points at the same time keep their order, which makes a jump.
+  std::stable_sort(points.begin(), points.end(), [](const AutomationPoint& a, const AutomationPoint& b) {
+    return a.offset < b.offset;
+  });
+
+  constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+  // As with notes, the output for a range is relative to the start of the
+  // range.
+  double shift = offset.has_value() ? toTicks(offset.value()) : 0.0;
+  double rangeStart = -infinity;
+  double rangeEnd = infinity;
+
+  if (range.has_value()) {
+    rangeStart = toTicks(std::get<0>(range.value()));
+    rangeEnd = toTicks(std::get<1>(range.value()));
+    shift -= rangeStart;
+  }
+
+  auto add = [&](AnthemAutomationSegment segment) {
+    if (segment.end < rangeStart || segment.start > rangeEnd) {
+      return;
     }
 
-    auto [start, end] = rangeOptional.value();
+    segment.start += shift;
+    segment.end += shift;
+    segments.push_back(segment);
+  };
+
+  add(AnthemAutomationSegment::createConstant(
+    -infinity, static_cast<double>(points.front().offset), static_cast<float>(points.front().value)
+  ));
+
+  for (size_t i = 1; i < points.size(); i++) {
+    auto& from = points[i - 1];
+    auto& to = points[i];
+
+    add(AnthemAutomationSegment::create(
+      static_cast<double>(from.offset),
+      static_cast<double>(to.offset),
+      static_cast<float>(from.value),
+      static_cast<float>(to.value),
+      static_cast<float>(to.tension),
+      to.curve
+    ));
+  }
+
+  add(AnthemAutomationSegment::createConstant(
+    static_cast<double>(points.back().offset), infinity, static_cast<float>(points.back().value)
+  ));
+}
+
+std::unordered_map<std::string, SequenceEventListCollection> AnthemSequenceCompiler::compilePatternsFromJson(
+  const std::string& serializedProject
+) {
+  auto* document = yyjson_read(serializedProject.data(), serializedProject.size(), 0);
+
+  if (document == nullptr) {
+    std::cout << "Failed to read patterns from project: the JSON could not be parsed" << std::endl;
+    return {};
+  }
+
+  auto result = compilePatternsFromJson(yyjson_doc_get_root(document));
 
-    auto startWithOffset = offset.has_value() ? start + offset.value() : start;
-    auto endWithOffset = offset.has_value() ? end + offset.value() : end;
+  yyjson_doc_free(document);
 
-    // If a range is specified, then this is for a clip. The events that are
-    // output must be relative to the start of the clip. range.start is the
-    // start of the clip, so we subtract it from the start and end times.
-    if (range.has_value()) {
-      startWithOffset = startWithOffset - std::get<0>(range.value());
-      endWithOffset = endWithOffset - std::get<0>(range.value());
+  return result;
+}
+
+std::unordered_map<std::string, SequenceEventListCollection> AnthemSequenceCompiler::compilePatternsFromJson(
+  yyjson_val* project
+) {
+  std::unordered_map<std::string, SequenceEventListCollection> result;
+
+  auto* patterns = yyjson_obj_get(yyjson_obj_get(project, "sequence"), "patterns");
+
+  if (!yyjson_is_obj(patterns)) {
+    std::cout << "Failed to read patterns from project: sequence.patterns is missing" << std::endl;
+    return result;
+  }
+
+  size_t patternIndex, patternCount;
+  yyjson_val* patternId;
+  yyjson_val* pattern;
+
+  yyjson_obj_foreach(patterns, patternIndex, patternCount, patternId, pattern) {
+    SequenceEventListCollection collection;
+
+    auto* notesByChannel = yyjson_obj_get(pattern, "notes");
+    auto* automationLanesByChannel = yyjson_obj_get(pattern, "automationLanes");
+
+    size_t channelIndex, channelCount;
+    yyjson_val* channelId;
+    yyjson_val* notes;
+
+    yyjson_obj_foreach(notesByChannel, channelIndex, channelCount, channelId, notes) {
+      if (yyjson_arr_size(notes) == 0) {
+        continue;
+      }
+
+      SequenceEventList eventList;
+      eventList.events->reserve(yyjson_arr_size(notes) * 2);
+
+      size_t noteIndex, noteCount;
+      yyjson_val* note;
+
+      yyjson_arr_foreach(notes, noteIndex, noteCount, note) {
+        auto key = getIntegerField(note, "key");
+        auto velocity = getNumberField(note, "velocity");
+        auto length = getIntegerField(note, "length");
+        auto offset = getIntegerField(note, "offset");
+
+        // The project model would have failed to load if a note were
+        // malformed, so this shouldn't happen.
+        if (!key.has_value() || !velocity.has_value() || !length.has_value() || !offset.has_value()) {
+          continue;
+        }
+
+        addNoteEvents(key.value(), velocity.value(), offset.value(), length.value(), std::nullopt, std::nullopt, *eventList.events);
+      }
+
+      sortEventList(*eventList.events);
+
+      collection.channels->insert_or_assign(getKey(channelId), eventList);
     }
 
-    events.push_back(AnthemSequenceEvent {
-      .time = startWithOffset,
-      .event = AnthemEvent {
-        .type = AnthemEventType::NoteOn,
-        .noteOn = AnthemNoteOnEvent(
-          static_cast<int16_t>(note->key()),
-          static_cast<int16_t>(0),
-          static_cast<float>(note->velocity()),
-          0.f,
-          static_cast<int32_t>(-1)
-        )
+    yyjson_val* lane;
+
+    yyjson_obj_foreach(automationLanesByChannel, channelIndex, channelCount, channelId, lane) {
+      auto* serializedPoints = yyjson_obj_get(lane, "points");
+
+      if (yyjson_arr_size(serializedPoints) == 0) {
+        continue;
       }
-    });
 
-    events.push_back(AnthemSequenceEvent {
-      .time = endWithOffset,
-      .event = AnthemEvent {
-        .type = AnthemEventType::NoteOff,
-        .noteOff = AnthemNoteOffEvent(
-          static_cast<int16_t>(note->key()),
-          static_cast<int16_t>(0),
-          0.f,
-          static_cast<int32_t>(-1)
-        )
+      std::vector<AutomationPoint> points;
+      points.reserve(yyjson_arr_size(serializedPoints));
+
+      size_t pointIndex, pointCount;
+      yyjson_val* point;
+
+      yyjson_arr_foreach(serializedPoints, pointIndex, pointCount, point) {
+        auto offset = getIntegerField(point, "offset");
+        auto value = getNumberField(point, "value");
+        auto tension = getNumberField(point, "tension");
+        auto* curve = yyjson_obj_get(point, "curve");
+
+        if (!offset.has_value() || !value.has_value() || !tension.has_value() || !yyjson_is_str(curve)) {
+          continue;
+        }
+
+        points.push_back(AutomationPoint {
+          .offset = offset.value(),
+          .value = value.value(),
+          .tension = tension.value(),
+          .curve = getAutomationCurve(getKey(curve)),
+        });
       }
-    });
+
+      auto channelIter = collection.channels->find(getKey(channelId));
+
+      if (channelIter == collection.channels->end()) {
+        channelIter = collection.channels->emplace(getKey(channelId), SequenceEventList()).first;
+      }
+
+      addAutomationSegments(std::move(points), std::nullopt, std::nullopt, *channelIter->second.automationSegments);
+    }
+
+    result.insert_or_assign(getKey(patternId), collection);
   }
+
+  return result;
 }
 
 void AnthemSequenceCompiler::sortEventList(std::vector<AnthemSequenceEvent>& events) {
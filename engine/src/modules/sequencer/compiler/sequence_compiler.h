@@ -19,11 +19,17 @@
 
 #pragma once
 
+#include "modules/sequencer/events/automation_segment.h"
 #include "modules/sequencer/events/event.h"
+#include "modules/sequencer/runtime/runtime_sequence_store.h"
 
 #include <string>
 #include <vector>
 #include <optional>
+#include <unordered_map>
+
+// A value in a parsed JSON document. reflect-cpp parses JSON with yyjson.
+struct yyjson_val;
 
 // This class is used to compile a sequence into a set of sorted event lists.
 //
@@ -37,9 +43,20 @@
 // something is changed, e.g. some notes are moved around for a given pattern,
 // we don't recompile the entire sequence. Instead, we just update the event
 // lists for the relevant channel.
+//
+// Automation lanes are compiled the same way, except into a sorted list of
+// curve segments rather than events. See AnthemAutomationSegment.
 class AnthemSequenceCompiler {
 friend class SequenceCompilerTest;
 private:
+  // An automation point, read from either the model or the project JSON.
+  struct AutomationPoint {
+    int64_t offset;
+    double value;
+    double tension;
+    AnthemAutomationCurve curve;
+  };
+
   static void getChannelEventsForArrangement(std::string channelId, std::string arrangementId, std::vector<AnthemSequenceEvent>& events);
 
   static void getChannelEventsForPattern(
@@ -71,6 +88,46 @@ private:
     std::vector<AnthemSequenceEvent>& events
   );
 
+  // Adds the note on and note off events for a single note. This is shared by
+  // the model-based and JSON-based compile paths.
+  static void addNoteEvents(
+    int64_t key,
+    double velocity,
+    int64_t offsetTicks,
+    int64_t lengthTicks,
+    std::optional<std::tuple<AnthemSequenceTime, AnthemSequenceTime>> range,
+    std::optional<AnthemSequenceTime> offset,
+    std::vector<AnthemSequenceEvent>& events
+  );
+
+  // Gets the automation segments on a given channel for the given pattern.
+  //
+  // The range and offset work the same way as they do for notes, except that
+  // segments that cross the edges of the range aren't cut off. A segment's
+  // shape depends on where both of its points are, so we keep the whole
+  // segment, and it's up to the caller to only read the part that's in the
+  // range.
+  static void getChannelAutomationForPattern(
+    std::string channelId,
+    std::string patternId,
+    std::optional<std::tuple<AnthemSequenceTime, AnthemSequenceTime>> range,
+    std::optional<AnthemSequenceTime> offset,
+    AnthemAutomationSegmentList& segments
+  );
+
+  // Compiles the segments for a single automation lane. This is shared by the
+  // model-based and JSON-based compile paths.
+  //
+  // Each point's curve and tension describe the segment that ends at that
+  // point, which matches how the automation editor draws them. Before the
+  // first point and after the last point, the value holds.
+  static void addAutomationSegments(
+    std::vector<AutomationPoint> points,
+    std::optional<std::tuple<AnthemSequenceTime, AnthemSequenceTime>> range,
+    std::optional<AnthemSequenceTime> offset,
+    AnthemAutomationSegmentList& segments
+  );
+
   static void sortEventList(std::vector<AnthemSequenceEvent>& events);
 
   // Clamps a time range to the start and end times of a clip. The intent here
@@ -93,4 +150,26 @@ private:
     std::tuple<AnthemSequenceTime, AnthemSequenceTime> range
   );
 public:
+  // Compiles the note events and automation lanes for every pattern in a
+  // serialized project, keyed by pattern ID.
+  //
+  // This reads the notes directly out of the project JSON and doesn't touch
+  // the project model, so unlike the methods above, it is safe to call from
+  // any thread. This is used when loading a project: the full project model
+  // is still needed for model sync, but we don't want the audio thread to wait
+  // on the main thread walking every note in the model before it has anything
+  // to play.
+  //
+  // The returned event lists are owned by the caller, and are expected to be
+  // handed to AnthemRuntimeSequenceStore.
+  static std::unordered_map<std::string, SequenceEventListCollection> compilePatternsFromJson(
+    const std::string& serializedProject
+  );
+
+  // The same as above, but reads from a project that has already been parsed,
+  // e.g. the document that the project model was read from. This walks the
+  // parsed values directly, so nothing is parsed or copied twice.
+  static std::unordered_map<std::string, SequenceEventListCollection> compilePatternsFromJson(
+    yyjson_val* project
+  );
 };
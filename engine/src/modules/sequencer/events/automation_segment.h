@@ -0,0 +1,231 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <vector>
+
+// The curve shapes that can connect two automation points. These mirror
+// AutomationCurveType in the model.
+enum class AnthemAutomationCurve : uint8_t {
+  Smooth,
+  Stairs,
+  Wave,
+  Hold,
+};
+
+// The function used to evaluate an automation segment. Each curve compiles to
+// one of these, so evaluation only has to choose a kernel once per segment,
+// rather than once per sample.
+enum class AnthemAutomationKernel : uint8_t {
+  // value = offset
+  Constant,
+
+  // value = offset + scale * x
+  Linear,
+
+  // value = offset + scale * (shapeOffset + shapeScale * x) ^ shapeParameter
+  Power,
+
+  // value = offset + scale * min(floor(x * shapeParameter), shapeParameter - 1)
+  Stairs,
+
+  // value = offset + scale * cos(shapeParameter * x)
+  Cosine,
+};
+
+// A compiled piece of an automation lane, which covers the time from one
+// automation point to the next.
+//
+// x is the position within the segment, from 0 at the start to 1 at the end.
+// The coefficients are worked out when the sequence is compiled, so that
+// evaluating a segment is a single expression with no branches. See
+// AnthemAutomationKernel for how each kernel uses them.
+struct AnthemAutomationSegment {
+  // The start and end of the segment, in ticks. The segments before the first
+  // point and after the last point extend to negative and positive infinity.
+  double start;
+  double end;
+
+  // 1 / (end - start), or 0 if the segment doesn't end.
+  double inverseLength;
+
+  AnthemAutomationKernel kernel;
+
+  float offset;
+  float scale;
+
+  float shapeOffset;
+  float shapeScale;
+  float shapeParameter;
+
+  // Creates a segment that holds a single value.
+  static AnthemAutomationSegment createConstant(double start, double end, float value) {
+    return AnthemAutomationSegment {
+      .start = start,
+      .end = end,
+      .inverseLength = 0.0,
+      .kernel = AnthemAutomationKernel::Constant,
+      .offset = value,
+      .scale = 0.0f,
+      .shapeOffset = 0.0f,
+      .shapeScale = 0.0f,
+      .shapeParameter = 0.0f,
+    };
+  }
+
+  // Creates a segment that goes from startValue to endValue with the given
+  // curve. Tension is in the range [-1, 1].
+  //
+  // Smooth curves match the automation editor (see smooth.dart). The editor
+  // doesn't draw the other curves yet, so for now:
+  // - Stairs go from startValue to endValue in 2 to 16 equal steps, with more
+  //   steps as the tension moves away from 0.
+  // - Waves move between startValue and endValue along a cosine, ending at
+  //   endValue. The number of extra cycles goes from 0 to 15 as the tension
+  //   moves away from 0.
+  // - Hold keeps startValue until the next point.
+  static AnthemAutomationSegment create(
+    double start,
+    double end,
+    float startValue,
+    float endValue,
+    float tension,
+    AnthemAutomationCurve curve
+  ) {
+    auto segment = createConstant(start, end, startValue);
+    auto difference = endValue - startValue;
+
+    if (curve == AnthemAutomationCurve::Hold || difference == 0.0f || end <= start) {
+      return segment;
+    }
+
+    segment.inverseLength = 1.0 / (end - start);
+
+    switch (curve) {
+      case AnthemAutomationCurve::Smooth: {
+        if (tension == 0.0f) {
+          segment.kernel = AnthemAutomationKernel::Linear;
+          segment.scale = difference;
+          break;
+        }
+
+        // For positive tension the curve is x ^ k, and for negative tension
+        // it's 1 - (1 - x) ^ k.
+        auto rawTension = getRawTension(static_cast<double>(tension) * 15.0);
+
+        segment.kernel = AnthemAutomationKernel::Power;
+
+        if (tension > 0.0f) {
+          segment.scale = difference;
+          segment.shapeOffset = 0.0f;
+          segment.shapeScale = 1.0f;
+          segment.shapeParameter = static_cast<float>(rawTension + 1.0);
+        } else {
+          segment.offset = endValue;
+          segment.scale = -difference;
+          segment.shapeOffset = 1.0f;
+          segment.shapeScale = -1.0f;
+          segment.shapeParameter = static_cast<float>(-rawTension + 1.0);
+        }
+        break;
+      }
+      case AnthemAutomationCurve::Stairs: {
+        auto steps = 2.0f + std::round(std::abs(tension) * 14.0f);
+
+        segment.kernel = AnthemAutomationKernel::Stairs;
+        segment.scale = difference / (steps - 1.0f);
+        segment.shapeParameter = steps;
+        break;
+      }
+      case AnthemAutomationCurve::Wave: {
+        auto cycles = std::round(std::abs(tension) * 15.0f);
+
+        segment.kernel = AnthemAutomationKernel::Cosine;
+        segment.offset = startValue + difference * 0.5f;
+        segment.scale = -difference * 0.5f;
+        segment.shapeParameter = std::numbers::pi_v<float> * (2.0f * cycles + 1.0f);
+        break;
+      }
+      case AnthemAutomationCurve::Hold:
+        break;
+    }
+
+    return segment;
+  }
+
+  // Gets x for the given time, in ticks. This isn't clamped to the segment.
+  double getPosition(double time) const {
+    // Segments that don't end have no length to divide by, and they start at
+    // negative infinity, which would give us NaN.
+    return inverseLength == 0.0 ? 0.0 : (time - start) * inverseLength;
+  }
+
+  // Gets the value at the given time, in ticks. This is for checking single
+  // values; blocks of samples should be rendered with
+  // AnthemAutomationEvaluator.
+  float getValue(double time) const {
+    auto x = static_cast<float>(std::clamp(getPosition(time), 0.0, 1.0));
+
+    switch (kernel) {
+      case AnthemAutomationKernel::Constant:
+        return offset;
+      case AnthemAutomationKernel::Linear:
+        return offset + scale * x;
+      case AnthemAutomationKernel::Power:
+        return offset + scale * std::pow(shapeOffset + shapeScale * x, shapeParameter);
+      case AnthemAutomationKernel::Stairs:
+        return offset + scale * std::min(std::floor(x * shapeParameter), shapeParameter - 1.0f);
+      case AnthemAutomationKernel::Cosine:
+        return offset + scale * std::cos(shapeParameter * x);
+    }
+
+    return offset;
+  }
+
+private:
+  // Ported from smooth.dart. Returns values similar to the input near 0, and
+  // grows as tension moves away from 0.
+  static double getRawTension(double tension) {
+    constexpr double linearCenterTransitionRate = 0.27;
+    constexpr double linearCenterWidth = 1.6;
+
+    auto g = [](double x) {
+      return std::atan(x * linearCenterTransitionRate * std::numbers::pi) / std::numbers::pi + 0.5;
+    };
+
+    auto linearCenterInterpolation = 1.0 - (g(tension + linearCenterWidth) + (1.0 - g(tension - linearCenterWidth)) - 1.0);
+
+    auto powVal = tension >= 0.0
+      ? std::pow(tension / 2.0, 2.2)
+      : -std::pow(-tension / 2.0, 2.2);
+
+    return powVal * linearCenterInterpolation + 0.7 * tension * (1.0 - linearCenterInterpolation);
+  }
+};
+
+// Automation segments for a single lane, sorted by start time. Consecutive
+// segments share their boundaries, and if the lane has any points, together
+// they cover all time.
+using AnthemAutomationSegmentList = std::vector<AnthemAutomationSegment>;
@@ -19,11 +19,19 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "note_events.h"
 
-enum AnthemEventType {
+enum AnthemEventType : uint8_t {
   NoteOn,
-  NoteOff
+  NoteOff,
+
+  // These are only used for live events. See AnthemLiveEvent.
+  NoteExpression,
+  ControlChange,
+  PitchBend,
+  ParameterChange,
 };
 
 // An event that can occur in Anthem.
@@ -147,14 +155,145 @@ struct AnthemSequenceEvent {
 
 // A time for a processing graph event.
 struct AnthemLiveTime {
-  // The number of samples since the start of the processing block.
-  int64_t offset;
+  // The number of samples since the start of the processing block. Blocks
+  // are never anywhere near 2^31 samples long, so 32 bits is plenty.
+  int32_t offset;
+};
+
+// Per-note expressions that can be changed while a note is playing. These
+// follow the set that CLAP supports.
+enum class AnthemNoteExpressionType : int16_t {
+  // Linear gain, where 1 is unchanged.
+  Volume,
+  // 0 is left, 0.5 is center, and 1 is right.
+  Pan,
+  // In semitones, relative to the note's pitch.
+  Tuning,
+  // The following are all in the range [0, 1].
+  Vibrato,
+  Expression,
+  Brightness,
+  Pressure,
 };
 
+// An event in the processing graph.
+//
+// These are copied around a lot, so they're packed into 16 bytes: the time,
+// the type, the channel, and a two-byte field and an eight-byte payload whose
+// meaning depends on the type. Check the type before reading anything else.
+//
+// Notes are matched up by ID. A note on with a detune is sent as a note on
+// followed by a Tuning expression at the same time.
 struct AnthemLiveEvent {
   // The time of the event, relative to the start of the processing block.
   AnthemLiveTime time;
 
-  // The event itself.
-  AnthemEvent event;
+  AnthemEventType type;
+
+  // The channel of the event. 0 is the first channel.
+  uint8_t channel;
+
+  union {
+    // NoteOn and NoteOff. In the range [0, 127] <-> [C(-2), G8].
+    int16_t pitch;
+
+    // NoteExpression.
+    AnthemNoteExpressionType expression;
+
+    // ControlChange. The MIDI controller number.
+    int16_t controller;
+  };
+
+  union {
+    struct {
+      int32_t id;
+
+      // In the range [0, 1].
+      float velocity;
+    } noteOn;
+
+    struct {
+      int32_t id;
+
+      // In the range [0, 1].
+      float velocity;
+    } noteOff;
+
+    struct {
+      // The ID of the note to change.
+      int32_t id;
+
+      // See AnthemNoteExpressionType for the range.
+      float value;
+    } noteExpression;
+
+    struct {
+      // In the range [0, 1].
+      float value;
+    } controlChange;
+
+    struct {
+      // In semitones, for every note on the channel.
+      float value;
+    } pitchBend;
+
+    struct {
+      // The ID of the control input port to change.
+      int32_t portId;
+
+      // The new value, in the port's own range.
+      float value;
+    } parameterChange;
+  };
+
+  static AnthemLiveEvent createNoteOn(int32_t offset, uint8_t channel, int16_t pitch, float velocity, int32_t id) {
+    AnthemLiveEvent event = create(offset, AnthemEventType::NoteOn, channel);
+    event.pitch = pitch;
+    event.noteOn = { .id = id, .velocity = velocity };
+    return event;
+  }
+
+  static AnthemLiveEvent createNoteOff(int32_t offset, uint8_t channel, int16_t pitch, float velocity, int32_t id) {
+    AnthemLiveEvent event = create(offset, AnthemEventType::NoteOff, channel);
+    event.pitch = pitch;
+    event.noteOff = { .id = id, .velocity = velocity };
+    return event;
+  }
+
+  static AnthemLiveEvent createNoteExpression(int32_t offset, uint8_t channel, AnthemNoteExpressionType expression, int32_t id, float value) {
+    AnthemLiveEvent event = create(offset, AnthemEventType::NoteExpression, channel);
+    event.expression = expression;
+    event.noteExpression = { .id = id, .value = value };
+    return event;
+  }
+
+  static AnthemLiveEvent createControlChange(int32_t offset, uint8_t channel, int16_t controller, float value) {
+    AnthemLiveEvent event = create(offset, AnthemEventType::ControlChange, channel);
+    event.controller = controller;
+    event.controlChange = { .value = value };
+    return event;
+  }
+
+  static AnthemLiveEvent createPitchBend(int32_t offset, uint8_t channel, float semitones) {
+    AnthemLiveEvent event = create(offset, AnthemEventType::PitchBend, channel);
+    event.pitchBend = { .value = semitones };
+    return event;
+  }
+
+  static AnthemLiveEvent createParameterChange(int32_t offset, int32_t portId, float value) {
+    AnthemLiveEvent event = create(offset, AnthemEventType::ParameterChange, 0);
+    event.parameterChange = { .portId = portId, .value = value };
+    return event;
+  }
+
+private:
+  static AnthemLiveEvent create(int32_t offset, AnthemEventType type, uint8_t channel) {
+    AnthemLiveEvent event {};
+    event.time = { .offset = offset };
+    event.type = type;
+    event.channel = channel;
+    return event;
+  }
 };
+
+static_assert(sizeof(AnthemLiveEvent) == 16, "AnthemLiveEvent should fit in 16 bytes.");
@@ -0,0 +1,168 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "automation_evaluator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Gets the first sample at or after the given time, clamped to the block.
+  int getFirstSampleAtOrAfter(double time, double startTime, double ticksPerSample, int numSamples) {
+    auto sample = std::ceil((time - startTime) / ticksPerSample);
+    return static_cast<int>(std::clamp(sample, 0.0, static_cast<double>(numSamples)));
+  }
+
+  bool canBeWrittenAsBreakpoints(const AnthemAutomationSegment& segment) {
+    return segment.kernel == AnthemAutomationKernel::Constant || segment.kernel == AnthemAutomationKernel::Linear;
+  }
+}
+
+size_t AnthemAutomationEvaluator::findSegment(const AnthemAutomationSegmentList& segments, double time) {
+  auto next = std::upper_bound(
+    segments.begin(),
+    segments.end(),
+    time,
+    [](double time, const AnthemAutomationSegment& segment) {
+      return time < segment.start;
+    }
+  );
+
+  if (next == segments.begin()) {
+    return 0;
+  }
+
+  return static_cast<size_t>(next - segments.begin()) - 1;
+}
+
+void AnthemAutomationEvaluator::evaluate(
+  const AnthemAutomationSegmentList& segments,
+  double startTime,
+  double ticksPerSample,
+  int numSamples,
+  AnthemControlBuffer& output
+) {
+  if (segments.empty()) {
+    return;
+  }
+
+  auto endTime = startTime + ticksPerSample * numSamples;
+
+  auto first = findSegment(segments, startTime);
+  auto last = first;
+  bool needsSamples = !canBeWrittenAsBreakpoints(segments[first]);
+
+  while (last + 1 < segments.size() && segments[last + 1].start < endTime) {
+    last++;
+    needsSamples = needsSamples || !canBeWrittenAsBreakpoints(segments[last]);
+  }
+
+  if (!needsSamples && last - first < static_cast<size_t>(CONTROL_BUFFER_MAX_BREAKPOINTS)) {
+    for (auto i = first; i <= last; i++) {
+      auto& segment = segments[i];
+      auto sample = i == first ? 0 : getFirstSampleAtOrAfter(segment.start, startTime, ticksPerSample, numSamples);
+
+      if (sample >= numSamples) {
+        break;
+      }
+
+      auto x = static_cast<float>(segment.getPosition(startTime + ticksPerSample * sample));
+      auto value = segment.offset + segment.scale * x;
+      auto slope = segment.scale * static_cast<float>(segment.inverseLength * ticksPerSample);
+
+      if (i == first) {
+        output.setValue(value, slope);
+      } else {
+        output.addBreakpoint(sample, value, slope);
+      }
+    }
+
+    return;
+  }
+
+  auto* samples = output.getWritePointer();
+
+  for (auto i = first; i <= last; i++) {
+    auto firstSample = i == first ? 0 : getFirstSampleAtOrAfter(segments[i].start, startTime, ticksPerSample, numSamples);
+    auto endSample = i == last ? numSamples : getFirstSampleAtOrAfter(segments[i + 1].start, startTime, ticksPerSample, numSamples);
+
+    renderSegment(segments[i], startTime, ticksPerSample, firstSample, endSample, samples);
+  }
+}
+
+void AnthemAutomationEvaluator::renderSegment(
+  const AnthemAutomationSegment& segment,
+  double startTime,
+  double ticksPerSample,
+  int firstSample,
+  int endSample,
+  float* output
+) {
+  if (firstSample >= endSample) {
+    return;
+  }
+
+  // The position within the segment goes up by the same amount each sample.
+  // We work out the start in double precision, since segments can start a
+  // long way before this block.
+  auto x0 = static_cast<float>(segment.getPosition(startTime + ticksPerSample * firstSample));
+  auto dx = static_cast<float>(ticksPerSample * segment.inverseLength);
+
+  auto offset = segment.offset;
+  auto scale = segment.scale;
+  auto shapeOffset = segment.shapeOffset;
+  auto shapeScale = segment.shapeScale;
+  auto shapeParameter = segment.shapeParameter;
+
+  // Each kernel is a loop with no branches, so the compiler can vectorize
+  // the simpler ones. x is clamped in case rounding takes it slightly outside
+  // the segment.
+  auto getX = [x0, dx](int i) {
+    return std::clamp(x0 + dx * static_cast<float>(i), 0.0f, 1.0f);
+  };
+
+  auto count = endSample - firstSample;
+  auto* out = output + firstSample;
+
+  switch (segment.kernel) {
+    case AnthemAutomationKernel::Constant:
+      std::fill(out, out + count, offset);
+      break;
+    case AnthemAutomationKernel::Linear:
+      for (int i = 0; i < count; i++) {
+        out[i] = offset + scale * getX(i);
+      }
+      break;
+    case AnthemAutomationKernel::Power:
+      for (int i = 0; i < count; i++) {
+        out[i] = offset + scale * std::pow(shapeOffset + shapeScale * getX(i), shapeParameter);
+      }
+      break;
+    case AnthemAutomationKernel::Stairs:
+      for (int i = 0; i < count; i++) {
+        out[i] = offset + scale * std::min(std::floor(getX(i) * shapeParameter), shapeParameter - 1.0f);
+      }
+      break;
+    case AnthemAutomationKernel::Cosine:
+      for (int i = 0; i < count; i++) {
+        out[i] = offset + scale * std::cos(shapeParameter * getX(i));
+      }
+      break;
+  }
+}
@@ -0,0 +1,60 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "modules/processing_graph/processor/anthem_control_buffer.h"
+#include "modules/sequencer/events/automation_segment.h"
+
+// Turns compiled automation lanes into control values for a processing block.
+//
+// Constant and linear segments are written to the control buffer as
+// breakpoints, so a lane made of straight lines costs about the same as a
+// parameter being smoothed, no matter how many samples are in the block.
+// Blocks that contain curves are rendered as samples instead, with one tight
+// loop per segment. See AnthemAutomationKernel.
+class AnthemAutomationEvaluator {
+public:
+  // Writes the values of a lane for a single block to the given buffer.
+  //
+  // startTime is the time of the first sample in the block, in ticks, and
+  // ticksPerSample is the time between samples. If the lane is empty, the
+  // buffer is left as it is.
+  static void evaluate(
+    const AnthemAutomationSegmentList& segments,
+    double startTime,
+    double ticksPerSample,
+    int numSamples,
+    AnthemControlBuffer& output
+  );
+
+  // Writes the values of a single segment for the samples in
+  // [firstSample, endSample), where sample 0 is at startTime.
+  static void renderSegment(
+    const AnthemAutomationSegment& segment,
+    double startTime,
+    double ticksPerSample,
+    int firstSample,
+    int endSample,
+    float* output
+  );
+
+  // Finds the segment that contains the given time.
+  static size_t findSegment(const AnthemAutomationSegmentList& segments, double time);
+};
@@ -21,10 +21,12 @@
 
 SequenceEventList::SequenceEventList() {
   events = new std::vector<AnthemSequenceEvent>();
+  automationSegments = new AnthemAutomationSegmentList();
 }
 
 void SequenceEventList::cleanUpInstance(SequenceEventList& instance) {
   delete instance.events;
+  delete instance.automationSegments;
 }
 
 SequenceEventListCollection::SequenceEventListCollection() {
@@ -43,19 +45,22 @@ void SequenceEventListCollection::cleanUpInstance(SequenceEventListCollection& i
 }
 
 AnthemRuntimeSequenceStore::SequenceIdToEventsMap& AnthemRuntimeSequenceStore::rt_getEventLists() {
-  auto result = mapUpdateQueue.read();
-
   // Take all the updates from the queue, and push old values to the deletion
-  // queue.
-  while (result.has_value()) {
-    auto* newMap = result.value();
+  // queue. We only take an update if there's room to send the old map back,
+  // so nothing is leaked. Otherwise, the update waits in the queue.
+  while (mapDeletionQueue.getNumFreeSlots() > 0) {
+    auto result = mapUpdateQueue.tryPop();
 
-    auto* oldMap = rt_eventLists;
-    rt_eventLists = newMap;
+    if (!result.has_value()) {
+      break;
+    }
 
-    mapDeletionQueue.add(oldMap);
+    auto* oldMap = rt_eventLists;
+    rt_eventLists = result.value();
 
-    result = mapUpdateQueue.read();
+    // This can't fail, since we checked for room above.
+    [[maybe_unused]] auto added = mapDeletionQueue.tryPush(oldMap);
+    jassert(added);
   }
 
   return *rt_eventLists;
@@ -73,7 +78,7 @@ AnthemRuntimeSequenceStore::AnthemRuntimeSequenceStore()
   eventLists = new std::unordered_map<std::string, SequenceEventListCollection>();
   rt_eventLists = eventLists;
 
-  pendingSequenceDeletions = std::unordered_map<AnthemRuntimeSequenceStore::SequenceIdToEventsMap*, SequenceEventListCollection>();
+  pendingSequenceDeletions = std::unordered_map<AnthemRuntimeSequenceStore::SequenceIdToEventsMap*, std::vector<SequenceEventListCollection>>();
   pendingSequenceChannelDeletions = std::unordered_map<
     AnthemRuntimeSequenceStore::SequenceIdToEventsMap*,
     std::vector<
@@ -98,8 +103,27 @@ AnthemRuntimeSequenceStore::~AnthemRuntimeSequenceStore() {
   delete eventLists;
 }
 
+void AnthemRuntimeSequenceStore::sendMap(SequenceIdToEventsMap* map) {
+  unsentMaps.push_back(map);
+  sendUnsentMaps();
+}
+
+void AnthemRuntimeSequenceStore::sendUnsentMaps() {
+  size_t sent = 0;
+
+  // Maps must reach the audio thread in order, so once one doesn't fit, the
+  // rest wait behind it.
+  while (sent < unsentMaps.size() && mapUpdateQueue.tryPush(unsentMaps[sent])) {
+    sent++;
+  }
+
+  unsentMaps.erase(unsentMaps.begin(), unsentMaps.begin() + sent);
+}
+
 void AnthemRuntimeSequenceStore::processMapDeletionQueue() {
-  auto nextMap = mapDeletionQueue.read();
+  sendUnsentMaps();
+
+  auto nextMap = mapDeletionQueue.tryPop();
 
   while (nextMap.has_value()) {
     auto* map = nextMap.value();
@@ -109,7 +133,9 @@ void AnthemRuntimeSequenceStore::processMapDeletionQueue() {
     {
       auto it = pendingSequenceDeletions.find(map);
       if (it != pendingSequenceDeletions.end()) {
-        SequenceEventListCollection::cleanUpInstance(it->second);
+        for (auto& oldSequence : it->second) {
+          SequenceEventListCollection::cleanUpInstance(oldSequence);
+        }
         pendingSequenceDeletions.erase(it);
       }
     }
@@ -131,7 +157,7 @@ void AnthemRuntimeSequenceStore::processMapDeletionQueue() {
 
     delete map;
 
-    nextMap = mapDeletionQueue.read();
+    nextMap = mapDeletionQueue.tryPop();
   }
 }
 
@@ -146,18 +172,40 @@ void AnthemRuntimeSequenceStore::addOrUpdateSequence(const std::string& sequence
   if (it != newMap->end()) {
     // If the sequence already exists, we need to replace it and add the old
     // sequence to the pending deletions map.
-    pendingSequenceDeletions.insert_or_assign(eventLists, it->second);
+    pendingSequenceDeletions[eventLists].push_back(it->second);
   }
 
   newMap->insert_or_assign(sequenceId, sequence);
 
-  mapUpdateQueue.add(newMap);
+  sendMap(newMap);
 
   // The audio thread still has the old pointer. We will clean it up when the
   // audio thread releases it, via the JUCE timer in this class.
   eventLists = newMap;
 }
 
+void AnthemRuntimeSequenceStore::addOrUpdateSequences(std::unordered_map<std::string, SequenceEventListCollection> sequences) {
+  if (sequences.empty()) {
+    return;
+  }
+
+  auto newMap = new std::unordered_map<std::string, SequenceEventListCollection>(*eventLists);
+
+  for (auto& [sequenceId, sequence] : sequences) {
+    auto it = newMap->find(sequenceId);
+
+    if (it != newMap->end()) {
+      pendingSequenceDeletions[eventLists].push_back(it->second);
+    }
+
+    newMap->insert_or_assign(sequenceId, sequence);
+  }
+
+  sendMap(newMap);
+
+  eventLists = newMap;
+}
+
 void AnthemRuntimeSequenceStore::removeSequence(const std::string& sequenceId) {
   auto it = eventLists->find(sequenceId);
 
@@ -165,10 +213,10 @@ void AnthemRuntimeSequenceStore::removeSequence(const std::string& sequenceId) {
     auto newMap = new std::unordered_map<std::string, SequenceEventListCollection>(*eventLists);
     // If the sequence exists, we need to remove it and add it to the pending
     // deletions map.
-    pendingSequenceDeletions.insert_or_assign(eventLists, it->second);
+    pendingSequenceDeletions[eventLists].push_back(it->second);
     newMap->erase(sequenceId);
 
-    mapUpdateQueue.add(newMap);
+    sendMap(newMap);
 
     // The audio thread still has the old pointer. We will clean it up when the
     // audio thread releases it, via the JUCE timer in this class.
@@ -220,7 +268,7 @@ void AnthemRuntimeSequenceStore::addOrUpdateChannelInSequence(const std::string&
 
   newSequenceMap->insert_or_assign(sequenceId, std::move(newSequenceEventListObject));
 
-  mapUpdateQueue.add(newSequenceMap);
+  sendMap(newSequenceMap);
 
   // The audio thread still has the old pointer. We will clean it up when the
   // audio thread releases it, via the JUCE timer in this class.
@@ -263,7 +311,7 @@ void AnthemRuntimeSequenceStore::removeChannelFromSequence(const std::string& se
 
   newSequenceMap->insert_or_assign(sequenceId, std::move(newSequenceEventListObject));
 
-  mapUpdateQueue.add(newSequenceMap);
+  sendMap(newSequenceMap);
 
   // The audio thread still has the old pointer. We will clean it up when the
   // audio thread releases it, via the JUCE timer in this class.
@@ -299,7 +347,7 @@ void AnthemRuntimeSequenceStore::removeChannelFromAllSequences(const std::string
 
   pendingSequenceChannelDeletions.insert_or_assign(eventLists, cleanupVec);
 
-  mapUpdateQueue.add(newMap);
+  sendMap(newMap);
 
   // The audio thread still has the old pointer. We will clean it up when the
   // audio thread releases it, via the JUCE timer in this class.
@@ -25,8 +25,9 @@
 #include <vector>
 #include <memory>
 
+#include "modules/sequencer/events/automation_segment.h"
 #include "modules/sequencer/events/event.h"
-#include "modules/util/thread_safe_queue.h"
+#include "modules/util/ring_buffer.h"
 
 /*
   Anthem compiles each pattern and arrangement into a list of events for each
@@ -50,6 +51,10 @@ struct SequenceEventList {
   // List of events for this channel.
   std::vector<AnthemSequenceEvent>* events;
 
+  // The automation lane for this channel, if it's an automation channel.
+  // Otherwise, this is empty.
+  AnthemAutomationSegmentList* automationSegments;
+
   SequenceEventList();
 
   // These are here so we don't automatically deallocate anything.
@@ -128,10 +133,20 @@ private:
   SequenceIdToEventsMap* rt_eventLists;
 
   // For sending new values of the map to the audio thread
-  ThreadSafeQueue<SequenceIdToEventsMap*> mapUpdateQueue;
+  SpscRingBuffer<SequenceIdToEventsMap*> mapUpdateQueue;
 
   // For the audio thread to send old values of the map to be deleted by the main thread
-  ThreadSafeQueue<SequenceIdToEventsMap*> mapDeletionQueue;
+  SpscRingBuffer<SequenceIdToEventsMap*> mapDeletionQueue;
+
+  // Maps that didn't fit in mapUpdateQueue, oldest first. These are sent from
+  // the main thread once there's room.
+  std::vector<SequenceIdToEventsMap*> unsentMaps;
+
+  // Sends a new map to the audio thread, or holds on to it until there's room
+  // in the queue.
+  void sendMap(SequenceIdToEventsMap* map);
+
+  void sendUnsentMaps();
 
   juce::TimedCallback clearDeletionQueueTimedCallback;
 
@@ -139,7 +154,10 @@ private:
   // This item may still be in use by the audio thread, so we add it here. When
   // the audio thread releases the old pointer, we will clean up the old
   // SequenceEventListCollection.
-  std::unordered_map<SequenceIdToEventsMap*, SequenceEventListCollection> pendingSequenceDeletions;
+  //
+  // This is a vector because addOrUpdateSequences() can replace many sequences
+  // at once.
+  std::unordered_map<SequenceIdToEventsMap*, std::vector<SequenceEventListCollection>> pendingSequenceDeletions;
 
   // The same as the above, except for replacing individual channels in a
   // sequence. We will still clone the outer map in this case, except we will
@@ -196,6 +214,14 @@ public:
   // the old sequence will be added to the pendingSequenceDeletions map.
   void addOrUpdateSequence(const std::string& sequenceId, SequenceEventListCollection sequence);
 
+  // Adds or updates a set of sequences in the event lists map.
+  //
+  // This does the same thing as calling addOrUpdateSequence() for each item,
+  // except that the map is only cloned and sent to the audio thread once. This
+  // is used when loading a project, where there may be many patterns to add at
+  // once.
+  void addOrUpdateSequences(std::unordered_map<std::string, SequenceEventListCollection> sequences);
+
   // Removes a sequence from the event lists map.
   void removeSequence(const std::string& sequenceId);
 
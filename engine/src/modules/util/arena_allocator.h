@@ -1,5 +1,5 @@
 /*
-  Copyright (C) 2024 Joshua Wade
+  Copyright (C) 2024 - 2025 Joshua Wade
 
   This file is part of Anthem.
 
@@ -19,19 +19,21 @@
 
 #pragma once
 
-#include <cstdlib>
-#include <new>
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
-#include <memory>
 #include <juce_core/juce_core.h>
 #include <vector>
 
+#include "modules/util/audio_thread_memory.h"
+
 // Result of an allocation. `success` will be true if the allocation succeeded,
 // and memoryStart will be the start of the allocated array.
 //
 // If you ever want to deallocate the memory, pass deallocatePtr to
-// `ArenaBufferAllocator::free()`.
+// `ArenaBufferAllocator::deallocate()`.
 template <typename T>
 struct ArenaBufferAllocateResult {
   bool success;
@@ -39,249 +41,478 @@ struct ArenaBufferAllocateResult {
   void* deallocatePtr;
 };
 
-// A simple, real-time safe arena allocator for dynamically allocating buffers
-// of a given type.
+// A snapshot of how an ArenaBufferAllocator is being used. All sizes are in
+// bytes, and don't include block headers.
+//
+// Each value is read separately while the allocator may be in use, so
+// together they can be very slightly out of step with each other.
+struct ArenaBufferAllocatorStats {
+  // The total size of all arenas.
+  size_t capacity;
+
+  size_t used;
+
+  // The most that has ever been in use at once.
+  size_t highWater;
+
+  // The number of allocations that have succeeded.
+  size_t allocations;
+
+  size_t free;
+
+  // The size of the largest free block. This is read from the size class
+  // lists, so it can be up to one size class (about 6%) too small.
+  size_t largestFreeBlock;
+
+  // 0 if all free memory is in one block, approaching 1 as free memory is
+  // split into more, smaller blocks.
+  double fragmentation;
+
+  // The number of allocations that failed because there wasn't a large enough
+  // free block.
+  size_t failedAllocations;
+
+  size_t arenaCount;
+};
+
+// A real-time safe allocator for dynamically allocating buffers of a given
+// type.
 //
 // This class allocates a fixed-size memory region ahead of time. Consumers can
 // then call `allocate()` to allocate a buffer of a given size. Since the memory
 // is pre-allocated, this class is real-time safe.
 //
+// Free blocks are tracked with a two-level segregated fit (TLSF) scheme:
+// - Blocks are sorted into size classes. The first level splits sizes by
+//   power of two, and the second level splits each power of two into 16
+//   linear steps.
+// - Each size class has a free list, and bitmaps record which lists are
+//   non-empty, so finding a block that fits is a couple of bit scans.
+// - Each block has a header with its size and a pointer to the block before
+//   it in memory, so a freed block is merged with its free neighbors right
+//   away.
+//
+// Both allocate() and deallocate() take constant time, no matter how many
+// blocks there are, and there's never a separate coalescing pass.
+//
 // A couple notes:
 //
 // - When this class is deallocated, the memory is freed. However, no
 //   destructors are called. If data stored in the arena needs to be cleaned up,
 //   it must be cleaned up before the arena is deallocated.
 //
-// - If the arena runs out of space, a new arena is allocated. This is not
-//   real-time safe, so the original arena shuold sized so that this does not
-//   happen under most circumstances.
+// - If canGrow is true and the arena runs out of space, a new arena is
+//   allocated from the OS. This is not real-time safe, so allocators that are
+//   used on the audio thread (e.g. the event allocator in the graph compiler)
+//   turn this off, and allocations that don't fit fail instead. The arena
+//   should be sized so that this doesn't happen under most circumstances.
+//
+// - Arenas come from AnthemAudioThreadMemory, so they are pre-faulted, and
+//   locked into memory if that's turned on. The audio thread doesn't take a
+//   page fault the first time it writes to an event buffer.
+//
+// - Allocation and deallocation are guarded by a spin lock, since the graph
+//   processor can run nodes that share an allocator on multiple threads (see
+//   AnthemGraphParallelExecutor). This is uncontended in the common case, and
+//   these calls only happen when an event buffer needs to grow.
+//
+// - Statistics are kept in atomics that are updated while the lock is held,
+//   so getStats() can be called from the message thread without taking the
+//   lock. Otherwise, the audio thread could end up spinning while a
+//   lower-priority thread holds it.
 template<typename T>
 class ArenaBufferAllocator {
 private:
+  // Every block starts with this header. For free blocks, the first part of
+  // the block's memory holds the free list links.
+  struct BlockHeader {
+    // The block just before this one in memory, or nullptr if this is the
+    // first block in its arena.
+    BlockHeader* previousPhysical;
+
+    // The size of the block's memory, not including this header. The lowest
+    // bit is set if the block is free.
+    size_t sizeAndFlags;
+
+    static constexpr size_t freeFlag = 1;
+
+    size_t getSize() {
+      return sizeAndFlags & ~freeFlag;
+    }
+
+    bool isFree() {
+      return (sizeAndFlags & freeFlag) != 0;
+    }
+
+    void set(size_t size, bool free) {
+      sizeAndFlags = size | (free ? freeFlag : 0);
+    }
+
+    void* getMemory() {
+      return reinterpret_cast<uint8_t*>(this) + headerSize;
+    }
+
+    BlockHeader* getNextPhysical() {
+      return reinterpret_cast<BlockHeader*>(reinterpret_cast<uint8_t*>(getMemory()) + getSize());
+    }
+
+    BlockHeader*& nextFree() {
+      return reinterpret_cast<FreeLinks*>(getMemory())->next;
+    }
+
+    BlockHeader*& previousFree() {
+      return reinterpret_cast<FreeLinks*>(getMemory())->previous;
+    }
+  };
+
+  struct FreeLinks {
+    BlockHeader* next;
+    BlockHeader* previous;
+  };
+
+  // Block memory is aligned to this, and block sizes are multiples of it.
+  static constexpr size_t alignment = alignof(std::max_align_t);
+  static constexpr size_t headerSize = (sizeof(BlockHeader) + alignment - 1) / alignment * alignment;
+
+  // A block must be able to hold its free list links once it's freed.
+  static constexpr size_t minBlockSize = (sizeof(FreeLinks) + alignment - 1) / alignment * alignment;
+
+  static constexpr int secondLevelCountLog2 = 4;
+  static constexpr int secondLevelCount = 1 << secondLevelCountLog2;
+
+  // Blocks smaller than this all go in the first first-level class, which is
+  // split linearly.
+  static constexpr int firstLevelShift = secondLevelCountLog2 + std::countr_zero(alignment);
+  static constexpr size_t smallBlockSize = size_t(1) << firstLevelShift;
+
+  // This supports blocks of up to 2^firstLevelMax bytes.
+  static constexpr int firstLevelMax = 39;
+  static constexpr int firstLevelCount = firstLevelMax - firstLevelShift + 1;
+
+  static_assert(alignof(T) <= alignment, "ArenaBufferAllocator doesn't support over-aligned types.");
+  static_assert(firstLevelCount <= 32, "The first-level bitmap must fit in 32 bits.");
+
+  uint32_t firstLevelBitmap = 0;
+  uint32_t secondLevelBitmaps[firstLevelCount] = {};
+  BlockHeader* freeLists[firstLevelCount][secondLevelCount] = {};
+
   // The size of each arena buffer in bytes.
   size_t arenaSizeInBytes;
 
-  // The amount of memory that has been freed since the last coalesce.
-  size_t freedAmountSinceLastCoalesce = 0;
+  // See the class comment.
+  bool canGrow;
 
   // A list of void* pointers to arenas that have been allocated, each with a
   // size of arenaSizeInBytes.
-  //
-  // We have a list in case the first buffer overflows. Since this is used on
-  // the audio thread, the first buffer should only overflow in extreme
-  // circumstances, since overflowing will result in additional memory
-  // allocation, which is not real-time safe.
   std::vector<void*> arenas;
 
   // The minimum size of each arena buffer in bytes.
   const size_t minArenaSize = 1024;
 
-  void markFree(void* position, size_t sizeInBytes);
+  // Statistics. See the class comment.
+  std::atomic<size_t> capacity = 0;
+  std::atomic<size_t> used = 0;
+  std::atomic<size_t> freeSize = 0;
+  std::atomic<size_t> highWater = 0;
+  std::atomic<size_t> allocations = 0;
+  std::atomic<size_t> failedAllocations = 0;
+  std::atomic<size_t> largestFreeBlock = 0;
+  std::atomic<size_t> arenaCount = 0;
+
+  // Records the size of the largest free block. This is read from the size
+  // class lists, so it only takes a couple of bit scans. It must be called
+  // with the lock held, after the free lists change.
+  void updateLargestFreeBlock() {
+    size_t size = 0;
+
+    if (firstLevelBitmap != 0) {
+      auto firstLevel = 31 - std::countl_zero(firstLevelBitmap);
+      auto secondLevel = 31 - std::countl_zero(secondLevelBitmaps[firstLevel]);
+      size = freeLists[firstLevel][secondLevel]->getSize();
+    }
+
+    largestFreeBlock.store(size, std::memory_order_relaxed);
+  }
+
+  juce::SpinLock lock;
+
+  // Gets the size class for a block of the given size.
+  static void mapping(size_t size, int& firstLevel, int& secondLevel) {
+    if (size < smallBlockSize) {
+      firstLevel = 0;
+      secondLevel = static_cast<int>(size / (smallBlockSize / secondLevelCount));
+    } else {
+      auto topBit = static_cast<int>(std::bit_width(size)) - 1;
+      secondLevel = static_cast<int>((size >> (topBit - secondLevelCountLog2)) ^ (size_t(1) << secondLevelCountLog2));
+      firstLevel = topBit - (firstLevelShift - 1);
+    }
+  }
+
+  // Gets the smallest size class where every block is at least the given
+  // size, so the first block in any list we find from here is big enough.
+  static void mappingForSearch(size_t size, int& firstLevel, int& secondLevel) {
+    if (size >= smallBlockSize) {
+      auto topBit = static_cast<int>(std::bit_width(size)) - 1;
+      size += (size_t(1) << (topBit - secondLevelCountLog2)) - 1;
+    }
+
+    mapping(size, firstLevel, secondLevel);
+  }
+
+  void insertFreeBlock(BlockHeader* block) {
+    int firstLevel, secondLevel;
+    mapping(block->getSize(), firstLevel, secondLevel);
+
+    auto* head = freeLists[firstLevel][secondLevel];
+
+    block->nextFree() = head;
+    block->previousFree() = nullptr;
+
+    if (head != nullptr) {
+      head->previousFree() = block;
+    }
+
+    freeLists[firstLevel][secondLevel] = block;
+    firstLevelBitmap |= 1u << firstLevel;
+    secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+
+    freeSize.fetch_add(block->getSize(), std::memory_order_relaxed);
+  }
+
+  void removeFreeBlock(BlockHeader* block) {
+    int firstLevel, secondLevel;
+    mapping(block->getSize(), firstLevel, secondLevel);
+
+    freeSize.fetch_sub(block->getSize(), std::memory_order_relaxed);
+
+    auto* next = block->nextFree();
+    auto* previous = block->previousFree();
+
+    if (next != nullptr) {
+      next->previousFree() = previous;
+    }
+
+    if (previous != nullptr) {
+      previous->nextFree() = next;
+    } else {
+      freeLists[firstLevel][secondLevel] = next;
 
-  // Allocates memory in an arena.
-  ArenaBufferAllocateResult<T> allocateInArena(void* arena, size_t numItems);
+      if (next == nullptr) {
+        secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+
+        if (secondLevelBitmaps[firstLevel] == 0) {
+          firstLevelBitmap &= ~(1u << firstLevel);
+        }
+      }
+    }
+  }
+
+  // Finds a free block of at least the given size, or nullptr if there isn't
+  // one.
+  BlockHeader* findFreeBlock(size_t size) {
+    int firstLevel, secondLevel;
+    mappingForSearch(size, firstLevel, secondLevel);
+
+    if (firstLevel >= firstLevelCount) {
+      return nullptr;
+    }
+
+    auto secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+
+    if (secondLevelMap == 0) {
+      auto firstLevelMap = firstLevel + 1 < 32 ? firstLevelBitmap & (~0u << (firstLevel + 1)) : 0;
+
+      if (firstLevelMap == 0) {
+        return nullptr;
+      }
+
+      firstLevel = std::countr_zero(firstLevelMap);
+      secondLevelMap = secondLevelBitmaps[firstLevel];
+    }
+
+    secondLevel = std::countr_zero(secondLevelMap);
+
+    return freeLists[firstLevel][secondLevel];
+  }
+
+  // Sets up a new arena as one free block, followed by an empty block that
+  // is never free, so merging never runs off the end.
+  void addArena(void* arena, size_t arenaSize) {
+    auto blockSize = (arenaSize - 2 * headerSize) / alignment * alignment;
+
+    auto* block = static_cast<BlockHeader*>(arena);
+    block->previousPhysical = nullptr;
+    block->set(blockSize, true);
+
+    auto* sentinel = block->getNextPhysical();
+    sentinel->previousPhysical = block;
+    sentinel->set(0, false);
+
+    insertFreeBlock(block);
+
+    arenas.push_back(arena);
+    capacity.fetch_add(blockSize, std::memory_order_relaxed);
+    arenaCount.store(arenas.size(), std::memory_order_relaxed);
+    updateLargestFreeBlock();
+  }
+
+  // Merges the block with the one after it in memory. The caller must have
+  // taken both out of the free lists.
+  static void merge(BlockHeader* block, BlockHeader* next) {
+    block->set(block->getSize() + headerSize + next->getSize(), block->isFree());
+    block->getNextPhysical()->previousPhysical = block;
+  }
 
-  // Coalesces the arena, merging adjacent free sections.
-  void coalesceInArena(void* arena);
 public:
   // Creates an ArenaBufferAllocator. arenaSizeInBytes is the size of the arena
   // in bytes.
-  ArenaBufferAllocator(size_t arenaSizeInBytes);
+  ArenaBufferAllocator(size_t arenaSizeInBytes, bool canGrow = true);
   ~ArenaBufferAllocator();
 
   // Allocates memory in the arena.
+  //
+  // This takes constant time, unless the arena is full and a new one needs to
+  // be allocated (see canGrow).
   ArenaBufferAllocateResult<T> allocate(size_t numItems);
 
   // Frees the memory chunk at the given address. This is expected to be a
-  // deallocatePtr returned from allocate().
+  // deallocatePtr returned from allocate(). This takes constant time.
   void deallocate(void* deallocatePtr);
 
-  // Coalesces the arena, merging adjacent free sections.
-  void coalesce();
-
   // Returns the number of arenas that have been allocated. This should be 1 in
   // normal circumstances.
   unsigned int getArenaCount();
-};
 
-template<typename T>
-void ArenaBufferAllocator<T>::markFree(void* position, size_t sizeInBytes) {
-  *reinterpret_cast<size_t*>(position) = sizeInBytes;
-  *reinterpret_cast<bool*>(static_cast<uint8_t*>(position) + sizeof(size_t)) = false;
-}
+  // The number of bytes of arena that an allocation of numItems takes up,
+  // including its block header. This is useful for sizing arenas.
+  static constexpr size_t getFootprint(size_t numItems) {
+    return headerSize + std::max((sizeof(T) * numItems + alignment - 1) / alignment * alignment, minBlockSize);
+  }
+
+  // Each arena has this much bookkeeping on top of its blocks.
+  static constexpr size_t arenaOverhead = 2 * headerSize;
+
+  // Gets statistics about the allocator. This doesn't take the lock, so it
+  // can be called from any thread while the allocator is in use.
+  ArenaBufferAllocatorStats getStats();
+};
 
 template<typename T>
-ArenaBufferAllocator<T>::ArenaBufferAllocator(size_t arenaSizeInBytes) {
+ArenaBufferAllocator<T>::ArenaBufferAllocator(size_t arenaSizeInBytes, bool canGrow) : canGrow(canGrow) {
   auto arenaSize = std::max(arenaSizeInBytes, this->minArenaSize);
 
   this->arenaSizeInBytes = arenaSize;
 
-  auto ptr = malloc(arenaSize);
-
-  if (ptr == nullptr) {
-    throw std::bad_alloc();
-  }
-
-  this->arenas.push_back(ptr);
-
-  this->markFree(ptr, arenaSize);
+  this->addArena(AnthemAudioThreadMemory::allocate(arenaSize), arenaSize);
 }
 
 template<typename T>
 ArenaBufferAllocator<T>::~ArenaBufferAllocator() {
   for (auto arena : this->arenas) {
-    free(arena);
+    AnthemAudioThreadMemory::deallocate(arena, this->arenaSizeInBytes);
   }
 }
 
 template<typename T>
-ArenaBufferAllocateResult<T> ArenaBufferAllocator<T>::allocateInArena(void* arena, size_t numItems) {
-  void* regionStart = arena;
-  while (regionStart < static_cast<uint8_t*>(arena) + this->arenaSizeInBytes) {
-    size_t sectionSizeInBytes = *reinterpret_cast<size_t*>(regionStart);
-
-    // Check if the section is in use
-    bool isInUse = *reinterpret_cast<bool*>(static_cast<uint8_t*>(regionStart) + sizeof(size_t));
-    if (isInUse) {
-      regionStart = static_cast<uint8_t*>(regionStart) + sectionSizeInBytes;
-      continue;
-    }
+ArenaBufferAllocateResult<T> ArenaBufferAllocator<T>::allocate(size_t numItems) {
+  const juce::SpinLock::ScopedLockType scopedLock(this->lock);
 
-    // Calculate the start of the section, accounting for metadata
-    void* sectionStart = static_cast<uint8_t*>(regionStart) + sizeof(size_t) + sizeof(bool);
-    size_t alignment = alignof(T);
-    
-    // Adjust the available size for alignment, subtracting metadata
-    size_t adjustedSize = sectionSizeInBytes - sizeof(size_t) - sizeof(bool);
-    size_t adjustedSizeOriginal = adjustedSize;
-
-    // Check if the section can be aligned and has enough space
-    if (std::align(alignment, sizeof(T) * numItems, sectionStart, adjustedSize)) {
-      auto sizeAdjustmentAmount = adjustedSizeOriginal - adjustedSize;
-
-      size_t requiredSize = sizeof(T) * numItems;
-      if (adjustedSize >= requiredSize) {
-        auto newSectionSize = sizeof(size_t) + sizeof(bool) + sizeAdjustmentAmount + requiredSize;
-
-        // Calculate the start of the free section after the allocated memory
-        auto nextSectionStart = static_cast<uint8_t*>(regionStart) + newSectionSize;
-        auto nextSectionSize = sectionSizeInBytes - newSectionSize;
-
-        // Write a new size for the section
-        *reinterpret_cast<size_t*>(regionStart) = newSectionSize;
-
-        // Mark the section as in use
-        *reinterpret_cast<bool*>(static_cast<uint8_t*>(regionStart) + sizeof(size_t)) = true;
-
-        // If there is enough space for a new section, mark it as free
-        if (nextSectionSize >= sizeof(size_t) + sizeof(bool)) {
-          // Mark the next section as free
-          this->markFree(
-            nextSectionStart,
-            nextSectionSize
-          );
-        } else if (nextSectionSize > 0) {
-          // If there is not enough space for a new section, make sure that the
-          // current section's size includes the remaining space
-          *reinterpret_cast<size_t*>(regionStart) = sectionSizeInBytes;
-        }
+  auto size = std::max(
+    (sizeof(T) * numItems + alignment - 1) / alignment * alignment,
+    minBlockSize
+  );
 
-        // Return the memory
-        return { true, reinterpret_cast<T*>(sectionStart), regionStart };
-      }
-    }
+  auto* block = this->findFreeBlock(size);
 
-    jassert(sectionSizeInBytes > 0);
+  // If no arena had enough space, allocate a new one, if we're allowed to
+  if (block == nullptr && this->canGrow && size + 2 * headerSize <= this->arenaSizeInBytes) {
+    this->addArena(AnthemAudioThreadMemory::allocate(this->arenaSizeInBytes), this->arenaSizeInBytes);
+    block = this->findFreeBlock(size);
+  }
 
-    // If this section didn't work, move to the next one
-    regionStart = static_cast<uint8_t*>(regionStart) + sectionSizeInBytes;
+  if (block == nullptr) {
+    this->failedAllocations.fetch_add(1, std::memory_order_relaxed);
+    return { false, nullptr, nullptr };
   }
 
-  // If no section was found, return a failure
-  return { false, nullptr, nullptr };
-}
+  this->removeFreeBlock(block);
 
-template<typename T>
-ArenaBufferAllocateResult<T> ArenaBufferAllocator<T>::allocate(size_t numItems) {
-  for (auto arena : this->arenas) {
-    auto result = this->allocateInArena(arena, numItems);
-    if (result.success) {
-      return result;
-    }
-  }
+  // If there's enough left over for another block, split it off and free it
+  auto remainingSize = block->getSize() - size;
 
-  // If no arena had enough space, allocate a new one
-  auto arenaSize = std::max(this->arenaSizeInBytes, this->minArenaSize);
-  auto ptr = malloc(arenaSize);
+  if (remainingSize >= headerSize + minBlockSize) {
+    block->set(size, false);
 
-  if (ptr == nullptr) {
-    throw std::bad_alloc();
-  }
+    auto* remainder = block->getNextPhysical();
+    remainder->previousPhysical = block;
+    remainder->set(remainingSize - headerSize, true);
+    remainder->getNextPhysical()->previousPhysical = remainder;
 
-  this->arenas.push_back(ptr);
+    this->insertFreeBlock(remainder);
+  } else {
+    block->set(block->getSize(), false);
+  }
 
-  this->markFree(ptr, arenaSize);
+  auto newUsed = this->used.load(std::memory_order_relaxed) + block->getSize();
+  this->used.store(newUsed, std::memory_order_relaxed);
+  this->highWater.store(std::max(this->highWater.load(std::memory_order_relaxed), newUsed), std::memory_order_relaxed);
+  this->allocations.fetch_add(1, std::memory_order_relaxed);
+  this->updateLargestFreeBlock();
 
-  return this->allocateInArena(ptr, numItems);
+  return { true, static_cast<T*>(block->getMemory()), block };
 }
 
 template<typename T>
 void ArenaBufferAllocator<T>::deallocate(void* deallocatePtr) {
-  void* regionStart = deallocatePtr;
-
-  uint8_t* sizePtr = static_cast<uint8_t*>(regionStart);
-  size_t sectionSizeInBytes = *reinterpret_cast<size_t*>(sizePtr);
-
-  *reinterpret_cast<bool*>(sizePtr + sizeof(size_t)) = false;
-
-  this->freedAmountSinceLastCoalesce += sectionSizeInBytes;
+  const juce::SpinLock::ScopedLockType scopedLock(this->lock);
 
-  // If we've freed a lot of memory, coalesce the arenas
-  if (this->freedAmountSinceLastCoalesce > this->arenaSizeInBytes / 2) {
-    this->coalesce();
-    this->freedAmountSinceLastCoalesce = 0;
-  }
-}
+  auto* block = static_cast<BlockHeader*>(deallocatePtr);
 
-template<typename T>
-void ArenaBufferAllocator<T>::coalesceInArena(void* arena) {
-  void* regionStart = arena;
-  while (regionStart < static_cast<uint8_t*>(arena) + this->arenaSizeInBytes) {
-    size_t sectionSizeInBytes = *reinterpret_cast<size_t*>(regionStart);
-    bool isInUse = *reinterpret_cast<bool*>(static_cast<uint8_t*>(regionStart) + sizeof(size_t));
-    if (isInUse) {
-      regionStart = static_cast<uint8_t*>(regionStart) + sectionSizeInBytes;
-      continue;
-    }
+  jassert(!block->isFree());
 
-    void* nextRegionStart = static_cast<uint8_t*>(regionStart) + sectionSizeInBytes;
-    if (nextRegionStart >= static_cast<uint8_t*>(arena) + this->arenaSizeInBytes) {
-      break;
-    }
+  this->used.fetch_sub(block->getSize(), std::memory_order_relaxed);
+  block->set(block->getSize(), true);
 
-    size_t nextSectionSizeInBytes = *reinterpret_cast<size_t*>(nextRegionStart);
-    bool isNextInUse = *reinterpret_cast<bool*>(static_cast<uint8_t*>(nextRegionStart) + sizeof(size_t));
+  auto* next = block->getNextPhysical();
 
-    if (!isNextInUse) {
-      size_t newSize = sectionSizeInBytes + nextSectionSizeInBytes;
-      *reinterpret_cast<size_t*>(regionStart) = newSize;
-      continue;  // Stay at the current regionStart to check for further coalescing
-    }
+  if (next->isFree()) {
+    this->removeFreeBlock(next);
+    merge(block, next);
+  }
 
-    jassert(nextRegionStart != regionStart);
+  auto* previous = block->previousPhysical;
 
-    regionStart = nextRegionStart;
+  if (previous != nullptr && previous->isFree()) {
+    this->removeFreeBlock(previous);
+    merge(previous, block);
+    block = previous;
   }
+
+  this->insertFreeBlock(block);
+  this->updateLargestFreeBlock();
 }
 
 template<typename T>
-void ArenaBufferAllocator<T>::coalesce() {
-  for (auto arena : this->arenas) {
-    this->coalesceInArena(arena);
-  }
+unsigned int ArenaBufferAllocator<T>::getArenaCount() {
+  return static_cast<unsigned int>(this->arenaCount.load(std::memory_order_relaxed));
 }
 
 template<typename T>
-unsigned int ArenaBufferAllocator<T>::getArenaCount() {
-  return this->arenas.size();
+ArenaBufferAllocatorStats ArenaBufferAllocator<T>::getStats() {
+  auto freeBytes = this->freeSize.load(std::memory_order_relaxed);
+  auto largestFree = this->largestFreeBlock.load(std::memory_order_relaxed);
+
+  return ArenaBufferAllocatorStats {
+    .capacity = this->capacity.load(std::memory_order_relaxed),
+    .used = this->used.load(std::memory_order_relaxed),
+    .highWater = this->highWater.load(std::memory_order_relaxed),
+    .allocations = this->allocations.load(std::memory_order_relaxed),
+    .free = freeBytes,
+    .largestFreeBlock = largestFree,
+    .fragmentation = freeBytes > 0 && largestFree <= freeBytes
+      ? 1.0 - static_cast<double>(largestFree) / static_cast<double>(freeBytes)
+      : 0.0,
+    .failedAllocations = this->failedAllocations.load(std::memory_order_relaxed),
+    .arenaCount = this->arenaCount.load(std::memory_order_relaxed),
+  };
 }
@@ -0,0 +1,171 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "audio_thread_memory.h"
+
+#include <atomic>
+#include <new>
+
+#include <juce_core/juce_core.h>
+
+#if JUCE_WINDOWS
+  #include <windows.h>
+  #include <psapi.h>
+#else
+  #include <sys/mman.h>
+  #include <sys/resource.h>
+  #include <unistd.h>
+#endif
+
+namespace {
+  std::atomic<bool> lockingEnabled { false };
+
+  // The size at which it's worth asking for transparent huge pages.
+  constexpr size_t hugePageThreshold = 2 * 1024 * 1024;
+
+  size_t roundUpToPageSize(size_t sizeInBytes) {
+    auto pageSize = AnthemAudioThreadMemory::getPageSize();
+    return (sizeInBytes + pageSize - 1) / pageSize * pageSize;
+  }
+}
+
+size_t AnthemAudioThreadMemory::getPageSize() {
+  static const size_t pageSize = []() -> size_t {
+#if JUCE_WINDOWS
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<size_t>(info.dwPageSize);
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+  }();
+
+  return pageSize;
+}
+
+void AnthemAudioThreadMemory::prefault(void* data, size_t sizeInBytes) {
+  if (data == nullptr || sizeInBytes == 0) {
+    return;
+  }
+
+  auto* bytes = static_cast<volatile uint8_t*>(data);
+  auto pageSize = getPageSize();
+
+  // A read alone could be served by the shared zero page, so we write the
+  // byte back.
+  for (size_t offset = 0; offset < sizeInBytes; offset += pageSize) {
+    bytes[offset] = bytes[offset];
+  }
+
+  bytes[sizeInBytes - 1] = bytes[sizeInBytes - 1];
+}
+
+void AnthemAudioThreadMemory::setLockingEnabled(bool enabled) {
+  lockingEnabled.store(enabled);
+}
+
+bool AnthemAudioThreadMemory::isLockingEnabled() {
+  return lockingEnabled.load();
+}
+
+void* AnthemAudioThreadMemory::allocate(size_t sizeInBytes) {
+  auto size = roundUpToPageSize(sizeInBytes);
+
+#if JUCE_WINDOWS
+  void* data = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (data == MAP_FAILED) {
+    data = nullptr;
+  }
+#endif
+
+  if (data == nullptr) {
+    throw std::bad_alloc();
+  }
+
+#if JUCE_LINUX && defined(MADV_HUGEPAGE)
+  if (size >= hugePageThreshold) {
+    madvise(data, size, MADV_HUGEPAGE);
+  }
+#endif
+
+  prefault(data, size);
+
+  if (isLockingEnabled()) {
+#if JUCE_WINDOWS
+    auto locked = VirtualLock(data, size) != 0;
+#else
+    auto locked = mlock(data, size) == 0;
+#endif
+
+    if (!locked) {
+      juce::Logger::writeToLog(
+        "Could not lock " + juce::String(static_cast<juce::int64>(size)) +
+        " bytes of audio thread memory. Continuing with unlocked memory."
+      );
+    }
+  }
+
+  return data;
+}
+
+void AnthemAudioThreadMemory::deallocate(void* data, size_t sizeInBytes) {
+  if (data == nullptr) {
+    return;
+  }
+
+  auto size = roundUpToPageSize(sizeInBytes);
+
+  // Unmapping also unlocks, so we don't need to track which allocations were
+  // locked.
+#if JUCE_WINDOWS
+  juce::ignoreUnused(size);
+  VirtualFree(data, 0, MEM_RELEASE);
+#else
+  munmap(data, size);
+#endif
+}
+
+int64_t AnthemAudioThreadMemory::getPageFaultCount() {
+#if JUCE_WINDOWS
+  PROCESS_MEMORY_COUNTERS counters;
+
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return 0;
+  }
+
+  return static_cast<int64_t>(counters.PageFaultCount);
+#else
+  #if defined(RUSAGE_THREAD)
+    const int who = RUSAGE_THREAD;
+  #else
+    const int who = RUSAGE_SELF;
+  #endif
+
+  rusage usage {};
+
+  if (getrusage(who, &usage) != 0) {
+    return 0;
+  }
+
+  return static_cast<int64_t>(usage.ru_minflt) + static_cast<int64_t>(usage.ru_majflt);
+#endif
+}
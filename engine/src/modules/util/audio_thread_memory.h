@@ -0,0 +1,61 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Helpers for keeping memory that the audio thread touches resident.
+//
+// Memory from malloc isn't backed by physical pages until it's first written
+// to, and the OS is free to page it out again later. Either way, the next
+// access from the audio thread takes a page fault, which can easily cost more
+// than a whole block. We avoid the first kind by pre-faulting memory on the
+// thread that allocates it, and the second kind, optionally, by locking it.
+namespace AnthemAudioThreadMemory {
+  size_t getPageSize();
+
+  // Writes to every page in the given range, so that each one is backed by
+  // physical memory before the audio thread gets to it. The contents are not
+  // changed.
+  void prefault(void* data, size_t sizeInBytes);
+
+  // Whether allocate() should lock the memory it returns. This is off by
+  // default, since locked memory is limited (see `ulimit -l`) and a failed
+  // lock just means we fall back to unlocked memory.
+  void setLockingEnabled(bool enabled);
+  bool isLockingEnabled();
+
+  // Allocates page-aligned memory that is pre-faulted and, if locking is
+  // enabled, locked into physical memory. Large allocations also ask the OS
+  // for huge pages where that's supported, which cuts down on TLB misses.
+  //
+  // This is not real-time safe. Memory from this must be freed with deallocate(),
+  // using the same size.
+  void* allocate(size_t sizeInBytes);
+  void deallocate(void* data, size_t sizeInBytes);
+
+  // The number of page faults taken so far. On Linux, this only counts faults
+  // on the calling thread. Elsewhere, it counts faults for the whole process.
+  //
+  // This is a system call, so it shouldn't be called on the audio thread
+  // unless we're specifically measuring page faults there.
+  int64_t getPageFaultCount();
+}
@@ -0,0 +1,70 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+// Denormal (subnormal) floats are the tiny values between zero and the
+// smallest normal float. On x86, arithmetic on them can be 10 to 100 times
+// slower than on normal floats, and decaying signals such as release tails,
+// filter feedback and reverb tails can spend a long time in that range.
+//
+// Our policy is that every thread that runs processors turns on flush-to-zero
+// and denormals-are-zero for as long as it's processing, by putting a
+// juce::ScopedNoDenormals at the top of its work. Currently, that's:
+// - the audio device callback (AnthemAudioCallback),
+// - the offline render thread (AnthemOfflineRenderer), and
+// - graph worker threads (AnthemGraphParallelExecutor).
+//
+// Any new thread that calls into the graph processor or into processors
+// needs to do the same. In debug builds, ProcessNodeAction checks each node's
+// outputs with the helpers below and logs the first node it finds writing
+// denormals, which usually means a thread is missing this.
+namespace AnthemDenormals {
+  // Checks the bits directly rather than comparing, since with
+  // denormals-are-zero on, a denormal compares equal to zero.
+  inline bool isDenormal(float value) {
+    auto bits = std::bit_cast<uint32_t>(value);
+    return (bits & 0x7f800000u) == 0 && (bits & 0x007fffffu) != 0;
+  }
+
+  inline int countDenormals(const float* samples, int numSamples) {
+    int count = 0;
+
+    for (int i = 0; i < numSamples; i++) {
+      count += isDenormal(samples[i]) ? 1 : 0;
+    }
+
+    return count;
+  }
+
+  inline bool containsDenormals(const juce::AudioSampleBuffer& buffer, int numSamples) {
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++) {
+      if (countDenormals(buffer.getReadPointer(channel), numSamples) > 0) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+}
@@ -24,11 +24,21 @@ LinearParameterSmoother::LinearParameterSmoother(float initialValue, float durat
   currentValue = initialValue;
   this->duration = duration;
   timeRemaining = 0.0f;
+  rate = 0.0f;
 }
 
 void LinearParameterSmoother::setTargetValue(float targetValue) {
   this->targetValue = targetValue;
+
+  if (duration <= 0.0f) {
+    currentValue = targetValue;
+    timeRemaining = 0.0f;
+    rate = 0.0f;
+    return;
+  }
+
   timeRemaining = duration;
+  rate = (targetValue - currentValue) / duration;
 }
 
 float LinearParameterSmoother::getCurrentValue() {
@@ -39,12 +49,21 @@ float LinearParameterSmoother::getTargetValue() {
   return targetValue;
 }
 
+float LinearParameterSmoother::getTimeRemaining() {
+  return timeRemaining;
+}
+
+float LinearParameterSmoother::getRate() {
+  return rate;
+}
+
 void LinearParameterSmoother::process(float deltaTime) {
-  if (timeRemaining > 0.0f) {
-    float step = deltaTime / duration;
-    currentValue = currentValue + (targetValue - currentValue) * step;
+  if (timeRemaining > deltaTime) {
+    currentValue += rate * deltaTime;
     timeRemaining -= deltaTime;
   } else {
     currentValue = targetValue;
+    timeRemaining = 0.0f;
+    rate = 0.0f;
   }
 }
@@ -17,6 +17,12 @@
   along with Anthem. If not, see <https://www.gnu.org/licenses/>.
 */
 
+// Moves a value toward a target in a straight line, reaching it after a fixed
+// duration.
+//
+// Since the path is a straight line, a block of smoothing can be written to a
+// control buffer as one or two breakpoints instead of a value per sample. See
+// WriteParametersToControlInputsAction.
 class LinearParameterSmoother {
 private:
   float targetValue;
@@ -24,11 +30,21 @@ private:
   float duration;
   float timeRemaining;
 
+  // The change in value per second while moving toward the target.
+  float rate;
+
 public:
   LinearParameterSmoother(float initialValue, float duration);
 
   void setTargetValue(float targetValue);
   float getCurrentValue();
   float getTargetValue();
+
+  // The time until the target is reached, in seconds.
+  float getTimeRemaining();
+
+  // The change in value per second until the target is reached.
+  float getRate();
+
   void process(float deltaTime);
 };
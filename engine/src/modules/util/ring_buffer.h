@@ -0,0 +1,260 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+
+/*
+  Lock-free ring buffers for passing data between threads.
+
+  SpscRingBuffer is for one producer thread and one consumer thread, such as
+  the message thread sending new graphs to the audio thread.
+
+  It has a fixed capacity, which is set when it's created, and it doesn't
+  allocate or lock after that. Pushing to a full buffer fails instead of
+  dropping the item or waiting, so the caller has to decide what to do. For
+  pointers that own memory, this usually means holding on to the item and
+  trying again later.
+
+  Items are moved in and out of a preallocated array, so T must be default
+  constructible and move assignable. Items that have been popped are left in
+  a moved-from state until they're overwritten.
+*/
+
+// The size of a cache line on the platforms we support. The read and write
+// positions are kept on separate cache lines, so the producer and consumer
+// don't slow each other down by writing to the same line.
+//
+// std::hardware_destructive_interference_size would be the standard way to
+// get this, but it isn't available everywhere, and it varies by compiler flag.
+constexpr size_t RING_BUFFER_CACHE_LINE_SIZE = 64;
+
+// Waits with increasing sleeps. Used by the blocking pop methods below, which
+// must not be called from the audio thread.
+class RingBufferBackoff {
+private:
+  int attempts = 0;
+
+public:
+  void wait() {
+    if (attempts < 64) {
+      std::this_thread::yield();
+    } else {
+      auto exponent = std::min(attempts - 64, 5);
+      std::this_thread::sleep_for(std::chrono::microseconds(32 << exponent));
+    }
+
+    attempts++;
+  }
+};
+
+// Rounds up to the next power of two, so ring positions can be wrapped with a
+// mask instead of a division.
+constexpr size_t ringBufferCapacityFor(size_t requestedCapacity) {
+  size_t capacity = 1;
+
+  while (capacity < requestedCapacity) {
+    capacity <<= 1;
+  }
+
+  return capacity;
+}
+
+// A single-producer, single-consumer ring buffer.
+//
+// Methods are marked with the thread that may call them. The producer and
+// consumer can be different threads over time (for example, the audio device
+// thread and then an offline render thread), as long as there is only one of
+// each at a time.
+template <typename T>
+class SpscRingBuffer {
+private:
+  // Positions only ever count up. They're wrapped to a slot with the mask.
+  struct alignas(RING_BUFFER_CACHE_LINE_SIZE) ProducerState {
+    std::atomic<size_t> writePosition { 0 };
+
+    // The producer's last look at the read position. Refreshing this means
+    // reading the consumer's cache line, so we only do it when the buffer
+    // looks full.
+    size_t cachedReadPosition = 0;
+  };
+
+  struct alignas(RING_BUFFER_CACHE_LINE_SIZE) ConsumerState {
+    std::atomic<size_t> readPosition { 0 };
+
+    // The same as above, for the consumer.
+    size_t cachedWritePosition = 0;
+  };
+
+  ProducerState producer;
+  ConsumerState consumer;
+
+  size_t capacity;
+  size_t mask;
+  std::unique_ptr<T[]> slots;
+
+  // Producer only. Returns how many slots are free, refreshing our view of
+  // the read position if there seem to be fewer than needed.
+  size_t getFreeSlots(size_t writePosition, size_t needed) {
+    auto freeSlots = capacity - (writePosition - producer.cachedReadPosition);
+
+    if (freeSlots < needed) {
+      producer.cachedReadPosition = consumer.readPosition.load(std::memory_order_acquire);
+      freeSlots = capacity - (writePosition - producer.cachedReadPosition);
+    }
+
+    return freeSlots;
+  }
+
+  // Consumer only. Returns how many items are ready, refreshing our view of
+  // the write position if there seem to be fewer than needed.
+  size_t getReadyItems(size_t readPosition, size_t needed) {
+    auto readyItems = consumer.cachedWritePosition - readPosition;
+
+    if (readyItems < needed) {
+      consumer.cachedWritePosition = producer.writePosition.load(std::memory_order_acquire);
+      readyItems = consumer.cachedWritePosition - readPosition;
+    }
+
+    return readyItems;
+  }
+
+  template <typename U>
+  bool pushItem(U&& item) {
+    auto writePosition = producer.writePosition.load(std::memory_order_relaxed);
+
+    if (getFreeSlots(writePosition, 1) == 0) {
+      return false;
+    }
+
+    slots[writePosition & mask] = std::forward<U>(item);
+    producer.writePosition.store(writePosition + 1, std::memory_order_release);
+
+    return true;
+  }
+
+public:
+  // The capacity is rounded up to a power of two.
+  explicit SpscRingBuffer(size_t requestedCapacity)
+    : capacity(ringBufferCapacityFor(requestedCapacity)),
+      mask(capacity - 1),
+      slots(std::make_unique<T[]>(capacity)) {}
+
+  SpscRingBuffer(const SpscRingBuffer&) = delete;
+  SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+  size_t getCapacity() const {
+    return capacity;
+  }
+
+  // Producer only. Adds an item, or returns false if the buffer is full.
+  [[nodiscard]] bool tryPush(const T& item) {
+    return pushItem(item);
+  }
+
+  // Producer only. Adds an item, or returns false if the buffer is full. The
+  // item is only moved from if this succeeds.
+  [[nodiscard]] bool tryPush(T&& item) {
+    return pushItem(std::move(item));
+  }
+
+  // Producer only. Adds as many of the given items as will fit, in order, and
+  // returns how many were added. The consumer sees them all at once.
+  [[nodiscard]] size_t pushBulk(const T* items, size_t count) {
+    auto writePosition = producer.writePosition.load(std::memory_order_relaxed);
+    auto toPush = std::min(count, getFreeSlots(writePosition, count));
+
+    for (size_t i = 0; i < toPush; i++) {
+      slots[(writePosition + i) & mask] = items[i];
+    }
+
+    producer.writePosition.store(writePosition + toPush, std::memory_order_release);
+
+    return toPush;
+  }
+
+  // Producer only. The number of items that can be pushed right now. The
+  // consumer may free up more at any time, so this is a lower bound.
+  size_t getNumFreeSlots() {
+    auto writePosition = producer.writePosition.load(std::memory_order_relaxed);
+    return getFreeSlots(writePosition, capacity);
+  }
+
+  // Consumer only. Removes the next item, or returns nullopt if the buffer
+  // is empty.
+  std::optional<T> tryPop() {
+    auto readPosition = consumer.readPosition.load(std::memory_order_relaxed);
+
+    if (getReadyItems(readPosition, 1) == 0) {
+      return std::nullopt;
+    }
+
+    std::optional<T> item = std::move(slots[readPosition & mask]);
+    consumer.readPosition.store(readPosition + 1, std::memory_order_release);
+
+    return item;
+  }
+
+  // Consumer only. Removes up to maxCount items into the given array, and
+  // returns how many were removed.
+  size_t popBulk(T* items, size_t maxCount) {
+    auto readPosition = consumer.readPosition.load(std::memory_order_relaxed);
+    auto toPop = std::min(maxCount, getReadyItems(readPosition, maxCount));
+
+    for (size_t i = 0; i < toPop; i++) {
+      items[i] = std::move(slots[(readPosition + i) & mask]);
+    }
+
+    consumer.readPosition.store(readPosition + toPop, std::memory_order_release);
+
+    return toPop;
+  }
+
+  // Consumer only. Waits up to the given time for an item. This sleeps, so it
+  // must not be used on the audio thread.
+  std::optional<T> popWait(std::chrono::milliseconds timeout) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    RingBufferBackoff backoff;
+
+    while (true) {
+      auto item = tryPop();
+
+      if (item.has_value() || std::chrono::steady_clock::now() >= deadline) {
+        return item;
+      }
+
+      backoff.wait();
+    }
+  }
+
+  // Consumer only. Whether there is nothing to pop right now.
+  bool isEmpty() {
+    auto readPosition = consumer.readPosition.load(std::memory_order_relaxed);
+    return getReadyItems(readPosition, 1) == 0;
+  }
+};
+
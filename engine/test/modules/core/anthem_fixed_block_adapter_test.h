@@ -0,0 +1,159 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "modules/core/anthem_fixed_block_adapter.h"
+
+class AnthemFixedBlockAdapterTest : public juce::UnitTest {
+public:
+  AnthemFixedBlockAdapterTest() : juce::UnitTest("AnthemFixedBlockAdapterTest", "Anthem") {}
+
+  // Stands in for the graph. Each block continues a ramp, so the output should
+  // be 0, 1, 2, ... no matter how it's split up.
+  struct RampSource {
+    juce::AudioSampleBuffer buffer { 2, 512 };
+    int next = 0;
+    int calls = 0;
+    std::vector<int> blockSizes;
+
+    const juce::AudioSampleBuffer& process(int blockSize) {
+      calls++;
+      blockSizes.push_back(blockSize);
+
+      for (int sample = 0; sample < blockSize; sample++) {
+        buffer.setSample(0, sample, static_cast<float>(next));
+        buffer.setSample(1, sample, static_cast<float>(-next));
+        next++;
+      }
+
+      return buffer;
+    }
+  };
+
+  void runTest() override {
+    {
+      beginTest("Output is continuous across device blocks of varying size");
+
+      AnthemFixedBlockAdapter adapter(64, 2);
+      RampSource source;
+
+      std::vector<float> left(1000);
+      std::vector<float> right(1000);
+
+      int position = 0;
+
+      for (int deviceBlockSize : { 1, 63, 64, 65, 100, 7, 128, 200, 372 }) {
+        float* output[] = { left.data() + position, right.data() + position };
+
+        adapter.process(output, 2, deviceBlockSize, [&](int blockSize) -> const juce::AudioSampleBuffer& {
+          return source.process(blockSize);
+        });
+
+        position += deviceBlockSize;
+      }
+
+      expectEquals(position, 1000);
+
+      for (int i = 0; i < 1000; i++) {
+        if (left[i] != static_cast<float>(i) || right[i] != static_cast<float>(-i)) {
+          expect(false, "Sample " + juce::String(i) + " is out of order");
+          break;
+        }
+      }
+
+      for (auto blockSize : source.blockSizes) {
+        expectEquals(blockSize, 64);
+      }
+
+      // 1000 samples needs 16 quanta, and nothing should be rendered that
+      // wasn't needed yet.
+      expectEquals(source.calls, 16);
+      expectEquals(adapter.getSamplesProcessed(), static_cast<int64_t>(16 * 64));
+    }
+
+    {
+      beginTest("Device blocks that are a multiple of the block size need no buffering");
+
+      AnthemFixedBlockAdapter adapter(32, 2);
+      RampSource source;
+
+      std::vector<float> left(128);
+      std::vector<float> right(128);
+      float* output[] = { left.data(), right.data() };
+
+      adapter.process(output, 2, 128, [&](int blockSize) -> const juce::AudioSampleBuffer& {
+        return source.process(blockSize);
+      });
+
+      expectEquals(source.calls, 4);
+      expectEquals(left[127], 127.0f);
+    }
+
+    {
+      beginTest("Extra device channels are cleared and null channels are skipped");
+
+      AnthemFixedBlockAdapter adapter(16, 2);
+      RampSource source;
+
+      std::vector<float> left(10);
+      std::vector<float> extra(10, 5.0f);
+      float* output[] = { left.data(), nullptr, extra.data() };
+
+      adapter.process(output, 3, 10, [&](int blockSize) -> const juce::AudioSampleBuffer& {
+        return source.process(blockSize);
+      });
+
+      expectEquals(left[9], 9.0f);
+
+      for (auto sample : extra) {
+        expectEquals(sample, 0.0f);
+      }
+    }
+
+    {
+      beginTest("Reset drops buffered output");
+
+      AnthemFixedBlockAdapter adapter(64, 2);
+      RampSource source;
+
+      std::vector<float> left(10);
+      std::vector<float> right(10);
+      float* output[] = { left.data(), right.data() };
+
+      auto process = [&](int blockSize) -> const juce::AudioSampleBuffer& {
+        return source.process(blockSize);
+      };
+
+      adapter.process(output, 2, 10, process);
+      adapter.reset();
+      adapter.process(output, 2, 10, process);
+
+      // The 54 samples left over from the first quantum are dropped, so this
+      // starts from the second quantum.
+      expectEquals(left[0], 64.0f);
+      expectEquals(source.calls, 2);
+      expectEquals(adapter.getSamplesProcessed(), static_cast<int64_t>(64));
+    }
+  }
+};
+
+static AnthemFixedBlockAdapterTest anthemFixedBlockAdapterTest;
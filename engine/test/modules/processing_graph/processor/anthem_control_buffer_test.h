@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+#include "modules/processing_graph/processor/anthem_control_buffer.h"
+
+class AnthemControlBufferTest : public juce::UnitTest {
+public:
+  AnthemControlBufferTest() : juce::UnitTest("AnthemControlBufferTest", "Anthem") {}
+
+  void runTest() override {
+    {
+      beginTest("A constant value needs no samples");
+
+      AnthemControlBuffer buffer(64);
+      buffer.setValue(0.5f);
+
+      expect(buffer.isConstant());
+      expect(!buffer.isDense());
+      expectEquals(buffer.getNumBreakpoints(), 1);
+      expectEquals(buffer.getValue(63), 0.5f);
+
+      auto* samples = buffer.getReadPointer(64);
+
+      for (int i = 0; i < 64; i++) {
+        expectEquals(samples[i], 0.5f);
+      }
+    }
+
+    {
+      beginTest("Ramps and holds are filled in when samples are read");
+
+      AnthemControlBuffer buffer(16);
+
+      // Ramp up from 0 by 0.25 per sample, then hold at 1 from sample 4
+      buffer.setValue(0.0f, 0.25f);
+      buffer.addBreakpoint(4, 1.0f);
+
+      expect(!buffer.isConstant());
+      expectEquals(buffer.getValue(2), 0.5f);
+      expectEquals(buffer.getValue(10), 1.0f);
+
+      auto* samples = buffer.getReadPointer(8);
+      float expected[] = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+      for (int i = 0; i < 8; i++) {
+        expectEquals(samples[i], expected[i]);
+      }
+
+      // Writing new breakpoints invalidates the samples that were filled in
+      buffer.setValue(2.0f);
+      expectEquals(buffer.getReadPointer(8)[3], 2.0f);
+    }
+
+    {
+      beginTest("Copying breakpoints scales them without filling in samples");
+
+      AnthemControlBuffer source(16);
+      AnthemControlBuffer destination(16);
+
+      source.setValue(0.0f, 0.125f);
+      source.addBreakpoint(8, 1.0f);
+
+      destination.copyScaledFrom(source, 10.0f, 5.0f, 16);
+
+      expect(!destination.isDense());
+      expectEquals(destination.getNumBreakpoints(), 2);
+      expectEquals(destination.getBreakpoint(0).value, 5.0f);
+      expectEquals(destination.getBreakpoint(0).slope, 1.25f);
+      expectEquals(destination.getBreakpoint(1).sample, 8);
+      expectEquals(destination.getBreakpoint(1).value, 15.0f);
+      expectEquals(destination.getValue(4), 10.0f);
+    }
+
+    {
+      beginTest("Copying samples keeps the destination value where the source is NaN");
+
+      AnthemControlBuffer source(8);
+      AnthemControlBuffer destination(8);
+
+      auto* sourceSamples = source.getWritePointer();
+
+      for (int i = 0; i < 8; i++) {
+        sourceSamples[i] = i % 2 == 0 ? std::numeric_limits<float>::quiet_NaN() : 1.0f;
+      }
+
+      destination.setValue(3.0f);
+      destination.copyScaledFrom(source, 2.0f, 0.0f, 8);
+
+      expect(destination.isDense());
+
+      auto* samples = destination.getReadPointer(8);
+
+      for (int i = 0; i < 8; i++) {
+        expectEquals(samples[i], i % 2 == 0 ? 3.0f : 2.0f);
+      }
+    }
+
+    {
+      beginTest("Denormals are found in breakpoints and in samples");
+
+      AnthemControlBuffer buffer(8);
+      buffer.setValue(1.0f, std::numeric_limits<float>::denorm_min());
+      expect(buffer.containsDenormals(8));
+
+      buffer.setValue(1.0f);
+      expect(!buffer.containsDenormals(8));
+
+      auto* samples = buffer.getWritePointer();
+
+      for (int i = 0; i < 8; i++) {
+        samples[i] = 0.0f;
+      }
+
+      samples[7] = std::numeric_limits<float>::denorm_min();
+      expect(!buffer.containsDenormals(7));
+      expect(buffer.containsDenormals(8));
+    }
+  }
+};
+
+static AnthemControlBufferTest anthemControlBufferTest;
@@ -0,0 +1,153 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+#include "modules/processing_graph/processor/anthem_event_buffer.h"
+
+class AnthemEventBufferTest : public juce::UnitTest {
+public:
+  AnthemEventBufferTest() : juce::UnitTest("AnthemEventBufferTest", "Anthem") {}
+
+  // The ID tells us which source an event came from.
+  AnthemLiveEvent createEvent(int32_t offset, int32_t id) {
+    return AnthemLiveEvent::createNoteOn(offset, 0, 60, 1.0f, id);
+  }
+
+  void runTest() override {
+    ArenaBufferAllocator<AnthemLiveEvent> allocator(65536);
+
+    {
+      beginTest("Events added out of order are kept in time order");
+
+      AnthemEventBuffer buffer(&allocator, 4);
+
+      // This is more than the buffer size, so the buffer also has to grow.
+      int32_t offsets[] = { 10, 20, 5, 30, 0, 25, 25, 15 };
+
+      for (size_t i = 0; i < std::size(offsets); i++) {
+        buffer.addEvent(createEvent(offsets[i], static_cast<int32_t>(i)));
+      }
+
+      expectEquals(static_cast<int>(buffer.getNumEvents()), static_cast<int>(std::size(offsets)));
+
+      int32_t expectedOffsets[] = { 0, 5, 10, 15, 20, 25, 25, 30 };
+
+      for (size_t i = 0; i < std::size(expectedOffsets); i++) {
+        expectEquals(buffer.getEvent(i).time.offset, expectedOffsets[i]);
+      }
+
+      // The two events at 25 stay in the order they were added.
+      expectEquals(buffer.getEvent(5).noteOn.id, 5);
+      expectEquals(buffer.getEvent(6).noteOn.id, 6);
+
+      buffer.cleanup();
+    }
+
+    {
+      beginTest("Merging sources keeps events in time order");
+
+      AnthemEventBuffer a(&allocator, 16);
+      AnthemEventBuffer b(&allocator, 16);
+      AnthemEventBuffer c(&allocator, 16);
+      AnthemEventBuffer destination(&allocator, 4);
+
+      a.addEvent(createEvent(0, 0));
+      a.addEvent(createEvent(10, 0));
+      a.addEvent(createEvent(30, 0));
+
+      b.addEvent(createEvent(5, 1));
+      b.addEvent(createEvent(40, 1));
+
+      c.addEvent(createEvent(20, 2));
+
+      std::vector<const AnthemEventBuffer*> sources = { &a, &b, &c };
+      std::vector<size_t> cursors(sources.size());
+
+      destination.mergeFrom(sources, cursors);
+
+      expectEquals(static_cast<int>(destination.getNumEvents()), 6);
+
+      for (size_t i = 1; i < destination.getNumEvents(); i++) {
+        expect(
+          destination.getEvent(i - 1).time.offset <= destination.getEvent(i).time.offset,
+          "Events are in time order"
+        );
+      }
+
+      a.cleanup();
+      b.cleanup();
+      c.cleanup();
+      destination.cleanup();
+    }
+
+    {
+      beginTest("Events at the same time keep the order of their sources");
+
+      AnthemEventBuffer a(&allocator, 16);
+      AnthemEventBuffer b(&allocator, 16);
+      AnthemEventBuffer destination(&allocator, 16);
+
+      a.addEvent(createEvent(8, 0));
+      a.addEvent(createEvent(8, 0));
+      b.addEvent(createEvent(8, 1));
+      b.addEvent(createEvent(8, 1));
+
+      // Sources are listed with b first, so b's events should come first.
+      std::vector<const AnthemEventBuffer*> sources = { &b, &a };
+      std::vector<size_t> cursors(sources.size());
+
+      destination.mergeFrom(sources, cursors);
+
+      expectEquals(static_cast<int>(destination.getNumEvents()), 4);
+      expectEquals(destination.getEvent(0).noteOn.id, 1);
+      expectEquals(destination.getEvent(1).noteOn.id, 1);
+      expectEquals(destination.getEvent(2).noteOn.id, 0);
+      expectEquals(destination.getEvent(3).noteOn.id, 0);
+
+      a.cleanup();
+      b.cleanup();
+      destination.cleanup();
+    }
+
+    {
+      beginTest("Merging empty sources adds nothing");
+
+      AnthemEventBuffer a(&allocator, 16);
+      AnthemEventBuffer b(&allocator, 16);
+      AnthemEventBuffer destination(&allocator, 16);
+
+      std::vector<const AnthemEventBuffer*> sources = { &a, &b };
+      std::vector<size_t> cursors(sources.size());
+
+      destination.mergeFrom(sources, cursors);
+
+      expectEquals(static_cast<int>(destination.getNumEvents()), 0);
+
+      a.cleanup();
+      b.cleanup();
+      destination.cleanup();
+    }
+  }
+};
+
+static AnthemEventBufferTest anthemEventBufferTest;
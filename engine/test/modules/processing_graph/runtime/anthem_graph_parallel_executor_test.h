@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "modules/processing_graph/runtime/anthem_graph_parallel_executor.h"
+
+// Counts how many times it has been executed, and which threads it ran on.
+class CountingAction : public AnthemGraphCompilerAction {
+public:
+  std::atomic<int> executeCount = 0;
+  int lastNumSamples = 0;
+  juce::Thread::ThreadID threadId = nullptr;
+
+  void execute(int numSamples) override {
+    executeCount++;
+    lastNumSamples = numSamples;
+    threadId = juce::Thread::getCurrentThreadId();
+
+    // Gives the other threads a chance to pick up work.
+    juce::Thread::yield();
+  }
+
+  void debugPrint() override {}
+};
+
+class AnthemGraphParallelExecutorTest : public juce::UnitTest {
+public:
+  AnthemGraphParallelExecutorTest() : juce::UnitTest("AnthemGraphParallelExecutorTest", "Anthem") {}
+
+  std::vector<std::unique_ptr<AnthemGraphCompilerAction>> createActions(int count) {
+    std::vector<std::unique_ptr<AnthemGraphCompilerAction>> actions;
+
+    for (int i = 0; i < count; i++) {
+      actions.push_back(std::make_unique<CountingAction>());
+    }
+
+    return actions;
+  }
+
+  int getExecuteCount(std::unique_ptr<AnthemGraphCompilerAction>& action) {
+    return static_cast<CountingAction*>(action.get())->executeCount;
+  }
+
+  void runTest() override {
+    {
+      beginTest("Executor with no workers runs everything on the calling thread");
+
+      AnthemGraphParallelExecutor executor(0);
+      auto actions = createActions(10);
+
+      executor.execute(actions, 64);
+
+      for (auto& action : actions) {
+        auto* countingAction = static_cast<CountingAction*>(action.get());
+
+        expectEquals(countingAction->executeCount.load(), 1);
+        expectEquals(countingAction->lastNumSamples, 64);
+        expect(countingAction->threadId == juce::Thread::getCurrentThreadId(), "Action ran on the calling thread");
+      }
+    }
+
+    {
+      beginTest("Every action runs exactly once per group");
+
+      AnthemGraphParallelExecutor executor(3);
+      expectEquals(executor.getNumWorkers(), 3);
+
+      auto actions = createActions(100);
+
+      for (int i = 0; i < 50; i++) {
+        executor.execute(actions, 128);
+      }
+
+      for (auto& action : actions) {
+        expectEquals(getExecuteCount(action), 50);
+      }
+    }
+
+    {
+      beginTest("Groups of different sizes can run back to back");
+
+      AnthemGraphParallelExecutor executor(4);
+
+      auto small = createActions(1);
+      auto medium = createActions(3);
+      auto large = createActions(64);
+      auto empty = createActions(0);
+
+      for (int i = 0; i < 100; i++) {
+        executor.execute(small, 32);
+        executor.execute(large, 32);
+        executor.execute(empty, 32);
+        executor.execute(medium, 32);
+      }
+
+      for (auto* group : { &small, &medium, &large }) {
+        for (auto& action : *group) {
+          expectEquals(getExecuteCount(action), 100);
+        }
+      }
+    }
+  }
+};
+
+static AnthemGraphParallelExecutorTest anthemGraphParallelExecutorTest;
@@ -0,0 +1,207 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <vector>
+
+#include "modules/processors/oscillator.h"
+
+class AnthemOscillatorTest : public juce::UnitTest {
+public:
+  AnthemOscillatorTest() : juce::UnitTest("AnthemOscillatorTest", "Anthem") {}
+
+  // The magnitude of each bin in a DFT of the samples, up to Nyquist.
+  std::vector<double> getSpectrum(const std::vector<float>& samples) {
+    auto size = samples.size();
+    std::vector<double> magnitudes(size / 2 + 1);
+
+    for (size_t bin = 0; bin < magnitudes.size(); bin++) {
+      double real = 0.0;
+      double imaginary = 0.0;
+
+      for (size_t i = 0; i < size; i++) {
+        auto angle = 2.0 * juce::MathConstants<double>::pi * static_cast<double>(bin * i % size) / static_cast<double>(size);
+        real += samples[i] * std::cos(angle);
+        imaginary -= samples[i] * std::sin(angle);
+      }
+
+      magnitudes[bin] = std::sqrt(real * real + imaginary * imaginary);
+    }
+
+    return magnitudes;
+  }
+
+  // Renders one period of a waveform that plays 7 cycles every 64 samples,
+  // which is about 5.3 kHz at 48 kHz. The first 4 harmonics are below
+  // Nyquist, and the rest would alias. The period is a whole number of
+  // samples, so a DFT of it has no leakage.
+  std::vector<float> renderSevenCycles(const float* level) {
+    uint32_t increment = 7u << 26;
+    std::vector<float> samples(64);
+
+    for (uint32_t i = 0; i < samples.size(); i++) {
+      samples[i] = AnthemWavetable::lookup(level, i * increment);
+    }
+
+    return samples;
+  }
+
+  // The loudest bin that isn't one of the harmonics at bins 7, 14, 21 and
+  // 28, relative to the fundamental, in dB.
+  double getWorstAliasDecibels(const std::vector<float>& samples) {
+    auto spectrum = getSpectrum(samples);
+    double worst = 0.0;
+
+    for (size_t bin = 0; bin < spectrum.size(); bin++) {
+      if (bin % 7 != 0 || bin > 28) {
+        worst = std::max(worst, spectrum[bin]);
+      }
+    }
+
+    return 20.0 * std::log10(worst / spectrum[7] + 1e-20);
+  }
+
+  void runTest() override {
+    {
+      beginTest("Pitches are converted to frequencies");
+
+      expectWithinAbsoluteError(AnthemOscillator::getFrequencyForPitch(69.0), 440.0, 1e-9);
+      expectWithinAbsoluteError(AnthemOscillator::getFrequencyForPitch(81.0), 880.0, 1e-9);
+      expectWithinAbsoluteError(AnthemOscillator::getFrequencyForPitch(60.0), 261.6255653, 1e-6);
+    }
+
+    {
+      beginTest("Frequencies are converted to fixed-point phase increments");
+
+      expect(AnthemOscillator::getPhaseIncrement(12000.0, 48000.0) == 1u << 30, "A quarter of the sample rate is a quarter cycle");
+      expect(AnthemOscillator::getPhaseIncrement(-12000.0, 48000.0) == 3u << 30, "Negative frequencies play backwards");
+      expect(AnthemOscillator::getPhaseIncrement(60000.0, 48000.0) == 1u << 30, "Frequencies above the sample rate wrap");
+
+      float frequencies[] = { 12000.0f, -12000.0f, 0.0f };
+      uint32_t increments[3];
+      AnthemOscillator::getPhaseIncrements(frequencies, 48000.0, increments, 3);
+
+      expect(increments[0] == 1u << 30, "The per-sample conversion matches");
+      expect(increments[1] == 3u << 30, "The per-sample conversion handles negative frequencies");
+      expect(increments[2] == 0u, "A frequency of 0 doesn't move the phase");
+    }
+
+    {
+      beginTest("The level for each pitch has as many harmonics as possible without aliasing");
+
+      bool allBelowNyquist = true;
+      bool noneWasted = true;
+
+      for (uint64_t increment = 1; increment < 0x80000000u; increment = increment * 17 / 16 + 1) {
+        auto level = AnthemWavetable::getLevelForPhaseIncrement(static_cast<uint32_t>(increment));
+        auto harmonics = static_cast<uint64_t>(AnthemWavetable::maxHarmonics >> level);
+
+        allBelowNyquist = allBelowNyquist && harmonics * increment < 0x80000000u;
+        noneWasted = noneWasted && (level == 0 || harmonics * 2 * increment >= 0x80000000u);
+
+        // Negative increments get the same level.
+        auto negativeLevel = AnthemWavetable::getLevelForPhaseIncrement(0u - static_cast<uint32_t>(increment));
+        expectEquals(negativeLevel, level);
+      }
+
+      expect(allBelowNyquist, "Every harmonic is below Nyquist");
+      expect(noneWasted, "The level before would alias");
+    }
+
+    {
+      beginTest("A sine has very little noise or distortion");
+
+      auto sine = AnthemWavetable::createSine();
+
+      // This doesn't divide the sample rate evenly, so the samples land all
+      // over the table and interpolation is tested everywhere.
+      auto increment = AnthemOscillator::getPhaseIncrement(1000.5, 48000.0);
+      std::vector<float> samples(48000);
+
+      uint32_t phase = 0;
+      sine.render(phase, increment, samples.data(), static_cast<int>(samples.size()));
+
+      expect(phase == static_cast<uint32_t>(samples.size()) * increment, "The phase is advanced");
+
+      double signalPower = 0.0;
+      double errorPower = 0.0;
+
+      for (uint32_t i = 0; i < samples.size(); i++) {
+        auto expected = std::sin(2.0 * juce::MathConstants<double>::pi * static_cast<double>(i * increment) / 4294967296.0);
+        auto error = samples[i] - expected;
+
+        signalPower += expected * expected;
+        errorPower += error * error;
+      }
+
+      auto noiseAndDistortion = 10.0 * std::log10(errorPower / signalPower);
+      logMessage("THD+N: " + juce::String(noiseAndDistortion, 1) + " dB");
+
+      expect(noiseAndDistortion < -110.0, "THD+N is below -110 dB");
+    }
+
+    {
+      beginTest("A band-limited saw doesn't alias");
+
+      auto saw = AnthemWavetable::createSaw();
+      auto level = AnthemWavetable::getLevelForPhaseIncrement(7u << 26);
+
+      auto bandLimited = getWorstAliasDecibels(renderSevenCycles(saw.getLevel(level)));
+      auto naive = getWorstAliasDecibels(renderSevenCycles(saw.getLevel(0)));
+
+      logMessage(
+        "Worst alias: " + juce::String(bandLimited, 1) + " dB band-limited, " +
+        juce::String(naive, 1) + " dB with every harmonic"
+      );
+
+      expect(bandLimited < -100.0, "Aliases are below -100 dB");
+      expect(naive > -40.0, "Without band-limiting, the same test finds aliasing");
+
+      // The harmonics that are kept fall off as 1 / n.
+      auto spectrum = getSpectrum(renderSevenCycles(saw.getLevel(level)));
+      expectWithinAbsoluteError(spectrum[14] / spectrum[7], 0.5, 1e-4);
+      expectWithinAbsoluteError(spectrum[28] / spectrum[7], 0.25, 1e-4);
+    }
+
+    {
+      beginTest("Rendering with an increment for each sample matches a fixed increment");
+
+      auto saw = AnthemWavetable::createSaw();
+      auto increment = AnthemOscillator::getPhaseIncrement(440.0, 48000.0);
+
+      std::vector<uint32_t> increments(256, increment);
+      std::vector<float> fixed(256);
+      std::vector<float> perSample(256);
+
+      // Start near the end of the cycle, so the phase wraps straight away.
+      uint32_t fixedPhase = 0xfff00000u;
+      uint32_t perSamplePhase = 0xfff00000u;
+
+      saw.render(fixedPhase, increment, fixed.data(), 256);
+      saw.render(perSamplePhase, increments.data(), perSample.data(), 256);
+
+      expect(fixed == perSample, "The samples are the same");
+      expect(fixedPhase == perSamplePhase, "The phase is advanced the same");
+    }
+  }
+};
+
+static AnthemOscillatorTest oscillatorTest;
@@ -0,0 +1,154 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include "modules/processors/voice_allocator.h"
+
+class AnthemVoiceAllocatorTest : public juce::UnitTest {
+public:
+  AnthemVoiceAllocatorTest() : juce::UnitTest("AnthemVoiceAllocatorTest", "Anthem") {}
+
+  AnthemLiveEvent noteOn(int16_t pitch, int32_t id, uint8_t channel = 0) {
+    return AnthemLiveEvent::createNoteOn(0, channel, pitch, 1.0f, id);
+  }
+
+  AnthemLiveEvent noteOff(int16_t pitch, int32_t id, uint8_t channel = 0) {
+    return AnthemLiveEvent::createNoteOff(0, channel, pitch, 0.0f, id);
+  }
+
+  void runTest() override {
+    int released[4];
+
+    {
+      beginTest("Free voices are handed out lowest index first");
+
+      AnthemVoiceAllocator allocator(4);
+
+      expectEquals(allocator.startVoice(noteOn(60, 1)).voiceIndex, 0);
+      expectEquals(allocator.startVoice(noteOn(62, 2)).voiceIndex, 1);
+      expectEquals(allocator.startVoice(noteOn(64, 3)).voiceIndex, 2);
+      expectEquals(allocator.getNumActiveVoices(), 3);
+
+      allocator.freeVoice(0);
+      expectEquals(allocator.getNumActiveVoices(), 2);
+
+      auto allocation = allocator.startVoice(noteOn(65, 4));
+      expectEquals(allocation.voiceIndex, 0);
+      expect(!allocation.isStolen, "A free voice was used");
+      expectEquals(static_cast<int>(allocator.getVoice(0).pitch), 65);
+    }
+
+    {
+      beginTest("Note offs match by ID");
+
+      AnthemVoiceAllocator allocator(4);
+      allocator.startVoice(noteOn(60, 1));
+      allocator.startVoice(noteOn(60, 2));
+
+      expectEquals(allocator.releaseVoices(noteOff(60, 2), released), 1);
+      expectEquals(released[0], 1);
+      expect(!allocator.getVoice(0).isReleased, "The other note with the same pitch keeps playing");
+      expect(allocator.getVoice(1).isReleased, "The matching note is released");
+      expect(allocator.getVoice(1).isActive, "Released voices stay active until they're freed");
+
+      expectEquals(allocator.releaseVoices(noteOff(60, 2), released), 0);
+      expectEquals(allocator.releaseVoices(noteOff(60, 3), released), 0);
+    }
+
+    {
+      beginTest("Note offs with an ID of -1 match by pitch and channel");
+
+      AnthemVoiceAllocator allocator(4);
+      allocator.startVoice(noteOn(60, 1));
+      allocator.startVoice(noteOn(60, 2));
+      allocator.startVoice(noteOn(60, 3, 1));
+      allocator.startVoice(noteOn(62, 4));
+
+      expectEquals(allocator.releaseVoices(noteOff(60, -1), released), 2);
+      expectEquals(released[0], 0);
+      expectEquals(released[1], 1);
+      expect(!allocator.getVoice(2).isReleased, "Notes on other channels keep playing");
+      expect(!allocator.getVoice(3).isReleased, "Notes with other pitches keep playing");
+    }
+
+    {
+      beginTest("Stealing takes the oldest released voice, then the oldest voice");
+
+      AnthemVoiceAllocator allocator(3);
+      allocator.startVoice(noteOn(60, 1));
+      allocator.startVoice(noteOn(62, 2));
+      allocator.startVoice(noteOn(64, 3));
+
+      allocator.releaseVoices(noteOff(64, 3), released);
+      allocator.releaseVoices(noteOff(62, 2), released);
+
+      auto allocation = allocator.startVoice(noteOn(65, 4));
+      expect(allocation.isStolen, "A voice was stolen");
+      expectEquals(allocation.voiceIndex, 1);
+      expectEquals(allocator.getNumActiveVoices(), 3);
+
+      allocation = allocator.startVoice(noteOn(67, 5));
+      expectEquals(allocation.voiceIndex, 2);
+
+      // Nothing is released now, so the oldest note goes.
+      allocation = allocator.startVoice(noteOn(69, 6));
+      expectEquals(allocation.voiceIndex, 0);
+      expectEquals(allocator.getVoice(0).noteId, 6);
+    }
+
+    {
+      beginTest("Blocks are split at event times");
+
+      ArenaBufferAllocator<AnthemLiveEvent> arena(65536);
+      AnthemEventBuffer events(&arena, 8);
+
+      events.addEvent(AnthemLiveEvent::createNoteOn(-5, 0, 60, 1.0f, 1));
+      events.addEvent(AnthemLiveEvent::createNoteOn(10, 0, 62, 1.0f, 2));
+      events.addEvent(AnthemLiveEvent::createNoteOff(10, 0, 60, 0.0f, 1));
+      events.addEvent(AnthemLiveEvent::createNoteOff(100, 0, 62, 0.0f, 2));
+
+      std::string log;
+
+      AnthemVoiceAllocator::splitBlockAtEvents(
+        &events,
+        64,
+        [&](const AnthemLiveEvent& event) {
+          log += (event.type == AnthemEventType::NoteOn ? "on" : "off") + std::to_string(event.pitch) + " ";
+        },
+        [&](int start, int end) {
+          log += "[" + std::to_string(start) + "," + std::to_string(end) + ") ";
+        }
+      );
+
+      // Events before the block are handled at the start, and events after it
+      // are handled before its last sample.
+      expectEquals(
+        juce::String(log),
+        juce::String("on60 [0,10) on62 off60 [10,63) off62 [63,64) ")
+      );
+
+      events.cleanup();
+    }
+  }
+};
+
+static AnthemVoiceAllocatorTest voiceAllocatorTest;
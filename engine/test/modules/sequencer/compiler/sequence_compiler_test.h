@@ -56,6 +56,8 @@ public:
     testClampTimeToRangeFractional();
     testClampStartAndEndToRange();
     testPatternNoteCompiler();
+    testCompilePatternsFromJson();
+    testCompileAutomationFromJson();
   }
 
   void testEventSorting() {
@@ -406,6 +408,125 @@ public:
 
     expect(events.size() == 0, "Case 5: No events");
   }
+
+  void testCompilePatternsFromJson() {
+    beginTest("Test compiling pattern notes directly from project JSON");
+
+    auto projectJson = R"(
+{
+  "sequence": {
+    "ticksPerQuarter": 96,
+    "patterns": {
+      "patternId1": {
+        "id": "patternId1",
+        "notes": {
+          "channelId1": [
+            { "id": "noteId2", "key": 64, "velocity": 0.25, "length": 5, "offset": 20, "pan": 0.0 },
+            { "id": "noteId1", "key": 60, "velocity": 0.5, "length": 10, "offset": 10, "pan": 0.0 }
+          ],
+          "channelId2": []
+        },
+        "automationLanes": {}
+      },
+      "patternId2": {
+        "id": "patternId2",
+        "notes": {},
+        "automationLanes": {}
+      }
+    }
+  },
+  "processingGraph": {}
+}
+)";
+
+    auto result = AnthemSequenceCompiler::compilePatternsFromJson(projectJson);
+
+    expect(result.size() == 2, "There are two compiled patterns");
+    expect(result.at("patternId2").channels->size() == 0, "The empty pattern has no channels");
+
+    auto& channels = *result.at("patternId1").channels;
+    expect(channels.size() == 1, "Channels without notes are skipped");
+
+    auto& events = *channels.at("channelId1").events;
+    expect(events.size() == 4, "There are four events");
+
+    expect(events.at(0).time.ticks == 10, "Events are sorted");
+    expect(events.at(0).event.type == AnthemEventType::NoteOn, "First event is a note on");
+    expect(events.at(0).event.noteOn.pitch == 60, "First event has the right key");
+    expect(fabs(events.at(0).event.noteOn.velocity - 0.5) < 0.001, "First event has the right velocity");
+
+    expect(events.at(1).time.ticks == 20, "Second event time");
+    expect(events.at(2).time.ticks == 20, "Third event time");
+    expect(events.at(3).time.ticks == 25, "Fourth event time");
+    expect(events.at(3).event.type == AnthemEventType::NoteOff, "Last event is a note off");
+    expect(events.at(3).event.noteOff.pitch == 64, "Last event has the right key");
+
+    for (auto& [_, collection] : result) {
+      SequenceEventListCollection::cleanUpInstance(collection);
+    }
+  }
+
+  void testCompileAutomationFromJson() {
+    beginTest("Test compiling automation lanes directly from project JSON");
+
+    auto projectJson = R"(
+{
+  "sequence": {
+    "ticksPerQuarter": 96,
+    "patterns": {
+      "patternId1": {
+        "id": "patternId1",
+        "notes": {},
+        "automationLanes": {
+          "automationChannel": {
+            "points": [
+              { "id": "pointId1", "offset": 0, "value": 0.0, "tension": 0.0, "curve": "smooth" },
+              { "id": "pointId3", "offset": 96, "value": 0.5, "tension": 0.5, "curve": "stairs" },
+              { "id": "pointId2", "offset": 48, "value": 1.0, "tension": 0.0, "curve": "smooth" }
+            ]
+          },
+          "emptyChannel": {
+            "points": []
+          }
+        }
+      }
+    }
+  },
+  "processingGraph": {}
+}
+)";
+
+    auto result = AnthemSequenceCompiler::compilePatternsFromJson(projectJson);
+
+    auto& channels = *result.at("patternId1").channels;
+    expect(channels.size() == 1, "Empty automation lanes are skipped");
+
+    auto& channel = channels.at("automationChannel");
+    expect(channel.events->empty(), "Automation channels have no events");
+
+    auto& segments = *channel.automationSegments;
+
+    // A hold before the first point, one segment between each pair of points,
+    // and a hold after the last point
+    expect(segments.size() == 4, "There are four segments");
+
+    expect(std::isinf(segments.at(0).start) && segments.at(0).start < 0, "The first segment starts at negative infinity");
+    expect(segments.at(0).kernel == AnthemAutomationKernel::Constant, "The value holds before the first point");
+
+    expect(segments.at(1).start == 0.0 && segments.at(1).end == 48.0, "Points are sorted by offset");
+    expect(segments.at(1).kernel == AnthemAutomationKernel::Linear, "Smooth curves with no tension are straight lines");
+    expect(fabs(segments.at(1).getValue(24.0) - 0.5) < 0.001, "Straight lines are evaluated correctly");
+
+    expect(segments.at(2).kernel == AnthemAutomationKernel::Stairs, "Each point's curve is used for the segment that ends at it");
+    expect(fabs(segments.at(2).getValue(96.0) - 0.5) < 0.001, "Stairs end at the next point's value");
+
+    expect(std::isinf(segments.at(3).end), "The last segment doesn't end");
+    expect(fabs(segments.at(3).getValue(1000.0) - 0.5) < 0.001, "The value holds after the last point");
+
+    for (auto& [_, collection] : result) {
+      SequenceEventListCollection::cleanUpInstance(collection);
+    }
+  }
 };
 
 static SequenceCompilerTest sequenceCompilerTest;
@@ -29,6 +29,7 @@ public:
   void runTest() override {
     testAnthemSequenceTimeOperators();
     testAnthemSequenceEventOperators();
+    testAnthemLiveEvent();
   }
 
 private:
@@ -130,6 +131,47 @@ private:
     expect (!(event1 >= event5), "operator>= event: !(event1 >= event5) - equal ticks, smaller fraction");
     expect (event2 >= event2, "operator>= event: event2 >= event2 - self");
   }
+
+  void testAnthemLiveEvent() {
+    beginTest ("AnthemLiveEvent");
+
+    expectEquals ((int) sizeof (AnthemLiveEvent), 16, "Live events are 16 bytes");
+
+    auto noteOn = AnthemLiveEvent::createNoteOn (12, 3, 60, 0.75f, 7);
+    expect (noteOn.type == AnthemEventType::NoteOn, "Note on: type");
+    expectEquals (noteOn.time.offset, 12, "Note on: offset");
+    expectEquals ((int) noteOn.channel, 3, "Note on: channel");
+    expectEquals ((int) noteOn.pitch, 60, "Note on: pitch");
+    expectEquals (noteOn.noteOn.id, 7, "Note on: id");
+    expectEquals (noteOn.noteOn.velocity, 0.75f, "Note on: velocity");
+
+    auto noteOff = AnthemLiveEvent::createNoteOff (-4, 0, 61, 0.25f, 8);
+    expect (noteOff.type == AnthemEventType::NoteOff, "Note off: type");
+    expectEquals (noteOff.time.offset, -4, "Note off: negative offset");
+    expectEquals ((int) noteOff.pitch, 61, "Note off: pitch");
+    expectEquals (noteOff.noteOff.id, 8, "Note off: id");
+    expectEquals (noteOff.noteOff.velocity, 0.25f, "Note off: velocity");
+
+    auto expression = AnthemLiveEvent::createNoteExpression (5, 1, AnthemNoteExpressionType::Tuning, 7, -0.5f);
+    expect (expression.type == AnthemEventType::NoteExpression, "Expression: type");
+    expect (expression.expression == AnthemNoteExpressionType::Tuning, "Expression: kind");
+    expectEquals (expression.noteExpression.id, 7, "Expression: id");
+    expectEquals (expression.noteExpression.value, -0.5f, "Expression: value");
+
+    auto controlChange = AnthemLiveEvent::createControlChange (6, 2, 74, 0.5f);
+    expect (controlChange.type == AnthemEventType::ControlChange, "Control change: type");
+    expectEquals ((int) controlChange.controller, 74, "Control change: controller");
+    expectEquals (controlChange.controlChange.value, 0.5f, "Control change: value");
+
+    auto pitchBend = AnthemLiveEvent::createPitchBend (7, 0, 2.0f);
+    expect (pitchBend.type == AnthemEventType::PitchBend, "Pitch bend: type");
+    expectEquals (pitchBend.pitchBend.value, 2.0f, "Pitch bend: value");
+
+    auto parameterChange = AnthemLiveEvent::createParameterChange (8, 42, 440.0f);
+    expect (parameterChange.type == AnthemEventType::ParameterChange, "Parameter change: type");
+    expectEquals (parameterChange.parameterChange.portId, 42, "Parameter change: port ID");
+    expectEquals (parameterChange.parameterChange.value, 440.0f, "Parameter change: value");
+  }
 };
 
 static EventTest eventTest;
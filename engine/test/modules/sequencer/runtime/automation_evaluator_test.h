@@ -0,0 +1,141 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+#include "modules/sequencer/runtime/automation_evaluator.h"
+
+class AutomationEvaluatorTest : public juce::UnitTest {
+  // A lane with two points, and holds before and after them, like the
+  // sequence compiler makes.
+  AnthemAutomationSegmentList createLane(float tension, AnthemAutomationCurve curve) {
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+    return {
+      AnthemAutomationSegment::createConstant(-infinity, 0.0, 0.0f),
+      AnthemAutomationSegment::create(0.0, 100.0, 0.0f, 1.0f, tension, curve),
+      AnthemAutomationSegment::createConstant(100.0, infinity, 1.0f),
+    };
+  }
+
+  bool isClose(float a, float b) {
+    return std::abs(a - b) < 0.0001f;
+  }
+
+public:
+  AutomationEvaluatorTest() : juce::UnitTest("AutomationEvaluatorTest", "Anthem") {}
+
+  void runTest() override {
+    {
+      beginTest("Segments are found by time");
+
+      auto lane = createLane(0.0f, AnthemAutomationCurve::Smooth);
+
+      expectEquals(static_cast<int>(AnthemAutomationEvaluator::findSegment(lane, -10.0)), 0);
+      expectEquals(static_cast<int>(AnthemAutomationEvaluator::findSegment(lane, 0.0)), 1);
+      expectEquals(static_cast<int>(AnthemAutomationEvaluator::findSegment(lane, 99.9)), 1);
+      expectEquals(static_cast<int>(AnthemAutomationEvaluator::findSegment(lane, 100.0)), 2);
+    }
+
+    {
+      beginTest("Straight lines are written as breakpoints");
+
+      auto lane = createLane(0.0f, AnthemAutomationCurve::Smooth);
+      AnthemControlBuffer buffer(64);
+
+      // Samples are 2 ticks apart, so the ramp ends at sample 50
+      AnthemAutomationEvaluator::evaluate(lane, 0.0, 2.0, 64, buffer);
+
+      expect(!buffer.isDense());
+      expectEquals(buffer.getNumBreakpoints(), 2);
+      expect(isClose(buffer.getValue(25), 0.5f));
+      expectEquals(buffer.getValue(50), 1.0f);
+      expectEquals(buffer.getValue(63), 1.0f);
+
+      // Before the lane starts, the first value holds
+      AnthemAutomationEvaluator::evaluate(lane, -1000.0, 2.0, 64, buffer);
+      expect(buffer.isConstant());
+      expectEquals(buffer.getValue(0), 0.0f);
+    }
+
+    {
+      beginTest("Curves are rendered as samples that match the segment");
+
+      AnthemAutomationCurve curves[] = {
+        AnthemAutomationCurve::Smooth,
+        AnthemAutomationCurve::Stairs,
+        AnthemAutomationCurve::Wave,
+      };
+
+      for (auto curve : curves) {
+        for (float tension : { -0.7f, 0.3f }) {
+          auto lane = createLane(tension, curve);
+          AnthemControlBuffer buffer(128);
+
+          AnthemAutomationEvaluator::evaluate(lane, -10.0, 1.0, 128, buffer);
+          expect(buffer.isDense());
+
+          auto* samples = buffer.getReadPointer(128);
+          bool matches = true;
+
+          for (int i = 0; i < 128; i++) {
+            auto time = -10.0 + i;
+            auto& segment = lane[AnthemAutomationEvaluator::findSegment(lane, time)];
+            matches = matches && isClose(samples[i], segment.getValue(time));
+          }
+
+          expect(matches, "Samples match the segment values");
+          expect(isClose(samples[10], 0.0f), "Curve starts at the first point");
+          expect(isClose(lane[1].getValue(100.0), 1.0f), "Curve ends at the second point");
+        }
+      }
+    }
+
+    {
+      beginTest("Smooth curves bend the way the automation editor draws them");
+
+      auto straight = AnthemAutomationSegment::create(0.0, 100.0, 0.0f, 1.0f, 0.0f, AnthemAutomationCurve::Smooth);
+      auto positive = AnthemAutomationSegment::create(0.0, 100.0, 0.0f, 1.0f, 0.5f, AnthemAutomationCurve::Smooth);
+      auto negative = AnthemAutomationSegment::create(0.0, 100.0, 0.0f, 1.0f, -0.5f, AnthemAutomationCurve::Smooth);
+
+      expect(straight.kernel == AnthemAutomationKernel::Linear);
+      expect(isClose(straight.getValue(50.0), 0.5f));
+      expect(positive.getValue(50.0) < 0.5f, "Positive tension starts slow");
+      expect(negative.getValue(50.0) > 0.5f, "Negative tension starts fast");
+      expect(isClose(positive.getValue(50.0), 1.0f - negative.getValue(50.0)), "Opposite tensions are symmetrical");
+    }
+
+    {
+      beginTest("Stairs and holds");
+
+      auto stairs = AnthemAutomationSegment::create(0.0, 100.0, 0.0f, 1.0f, 0.0f, AnthemAutomationCurve::Stairs);
+      expect(isClose(stairs.getValue(49.0), 0.0f), "Two steps: the first half is the first value");
+      expect(isClose(stairs.getValue(51.0), 1.0f), "Two steps: the second half is the second value");
+
+      auto hold = AnthemAutomationSegment::create(0.0, 100.0, 0.25f, 1.0f, 0.5f, AnthemAutomationCurve::Hold);
+      expect(hold.kernel == AnthemAutomationKernel::Constant);
+      expectEquals(hold.getValue(99.0), 0.25f);
+    }
+  }
+};
+
+static AutomationEvaluatorTest automationEvaluatorTest;
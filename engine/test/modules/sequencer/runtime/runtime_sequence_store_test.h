@@ -92,12 +92,12 @@ public:
       // relationship between the test and the store to manually check that the
       // old event list was sent back by the rt_getEventLists call.
 
-      auto pointerToCleanUp = store->mapDeletionQueue.read();
+      auto pointerToCleanUp = store->mapDeletionQueue.tryPop();
       expect(pointerToCleanUp.has_value(), "The audio thread has released the old event list");
       expect(pointerToCleanUp.value() != store->eventLists, "This is the old event list and not the new one");
       delete pointerToCleanUp.value();
 
-      expect(store->mapDeletionQueue.read().has_value() == false, "There is only one item in the deletion queue");
+      expect(store->mapDeletionQueue.tryPop().has_value() == false, "There is only one item in the deletion queue");
     }
 
     {
@@ -114,19 +114,19 @@ public:
       expect(eventLists.size() == 3, "There are three sequences");
 
       // Check that the audio thread sent back the old event list maps
-      auto pointerToCleanUp = store->mapDeletionQueue.read();
+      auto pointerToCleanUp = store->mapDeletionQueue.tryPop();
       expect(pointerToCleanUp.has_value(), "The audio thread has released the old event list (1)");
       delete pointerToCleanUp.value();
 
-      pointerToCleanUp = store->mapDeletionQueue.read();
+      pointerToCleanUp = store->mapDeletionQueue.tryPop();
       expect(pointerToCleanUp.has_value(), "The audio thread has released the old event list (2)");
       delete pointerToCleanUp.value();
 
-      pointerToCleanUp = store->mapDeletionQueue.read();
+      pointerToCleanUp = store->mapDeletionQueue.tryPop();
       expect(pointerToCleanUp.has_value(), "The audio thread has released the old event list (3)");
       delete pointerToCleanUp.value();
 
-      expect(store->mapDeletionQueue.read().has_value() == false, "There are only three items in the deletion queue");
+      expect(store->mapDeletionQueue.tryPop().has_value() == false, "There are only three items in the deletion queue");
 
       // Since we didn't replace anything, there is no data to delete
       expect(store->pendingSequenceDeletions.size() == 0, "There are no pending sequence deletions");
@@ -19,6 +19,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include "modules/util/arena_allocator.h"
 
 struct TestStruct {
@@ -130,12 +134,22 @@ public:
     {
       beginTest("Test allocations of multiple sizes, and test coalescing");
 
-      auto arena = new ArenaBufferAllocator<int>(1024);
+      // This arena only has room for one allocation of wholeArena items, so
+      // that allocation only succeeds if every freed block has been merged
+      // back together. The arena is bigger than the minimum arena size, and
+      // a power of two is a size class boundary, so the search for a free
+      // block never rounds it up past the only one there is.
+      constexpr size_t wholeArena = 256;
 
-      auto result = arena->allocate(3);
-      auto result2 = arena->allocate(5);
-      arena->deallocate(result.deallocatePtr);
-      auto result3 = arena->allocate(1);
+      ArenaBufferAllocator<int> arena(
+        ArenaBufferAllocator<int>::arenaOverhead + ArenaBufferAllocator<int>::getFootprint(wholeArena),
+        false
+      );
+
+      auto result = arena.allocate(3);
+      auto result2 = arena.allocate(5);
+      arena.deallocate(result.deallocatePtr);
+      auto result3 = arena.allocate(1);
 
       expect(result.success, "Allocation 1 succeeded");
       expect(result2.success, "Allocation 2 succeeded");
@@ -144,22 +158,180 @@ public:
       expect(result.memoryStart != result2.memoryStart, "Memory is in different locations");
       expect(result.memoryStart == result3.memoryStart, "Memory is in the same location");
 
-      arena->deallocate(result2.deallocatePtr);
-      arena->deallocate(result3.deallocatePtr);
+      arena.deallocate(result2.deallocatePtr);
+      arena.deallocate(result3.deallocatePtr);
 
-      arena->coalesce();
+      auto result4 = arena.allocate(wholeArena);
+      expect(result4.success, "Once everything is freed, the whole arena can be allocated again");
+      expect(result.memoryStart == result4.memoryStart, "After everything is freed, new items are allocated at the start");
+      expect(!arena.allocate(1).success, "The arena is full");
 
-      auto result5 = arena->allocate(15);
-      expect(result5.success, "Allocation 5 succeeded");
-      expect(result.memoryStart == result5.memoryStart, "After coalescing an empty buffer, new items are allocated at the start");
+      arena.deallocate(result4.deallocatePtr);
 
-      arena->coalesce();
+      // Freeing the middle block last means it has to merge with free blocks
+      // on both sides.
+      auto left = arena.allocate(4);
+      auto middle = arena.allocate(4);
+      auto right = arena.allocate(4);
 
-      auto result6 = arena->allocate(15);
-      expect(result6.success, "Allocation 6 succeeded");
-      expect(result5.memoryStart != result6.memoryStart, "After coalescing a non-empty buffer, existing data is not mangled");
+      arena.deallocate(left.deallocatePtr);
+      arena.deallocate(right.deallocatePtr);
 
-      delete arena;
+      expect(!arena.allocate(wholeArena).success, "The whole arena can't be allocated while a block is in use");
+
+      arena.deallocate(middle.deallocatePtr);
+
+      auto result5 = arena.allocate(wholeArena);
+      expect(result5.success, "A freed block merges with free blocks on both sides");
+      expect(result.memoryStart == result5.memoryStart, "The merged block starts at the start of the arena");
+    }
+
+    {
+      beginTest("Allocators that can't grow fail instead of allocating a new arena");
+
+      ArenaBufferAllocator<int> arena(4096, false);
+
+      int successes = 0;
+
+      while (arena.allocate(16).success) {
+        successes++;
+      }
+
+      expect(successes > 0, "Some allocations succeeded");
+      expectEquals(static_cast<int>(arena.getArenaCount()), 1);
+      expectEquals(static_cast<int>(arena.getStats().failedAllocations), 1);
+    }
+
+    {
+      beginTest("An arena sized with getFootprint() fits exactly those allocations");
+
+      constexpr size_t count = 8;
+      constexpr size_t items = 37;
+
+      ArenaBufferAllocator<int> arena(
+        ArenaBufferAllocator<int>::arenaOverhead + count * ArenaBufferAllocator<int>::getFootprint(items),
+        false
+      );
+
+      for (size_t i = 0; i < count; i++) {
+        expect(arena.allocate(items).success, "Allocation fits");
+      }
+
+      expect(!arena.allocate(1).success, "Arena is full");
+
+      auto stats = arena.getStats();
+      expectEquals(static_cast<int>(stats.allocations), static_cast<int>(count));
+      expectEquals(static_cast<int>(stats.failedAllocations), 1);
+    }
+
+    {
+      beginTest("Random allocation patterns don't corrupt memory, and everything coalesces when freed");
+
+      ArenaBufferAllocator<int> arena(1024 * 1024, false);
+      std::mt19937 random(1234);
+
+      struct Allocation {
+        ArenaBufferAllocateResult<int> result;
+        size_t numItems;
+        int tag;
+      };
+
+      std::vector<Allocation> allocations;
+      bool memoryIsIntact = true;
+
+      auto isIntact = [](const Allocation& allocation) {
+        for (size_t i = 0; i < allocation.numItems; i++) {
+          if (allocation.result.memoryStart[i] != allocation.tag) {
+            return false;
+          }
+        }
+
+        return true;
+      };
+
+      for (int i = 0; i < 20000; i++) {
+        if (!allocations.empty() && random() % 2 == 0) {
+          auto index = random() % allocations.size();
+          memoryIsIntact = memoryIsIntact && isIntact(allocations[index]);
+          arena.deallocate(allocations[index].result.deallocatePtr);
+          allocations[index] = allocations.back();
+          allocations.pop_back();
+          continue;
+        }
+
+        // Mostly small buffers, with the occasional large one
+        size_t numItems = random() % 10 == 0 ? 1 + random() % 4096 : 1 + random() % 64;
+        auto result = arena.allocate(numItems);
+
+        if (!result.success) {
+          continue;
+        }
+
+        std::fill(result.memoryStart, result.memoryStart + numItems, i);
+        allocations.push_back({ result, numItems, i });
+      }
+
+      for (auto& allocation : allocations) {
+        memoryIsIntact = memoryIsIntact && isIntact(allocation);
+        arena.deallocate(allocation.result.deallocatePtr);
+      }
+
+      expect(memoryIsIntact, "No allocation was overwritten by another");
+
+      auto stats = arena.getStats();
+      expectEquals(static_cast<int>(stats.used), 0);
+      expect(stats.highWater > 0, "The high-water mark was recorded");
+      expect(stats.free == stats.capacity, "All blocks were merged back together");
+      expect(stats.largestFreeBlock == stats.capacity, "All blocks were merged back together");
+      expectEquals(stats.fragmentation, 0.0);
+    }
+
+    {
+      beginTest("Worst-case allocation time doesn't depend on the number of blocks");
+
+      // With a linear scan, the slowest operations get slower as more blocks
+      // are live. Here, they shouldn't. We look at the 99.9th percentile
+      // rather than the maximum, since the maximum mostly measures how often
+      // the test thread was preempted.
+      auto measureSlowOperations = [](int liveBlocks) {
+        ArenaBufferAllocator<int> arena(static_cast<size_t>(liveBlocks) * 1024 * sizeof(int), false);
+        std::mt19937 random(5678);
+
+        std::vector<void*> allocations;
+
+        for (int i = 0; i < liveBlocks; i++) {
+          allocations.push_back(arena.allocate(1 + random() % 512).deallocatePtr);
+        }
+
+        std::vector<juce::int64> times;
+
+        for (int i = 0; i < 20000; i++) {
+          auto index = random() % allocations.size();
+
+          auto start = juce::Time::getHighResolutionTicks();
+          arena.deallocate(allocations[index]);
+          auto result = arena.allocate(1 + random() % 512);
+          auto end = juce::Time::getHighResolutionTicks();
+
+          allocations[index] = result.deallocatePtr;
+          times.push_back(end - start);
+        }
+
+        std::sort(times.begin(), times.end());
+
+        return juce::Time::highResolutionTicksToSeconds(times[times.size() * 999 / 1000]);
+      };
+
+      auto fewBlocks = measureSlowOperations(16);
+      auto manyBlocks = measureSlowOperations(4096);
+
+      logMessage(
+        "99.9th percentile: " + juce::String(fewBlocks * 1e9, 0) + " ns with 16 blocks, " +
+        juce::String(manyBlocks * 1e9, 0) + " ns with 4096 blocks"
+      );
+
+      expect(manyBlocks < 20e-6, "Allocations take less than 20 us");
+      expect(manyBlocks < fewBlocks * 10 + 1e-6, "Allocation time doesn't scale with the number of blocks");
     }
   }
 };
@@ -0,0 +1,86 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <limits>
+
+#include "modules/util/denormals.h"
+
+class AnthemDenormalsTest : public juce::UnitTest {
+public:
+  AnthemDenormalsTest() : juce::UnitTest("AnthemDenormalsTest", "Anthem") {}
+
+  void runTest() override {
+    {
+      beginTest("Denormals are told apart from zero and normal values");
+
+      expect(AnthemDenormals::isDenormal(std::numeric_limits<float>::denorm_min()));
+      expect(AnthemDenormals::isDenormal(-std::numeric_limits<float>::denorm_min()));
+      expect(AnthemDenormals::isDenormal(std::numeric_limits<float>::min() / 2.0f));
+
+      expect(!AnthemDenormals::isDenormal(0.0f));
+      expect(!AnthemDenormals::isDenormal(-0.0f));
+      expect(!AnthemDenormals::isDenormal(std::numeric_limits<float>::min()));
+      expect(!AnthemDenormals::isDenormal(1.0f));
+      expect(!AnthemDenormals::isDenormal(std::numeric_limits<float>::infinity()));
+      expect(!AnthemDenormals::isDenormal(std::numeric_limits<float>::quiet_NaN()));
+    }
+
+    {
+      beginTest("Denormals are found in a buffer with denormal protection on");
+
+      juce::ScopedNoDenormals noDenormals;
+
+      juce::AudioSampleBuffer buffer(2, 64);
+      buffer.clear();
+
+      expect(!AnthemDenormals::containsDenormals(buffer, 64));
+
+      // This is stored directly, so it's still a denormal in memory even
+      // though arithmetic on this thread would treat it as zero.
+      buffer.setSample(1, 63, std::numeric_limits<float>::denorm_min());
+
+      expect(AnthemDenormals::containsDenormals(buffer, 64));
+      expect(!AnthemDenormals::containsDenormals(buffer, 63));
+      expectEquals(AnthemDenormals::countDenormals(buffer.getReadPointer(1), 64), 1);
+    }
+
+#if JUCE_USE_SSE_INTRINSICS || JUCE_ARM
+    {
+      beginTest("Decaying signals flush to zero with denormal protection on");
+
+      juce::ScopedNoDenormals noDenormals;
+
+      // Keeps the compiler from folding the decay at compile time.
+      volatile float start = 1.0e-30f;
+      float value = start;
+
+      for (int i = 0; i < 1000; i++) {
+        value *= 0.5f;
+        expect(!AnthemDenormals::isDenormal(value));
+      }
+
+      expectEquals(value, 0.0f);
+    }
+#endif
+  }
+};
+
+static AnthemDenormalsTest anthemDenormalsTest;
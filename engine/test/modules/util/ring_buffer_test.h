@@ -0,0 +1,184 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "modules/util/ring_buffer.h"
+
+class RingBufferTest : public juce::UnitTest {
+public:
+  RingBufferTest() : juce::UnitTest("RingBufferTest", "Anthem") {}
+
+  void runTest() override {
+    {
+      beginTest("SPSC: capacity is rounded up to a power of two");
+
+      SpscRingBuffer<int> buffer(100);
+      expectEquals(static_cast<int>(buffer.getCapacity()), 128);
+
+      SpscRingBuffer<int> exactBuffer(64);
+      expectEquals(static_cast<int>(exactBuffer.getCapacity()), 64);
+    }
+
+    {
+      beginTest("SPSC: items come out in order, and a full buffer rejects pushes");
+
+      SpscRingBuffer<int> buffer(4);
+
+      expect(buffer.isEmpty());
+      expect(!buffer.tryPop().has_value(), "Nothing to pop from an empty buffer");
+
+      for (int i = 0; i < 4; i++) {
+        expect(buffer.tryPush(i), "Push fits");
+      }
+
+      expect(!buffer.tryPush(4), "Push to a full buffer fails");
+      expectEquals(static_cast<int>(buffer.getNumFreeSlots()), 0);
+
+      for (int i = 0; i < 4; i++) {
+        auto item = buffer.tryPop();
+        expect(item.has_value());
+        expectEquals(item.value(), i);
+      }
+
+      expect(buffer.isEmpty());
+      expectEquals(static_cast<int>(buffer.getNumFreeSlots()), 4);
+    }
+
+    {
+      beginTest("SPSC: positions wrap around the ring");
+
+      SpscRingBuffer<int> buffer(4);
+
+      for (int i = 0; i < 1000; i++) {
+        expect(buffer.tryPush(i));
+        expect(buffer.tryPush(i + 1));
+        expectEquals(buffer.tryPop().value(), i);
+        expectEquals(buffer.tryPop().value(), i + 1);
+      }
+    }
+
+    {
+      beginTest("SPSC: bulk push and pop move as many items as fit");
+
+      SpscRingBuffer<int> buffer(8);
+
+      int items[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+
+      expectEquals(static_cast<int>(buffer.pushBulk(items, 5)), 5);
+      expectEquals(static_cast<int>(buffer.pushBulk(items + 5, 7)), 3);
+
+      int output[12] = {};
+
+      expectEquals(static_cast<int>(buffer.popBulk(output, 6)), 6);
+      expectEquals(static_cast<int>(buffer.popBulk(output + 6, 6)), 2);
+
+      for (int i = 0; i < 8; i++) {
+        expectEquals(output[i], i);
+      }
+
+      expectEquals(static_cast<int>(buffer.popBulk(output, 6)), 0);
+    }
+
+    {
+      beginTest("SPSC: popWait returns once an item arrives, or after the timeout");
+
+      SpscRingBuffer<int> buffer(4);
+
+      auto start = std::chrono::steady_clock::now();
+      expect(!buffer.popWait(std::chrono::milliseconds(20)).has_value(), "Times out when nothing is pushed");
+      expect(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20), "Waited for the timeout");
+
+      std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        [[maybe_unused]] auto added = buffer.tryPush(42);
+      });
+
+      auto item = buffer.popWait(std::chrono::seconds(10));
+      producer.join();
+
+      expect(item.has_value());
+      expectEquals(item.value(), 42);
+    }
+
+    {
+      beginTest("SPSC stress: every item arrives exactly once, in order");
+
+      constexpr uint32_t itemCount = 1000000;
+
+      SpscRingBuffer<uint32_t> buffer(64);
+
+      std::thread producer([&]() {
+        uint32_t next = 0;
+        uint32_t batch[16];
+
+        while (next < itemCount) {
+          // Mix single and bulk pushes.
+          if (next % 3 == 0) {
+            uint32_t count = std::min<uint32_t>(16, itemCount - next);
+
+            for (uint32_t i = 0; i < count; i++) {
+              batch[i] = next + i;
+            }
+
+            auto pushed = static_cast<uint32_t>(buffer.pushBulk(batch, count));
+
+            if (pushed == 0) {
+              std::this_thread::yield();
+            }
+
+            next += pushed;
+          } else if (buffer.tryPush(next)) {
+            next++;
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+
+      uint32_t expected = 0;
+      bool inOrder = true;
+
+      while (expected < itemCount) {
+        auto item = buffer.tryPop();
+
+        if (!item.has_value()) {
+          std::this_thread::yield();
+          continue;
+        }
+
+        inOrder = inOrder && item.value() == expected;
+        expected++;
+      }
+
+      producer.join();
+
+      expect(inOrder, "Items arrived in order");
+      expect(buffer.isEmpty(), "Nothing is left over");
+    }
+  }
+};
+
+static RingBufferTest ringBufferTest;
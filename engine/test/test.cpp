@@ -21,10 +21,19 @@
 
 #include "console_logger.h"
 
+#include "modules/core/anthem_fixed_block_adapter_test.h"
+#include "modules/processing_graph/processor/anthem_control_buffer_test.h"
+#include "modules/processing_graph/processor/anthem_event_buffer_test.h"
+#include "modules/processing_graph/runtime/anthem_graph_parallel_executor_test.h"
+#include "modules/processors/oscillator_test.h"
+#include "modules/processors/voice_allocator_test.h"
 #include "modules/sequencer/compiler/sequence_compiler_test.h"
 #include "modules/sequencer/events/event_test.h"
+#include "modules/sequencer/runtime/automation_evaluator_test.h"
 #include "modules/sequencer/runtime/runtime_sequence_store_test.h"
 #include "modules/util/arena_allocator_test.h"
+#include "modules/util/denormals_test.h"
+#include "modules/util/ring_buffer_test.h"
 
 int main(int argc, char** argv) {
   juce::Logger::setCurrentLogger(new ConsoleLogger());
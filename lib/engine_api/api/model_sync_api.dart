@@ -76,4 +76,24 @@ class ModelSyncApi {
 
     return (response as GetSerializedModelFromEngineResponse).serializedModel;
   }
+
+  /// Gets the parts of the engine model that changed after the given version.
+  ///
+  /// The response contains a new version that can be passed back in here to
+  /// get the next set of changes. If the engine can't diff from the given
+  /// version, the response will contain the full model instead; see
+  /// [GetSerializedModelFromEngineResponse.isIncremental].
+  Future<GetSerializedModelFromEngineResponse> debugGetEngineModelChanges(
+      int sinceVersion) async {
+    final id = _engine._getRequestId();
+
+    final request = GetSerializedModelFromEngineRequest(
+      id: id,
+      sinceVersion: sinceVersion,
+    );
+
+    final response = await _engine._request(request);
+
+    return response as GetSerializedModelFromEngineResponse;
+  }
 }
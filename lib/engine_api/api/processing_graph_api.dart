@@ -33,6 +33,11 @@ class ProcessingGraphApi {
   /// removing nodes or modifying connections, are done first by modifying the
   /// model. When ready, this method can be called to compile an updated set of
   /// processing instructions and push them to the audio thread.
+  ///
+  /// The engine compiles in the background, and the returned future completes
+  /// once the new instructions have been handed to the audio thread. If this
+  /// is called again before an earlier compile finishes, the earlier compile
+  /// is abandoned, and both futures complete when the newer one is done.
   Future<void> compile() async {
     final id = _engine._getRequestId();
 
@@ -49,4 +54,18 @@ class ProcessingGraphApi {
       throw Exception('compile(): engine returned an error: ${response.error}');
     }
   }
+
+  /// Gets statistics about the memory used by event buffers in the processing
+  /// graph.
+  ///
+  /// This can be used to check whether the engine is reserving enough space
+  /// for events. If eventBufferOverflows is ever above 0, events were dropped.
+  Future<GetProcessingGraphStatsResponse> getStats() async {
+    final id = _engine._getRequestId();
+
+    final request = GetProcessingGraphStatsRequest(id: id);
+
+    return (await _engine._request(request))
+        as GetProcessingGraphStatsResponse;
+  }
 }
@@ -0,0 +1,105 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+part of 'package:anthem/engine_api/engine.dart';
+
+/// This class is an API for rendering audio from the Anthem Engine to a file.
+class RenderApi {
+  final Engine _engine;
+
+  RenderApi(this._engine);
+
+  /// Renders the master output to the file at [outputPath].
+  ///
+  /// If [sampleRate] is null, the render uses the sample rate of the audio
+  /// device.
+  ///
+  /// The engine renders as fast as it can, rather than in real time, and live
+  /// playback is paused until the render is finished. Returns the real-time
+  /// factor of the render, i.e. how many seconds of audio were rendered per
+  /// second of wall-clock time.
+  Future<double> render({
+    required String outputPath,
+    required int lengthInSamples,
+    RenderFileFormat format = RenderFileFormat.wav,
+    int blockSize = 512,
+    int? sampleRate,
+    int bitDepth = 24,
+  }) async {
+    final id = _engine._getRequestId();
+
+    final request = RenderRequest(
+      id: id,
+      outputPath: outputPath,
+      format: format,
+      lengthInSamples: lengthInSamples,
+      blockSize: blockSize,
+      sampleRate: sampleRate,
+      bitDepth: bitDepth,
+    );
+
+    final response = (await _engine._request(request)) as RenderResponse;
+
+    if (response.success) {
+      return response.realTimeFactor!;
+    } else {
+      throw Exception('render(): engine returned an error: ${response.error}');
+    }
+  }
+
+  /// Renders each of the given [taps] to its own file in a single pass, e.g.
+  /// the bus for each track in a stem export.
+  ///
+  /// If [masterOutputPath] is given, the master output is written there as
+  /// well. Nodes that don't depend on each other are processed on up to
+  /// [processingThreads] threads. Returns the real-time factor of the render.
+  Future<double> renderStems({
+    required List<RenderTap> taps,
+    required int lengthInSamples,
+    String? masterOutputPath,
+    RenderFileFormat format = RenderFileFormat.wav,
+    int blockSize = 512,
+    int? sampleRate,
+    int bitDepth = 24,
+    int processingThreads = 1,
+  }) async {
+    final id = _engine._getRequestId();
+
+    final request = RenderRequest(
+      id: id,
+      outputPath: masterOutputPath,
+      taps: taps,
+      format: format,
+      lengthInSamples: lengthInSamples,
+      blockSize: blockSize,
+      sampleRate: sampleRate,
+      bitDepth: bitDepth,
+      processingThreads: processingThreads,
+    );
+
+    final response = (await _engine._request(request)) as RenderResponse;
+
+    if (response.success) {
+      return response.realTimeFactor!;
+    } else {
+      throw Exception(
+          'renderStems(): engine returned an error: ${response.error}');
+    }
+  }
+}
@@ -31,6 +31,7 @@ export 'package:anthem/engine_api/messages/messages.dart'
 
 part 'api/model_sync_api.dart';
 part 'api/processing_graph_api.dart';
+part 'api/render_api.dart';
 part 'api/sequencer_api.dart';
 
 enum EngineState {
@@ -56,6 +57,7 @@ class Engine {
 
   late ModelSyncApi modelSyncApi;
   late ProcessingGraphApi processingGraphApi;
+  late RenderApi renderApi;
 
   Map<int, void Function(Response response)> replyFunctions = {};
 
@@ -80,6 +82,7 @@ class Engine {
 
     modelSyncApi = ModelSyncApi(this);
     processingGraphApi = ProcessingGraphApi(this);
+    renderApi = RenderApi(this);
   }
 
   void _onReply(Response response) {
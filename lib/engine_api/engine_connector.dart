@@ -105,6 +105,15 @@ class EngineConnector {
 
   final bool noHeartbeat;
 
+  /// If true, the engine is started with a virtual audio device instead of a
+  /// real one. This is useful for tests and rendering on machines without
+  /// audio hardware.
+  final bool headless;
+
+  /// If set, the engine processes the graph in fixed blocks of this many
+  /// samples, regardless of the block size of the audio device.
+  final int? internalBlockSize;
+
   final String? enginePathOverride;
 
   EngineConnector(this._id,
@@ -112,6 +121,8 @@ class EngineConnector {
       void Function(Response)? onReply,
       void Function()? onExit,
       this.noHeartbeat = false,
+      this.headless = false,
+      this.internalBlockSize,
       this.enginePathOverride})
       : _onExit = onExit,
         _onReply = onReply {
@@ -180,6 +191,14 @@ class EngineConnector {
       return false;
     }
 
+    final engineArgs = [
+      EngineSocketServer.instance.port.toString(),
+      _id.toString(),
+      if (headless) '--headless',
+      if (internalBlockSize != null)
+        '--internal-block-size=$internalBlockSize',
+    ];
+
     // If we're in debug mode, start with a command line window so we can see logging
     if (kDebugMode) {
       if (Platform.isWindows) {
@@ -188,7 +207,7 @@ class EngineConnector {
             'powershell',
             [
               '-Command',
-              '& {Start-Process -FilePath "$anthemPathStr" -ArgumentList "${EngineSocketServer.instance.port} $_id" -Wait}'
+              '& {Start-Process -FilePath "$anthemPathStr" -ArgumentList "${engineArgs.join(' ')}" -Wait}'
             ],
           ),
         );
@@ -196,7 +215,7 @@ class EngineConnector {
         _setEngineProcess(
           await Process.start(
             anthemPathStr,
-            [EngineSocketServer.instance.port.toString(), _id.toString()],
+            engineArgs,
             // There's no singular way to start in a shell window on Linux, so
             // this mirrors the engine output to our standard out.
             mode: ProcessStartMode.inheritStdio,
@@ -207,7 +226,7 @@ class EngineConnector {
       _setEngineProcess(
         await Process.start(
           anthemPathStr,
-          [EngineSocketServer.instance.port.toString(), _id.toString()],
+          engineArgs,
         ),
       );
     }
@@ -93,20 +93,54 @@ class ModelInitRequest extends Request {
 /// as updates always go one way. However, it is used by the integration tests
 /// to validate that the engine has received the correct updates.
 class GetSerializedModelFromEngineRequest extends Request {
+  /// If provided, the engine will try to reply with only the parts of the
+  /// model that changed after this version, instead of the entire model. The
+  /// version comes from a previous [GetSerializedModelFromEngineResponse].
+  ///
+  /// If the engine can't produce a diff from this version (for example, if the
+  /// model was replaced since then), it will reply with the full model.
+  int? sinceVersion;
+
   GetSerializedModelFromEngineRequest.uninitialized();
 
-  GetSerializedModelFromEngineRequest({required int id}) {
+  GetSerializedModelFromEngineRequest({required int id, this.sinceVersion}) {
     super.id = id;
   }
 }
 
 class GetSerializedModelFromEngineResponse extends Response {
+  /// The version of the engine model that this response reflects. This can be
+  /// passed as [GetSerializedModelFromEngineRequest.sinceVersion] to get
+  /// only the changes after this point.
+  int version = 0;
+
+  /// If true, this response contains only the changed parts of the model, in
+  /// [changedSubtrees] and [removedSubtrees], and [serializedModel] is empty.
+  ///
+  /// If false, [serializedModel] contains the entire model.
+  bool isIncremental = false;
+
   String serializedModel = '';
 
+  /// Map of subtree path to the serialized value of that subtree.
+  ///
+  /// Paths are made of field names and map keys, separated by slashes - for
+  /// example, `sequence` or `sequence/patterns/<pattern ID>`.
+  Map<String, String> changedSubtrees = {};
+
+  /// Paths to map entries that were removed.
+  List<String> removedSubtrees = [];
+
   GetSerializedModelFromEngineResponse.uninitialized();
 
-  GetSerializedModelFromEngineResponse(
-      {required int id, required this.serializedModel}) {
+  GetSerializedModelFromEngineResponse({
+    required int id,
+    required this.version,
+    required this.isIncremental,
+    required this.serializedModel,
+    required this.changedSubtrees,
+    required this.removedSubtrees,
+  }) {
     super.id = id;
   }
 }
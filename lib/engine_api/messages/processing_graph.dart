@@ -43,3 +43,61 @@ class CompileProcessingGraphResponse extends Response {
     super.id = id;
   }
 }
+
+class GetProcessingGraphStatsRequest extends Request {
+  GetProcessingGraphStatsRequest.uninitialized();
+
+  GetProcessingGraphStatsRequest({required int id}) {
+    super.id = id;
+  }
+}
+
+/// Statistics about the memory that event buffers in the processing graph are
+/// allocated from. Sizes are in bytes.
+class GetProcessingGraphStatsResponse extends Response {
+  /// The size of the event allocator for the current graph.
+  late int eventAllocatorCapacity;
+
+  /// How much of the event allocator is in use right now.
+  late int eventAllocatorUsed;
+
+  /// The most that has been in use at once in the current graph.
+  late int eventAllocatorHighWater;
+
+  /// How scattered the free space in the event allocator is, from 0 to 1.
+  late double eventAllocatorFragmentation;
+
+  /// How many times an event buffer grew in the current graph.
+  late int eventBufferReallocations;
+
+  /// How many times an event buffer couldn't grow in the current graph,
+  /// because the event allocator was full. Each of these drops an event.
+  late int eventBufferOverflows;
+
+  /// Reallocations across every graph so far.
+  late int totalEventBufferReallocations;
+
+  /// Overflows across every graph so far.
+  late int totalEventBufferOverflows;
+
+  /// The most that event buffers have grown by in any graph so far. New graphs
+  /// reserve space for this.
+  late int eventAllocatorGrowthHighWater;
+
+  GetProcessingGraphStatsResponse.uninitialized();
+
+  GetProcessingGraphStatsResponse({
+    required int id,
+    required this.eventAllocatorCapacity,
+    required this.eventAllocatorUsed,
+    required this.eventAllocatorHighWater,
+    required this.eventAllocatorFragmentation,
+    required this.eventBufferReallocations,
+    required this.eventBufferOverflows,
+    required this.totalEventBufferReallocations,
+    required this.totalEventBufferOverflows,
+    required this.eventAllocatorGrowthHighWater,
+  }) {
+    super.id = id;
+  }
+}
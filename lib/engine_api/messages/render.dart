@@ -0,0 +1,130 @@
+/*
+  Copyright (C) 2025 Joshua Wade
+
+  This file is part of Anthem.
+
+  Anthem is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Anthem is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Anthem. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// ignore_for_file: non_constant_identifier_names
+
+part of 'messages.dart';
+
+@AnthemEnum()
+enum RenderFileFormat { wav, flac }
+
+/// An audio output port to write to its own file during a render, such as the
+/// output of a track's bus for a stem export.
+@AnthemModel(serializable: true, generateCpp: true)
+class RenderTap extends _RenderTap with _$RenderTapAnthemModelMixin {
+  RenderTap.uninitialized() : super(nodeId: '', portId: 0, outputPath: '');
+
+  RenderTap({
+    required super.nodeId,
+    required super.portId,
+    required super.outputPath,
+  });
+
+  factory RenderTap.fromJson(Map<String, dynamic> json) =>
+      _$RenderTapAnthemModelMixin.fromJson(json);
+}
+
+abstract class _RenderTap {
+  /// The node to capture.
+  String nodeId;
+
+  /// The ID of the audio output port on the node.
+  int portId;
+
+  /// The absolute path of the file to write. If the file exists, it will be
+  /// overwritten.
+  String outputPath;
+
+  _RenderTap({
+    required this.nodeId,
+    required this.portId,
+    required this.outputPath,
+  });
+}
+
+/// Renders the master output of the processing graph to a file, along with
+/// any number of other output ports.
+///
+/// The engine renders as fast as it can process the graph, rather than in real
+/// time. Live playback is paused until the render is finished.
+class RenderRequest extends Request {
+  /// The absolute path of the file to write the master output to. If the file
+  /// exists, it will be overwritten.
+  ///
+  /// If this is null, the master output is not written.
+  String? outputPath;
+
+  /// Other output ports to write in the same pass. These use the same format
+  /// and bit depth as the master output.
+  List<RenderTap> taps = [];
+
+  late RenderFileFormat format;
+
+  /// The length of the render, in samples.
+  late int lengthInSamples;
+
+  /// The number of samples to process at a time.
+  late int blockSize;
+
+  /// The sample rate to render at. If this is null, the render uses the
+  /// sample rate of the audio device.
+  int? sampleRate;
+
+  /// The bit depth of the output file.
+  late int bitDepth;
+
+  /// The number of threads to process the graph with. Nodes that don't depend
+  /// on each other are processed on separate threads.
+  late int processingThreads;
+
+  RenderRequest.uninitialized();
+
+  RenderRequest({
+    required int id,
+    this.outputPath,
+    this.taps = const [],
+    required this.format,
+    required this.lengthInSamples,
+    required this.blockSize,
+    this.sampleRate,
+    required this.bitDepth,
+    this.processingThreads = 1,
+  }) {
+    super.id = id;
+  }
+}
+
+class RenderResponse extends Response {
+  late bool success;
+  String? error;
+
+  /// How many seconds of audio were rendered per second of wall-clock time.
+  double? realTimeFactor;
+
+  RenderResponse.uninitialized();
+
+  RenderResponse({
+    required int id,
+    required this.success,
+    this.error,
+    this.realTimeFactor,
+  }) {
+    super.id = id;
+  }
+}
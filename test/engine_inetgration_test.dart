@@ -69,6 +69,7 @@ void main() {
         enginePathOverride: enginePath.toFilePath(windows: Platform.isWindows),
         kDebugMode: true,
         noHeartbeat: true,
+        headless: true,
         onExit: () => exitStreamController.add(null),
       );
 